@@ -21,41 +21,235 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Command/Logger.h"
 
+#include <fcntl.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <iterator>
+#include <set>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace FOEDAG;
 
+static const int CrashSignals[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+using SignalHandler = void (*)(int);
+static SignalHandler PreviousHandlers[std::size(CrashSignals)];
+
+// Lock free copy of the registry for the crash handler
+static constexpr size_t MaxCrashLoggers{64};
+static std::atomic<Logger*> CrashLoggers[MaxCrashLoggers];
+
+// Holds a spin lock that the crash handler tests without waiting
+class BufferLock {
+ public:
+  explicit BufferLock(std::atomic_flag& busy) : m_busy(busy) {
+    while (m_busy.test_and_set(std::memory_order_acquire))
+      std::this_thread::yield();
+  }
+  ~BufferLock() { m_busy.clear(std::memory_order_release); }
+
+ private:
+  std::atomic_flag& m_busy;
+};
+
+// Async-signal-safe
+static void writeOnCrash(int fd, const std::string& text) {
+  const char* data = text.data();
+  size_t size = text.size();
+  while (size > 0) {
+#ifdef _WIN32
+    const int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+    const ssize_t written = ::write(fd, data, size);
+#endif
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) return;
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+// Never destroyed, loggers may outlive the static objects at exit
+static std::mutex& registryMutex() {
+  static std::mutex* mutex = new std::mutex;
+  return *mutex;
+}
+
+static std::set<Logger*>& registry() {
+  static std::set<Logger*>* loggers = new std::set<Logger*>;
+  return *loggers;
+}
+
 Logger::Logger(const std::string& filePath) {
+  static std::once_flag installHandlers;
+  std::call_once(installHandlers, []() {
+    std::atexit(&Logger::flushAll);
+    for (size_t i = 0; i < std::size(CrashSignals); i++) {
+      PreviousHandlers[i] = std::signal(CrashSignals[i], &Logger::crashHandler);
+    }
+  });
   m_fileName = filePath;
   m_stream = new std::ofstream(filePath, std::fstream::out);
+  openCrashFile();
+  registerLogger(this, true);
 }
 
 void Logger::open() {
+  std::lock_guard<std::mutex> streamLock{m_streamMutex};
+  std::lock_guard<std::mutex> lock{m_mutex};
   if (m_stream == nullptr) {
     m_stream = new std::ofstream(m_fileName, std::fstream::app);
+    openCrashFile();
   }
 }
 
 void Logger::close() {
+  stopWriter();
+  flush();
+  std::lock_guard<std::mutex> streamLock{m_streamMutex};
+  std::lock_guard<std::mutex> lock{m_mutex};
   if (m_stream) {
     delete m_stream;
     m_stream = nullptr;
+    closeCrashFile();
   }
 }
 
-void Logger::log(const std::string& text) {
-  if (m_stream) {
-    *m_stream << text << std::endl << std::flush;
+void Logger::log(const std::string& text) { appendLog(text + "\n"); }
+
+void Logger::appendLog(const std::string& text) {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (!m_stream) return;
+    BufferLock bufferLock{m_bufferBusy};
+    m_pending += text;
+    if (!m_writer.joinable()) {
+      m_stop = false;
+      m_writer = std::thread{&Logger::writePending, this};
+    }
   }
+  m_wakeup.notify_one();
 }
 
-void Logger::appendLog(const std::string& text) {
-  if (m_stream) {
-    *m_stream << text << std::flush;
+void Logger::flush() {
+  std::lock_guard<std::mutex> streamLock{m_streamMutex};
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    BufferLock bufferLock{m_bufferBusy};
+    m_writing.swap(m_pending);
+  }
+  if (m_stream && !m_writing.empty()) {
+    m_stream->write(m_writing.data(), m_writing.size());
+    m_stream->flush();
+  }
+  BufferLock bufferLock{m_bufferBusy};
+  m_writing.clear();
+}
+
+void Logger::writePending() {
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true) {
+    m_wakeup.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+    if (m_stop) break;
+    lock.unlock();
+    flush();
+    lock.lock();
+  }
+}
+
+void Logger::stopWriter() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (!m_writer.joinable()) return;
+    m_stop = true;
   }
+  m_wakeup.notify_one();
+  m_writer.join();
 }
 
 std::string Logger::fileName() const { return m_fileName; }
 
-Logger::~Logger() { close(); }
+void Logger::flushAll() {
+  std::lock_guard<std::mutex> lock{registryMutex()};
+  for (auto logger : registry()) logger->flush();
+}
+
+void Logger::flushOnCrash() {
+  // Best effort: skip the logger if a thread was changing its buffers. The
+  // text being written by the background thread may be written twice.
+  if (m_bufferBusy.test_and_set(std::memory_order_acquire)) return;
+  if (m_crashFd >= 0) {
+    writeOnCrash(m_crashFd, m_writing);
+    writeOnCrash(m_crashFd, m_pending);
+    m_writing.clear();
+    m_pending.clear();
+  }
+  m_bufferBusy.clear(std::memory_order_release);
+}
+
+void Logger::openCrashFile() {
+  BufferLock bufferLock{m_bufferBusy};
+#ifdef _WIN32
+  m_crashFd = _open(m_fileName.c_str(), _O_WRONLY | _O_APPEND | _O_NOINHERIT);
+#else
+  m_crashFd = ::open(m_fileName.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+#endif
+}
+
+void Logger::closeCrashFile() {
+  BufferLock bufferLock{m_bufferBusy};
+  if (m_crashFd < 0) return;
+#ifdef _WIN32
+  _close(m_crashFd);
+#else
+  ::close(m_crashFd);
+#endif
+  m_crashFd = -1;
+}
+
+void Logger::crashHandler(int signal) {
+  // Only async-signal-safe calls: lock free atomics and ::write
+  for (auto& slot : CrashLoggers) {
+    Logger* logger = slot.load();
+    if (logger) logger->flushOnCrash();
+  }
+  // Let the previous handler or the default action terminate the process
+  for (size_t i = 0; i < std::size(CrashSignals); i++) {
+    if (CrashSignals[i] != signal) continue;
+    SignalHandler previous = PreviousHandlers[i];
+    if (previous == SIG_ERR || previous == SIG_IGN) previous = SIG_DFL;
+    std::signal(signal, previous);
+    break;
+  }
+  std::raise(signal);
+}
+
+void Logger::registerLogger(Logger* logger, bool add) {
+  std::lock_guard<std::mutex> lock{registryMutex()};
+  if (add)
+    registry().insert(logger);
+  else
+    registry().erase(logger);
+  // Past MaxCrashLoggers a logger is not flushed on crash
+  Logger* from = add ? nullptr : logger;
+  for (auto& slot : CrashLoggers) {
+    if (slot.load() == from) {
+      slot.store(add ? logger : nullptr);
+      break;
+    }
+  }
+}
+
+Logger::~Logger() {
+  registerLogger(this, false);
+  close();
+}
 
 Logger& Logger::operator<<(const std::string& log) {
   appendLog(log);
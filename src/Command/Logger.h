@@ -21,13 +21,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace FOEDAG {
 
+/*!
+ * \brief The Logger class. The text is queued and written to the file by a
+ * background thread, everything queued while a write is in progress goes to
+ * the next one. The pending text is flushed on close, at exit and on crash.
+ */
 class Logger {
  private:
  public:
@@ -36,14 +45,46 @@ class Logger {
   void close();
   void log(const std::string& text);
   void appendLog(const std::string& text);
+  /*!
+   * \brief flush. Write the pending text to the file now
+   */
+  void flush();
   std::string fileName() const;
 
+  /*!
+   * \brief flushAll. Flush every open logger
+   */
+  static void flushAll();
+
   ~Logger();
   Logger& operator<<(const std::string& log);
 
+ private:
+  void writePending();
+  void stopWriter();
+  void flushOnCrash();
+  void openCrashFile();
+  void closeCrashFile();
+  static void crashHandler(int signal);
+  static void registerLogger(Logger* logger, bool add);
+
  private:
   std::ofstream* m_stream = nullptr;
   std::string m_fileName;
+  // guards m_stream and m_writing, locked before m_mutex
+  std::mutex m_streamMutex;
+  // guards m_pending, m_stop and m_writer
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  // Spin lock around changes of m_pending, m_writing and m_crashFd, the
+  // crash handler only tests it. Locked after m_mutex
+  std::atomic_flag m_bufferBusy = ATOMIC_FLAG_INIT;
+  std::string m_pending;
+  std::string m_writing;
+  // Written with ::write on crash, the streams are not async-signal-safe
+  int m_crashFd = -1;
+  bool m_stop = false;
+  std::thread m_writer;
 };
 
 }  // namespace FOEDAG
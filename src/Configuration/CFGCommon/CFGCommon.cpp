@@ -23,10 +23,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef _WIN32
 #include <Windows.h>
 #else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #endif
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdarg>
 #include <cstdlib>
 #include <cstring>
@@ -509,89 +514,253 @@ int CFG_compiler_execute_cmd(const std::string& command,
   }
 }
 
-int CFG_execute_cmd(const std::string& cmd, std::string& output,
-                    std::ostream* outStream, std::atomic<bool>& stopCommand) {
-#ifdef _WIN32
-#define POPEN _popen
-#define PCLOSE _pclose
-#define WEXITSTATUS
-#else
-#define POPEN popen
-#define PCLOSE pclose
-#endif
-
-  FILE* pipe = POPEN(cmd.c_str(), "r");
-  if (pipe == nullptr) {
-    return -1;
+// Keeps the last bytes appended to it in a fixed size buffer
+class CFG_RingBuffer {
+ public:
+  explicit CFG_RingBuffer(size_t capacity) : m_data(capacity) {}
+  void append(const std::string& data) {
+    size_t capacity = m_data.size();
+    if (capacity == 0) {
+      return;
+    }
+    const char* src = data.c_str();
+    size_t size = data.size();
+    if (size > capacity) {
+      src += size - capacity;
+      size = capacity;
+    }
+    size_t first = std::min(size, capacity - m_head);
+    memcpy(&m_data[m_head], src, first);
+    memcpy(&m_data[0], src + first, size - first);
+    m_head = (m_head + size) % capacity;
+    m_size = std::min(m_size + size, capacity);
+  }
+  std::string str() const {
+    if (m_data.empty()) {
+      return "";
+    }
+    size_t start = (m_head + m_data.size() - m_size) % m_data.size();
+    size_t first = std::min(m_size, m_data.size() - start);
+    std::string result(&m_data[start], first);
+    result.append(&m_data[0], m_size - first);
+    return result;
   }
 
-  // Read the output of the command and store it in the output string.
-  char buffer[1024];
-  std::string newline;
-  while (fgets(buffer, sizeof(buffer), pipe) != nullptr && !stopCommand) {
-    output += buffer;
-    newline = buffer;
+ private:
+  std::vector<char> m_data;
+  size_t m_head = 0;
+  size_t m_size = 0;
+};
 
-    if (outStream) {
-      *outStream << newline;
+// Cuts a stream into lines, the newline is kept like fgets() does
+class CFG_LineSplitter {
+ public:
+  template <typename Callback>
+  void feed(const char* data, size_t size, Callback&& callback) {
+    while (size) {
+      const char* newline = (const char*)memchr(data, '\n', size);
+      size_t length = newline ? size_t(newline - data) + 1 : size;
+      m_line.append(data, length);
+      if (newline || m_line.size() >= CFG_PRINT_MAXIMUM_SIZE) {
+        callback(m_line);
+        m_line.clear();
+      }
+      data += length;
+      size -= length;
     }
-
-    if (stopCommand) {
-      break;
+  }
+  template <typename Callback>
+  void finish(Callback&& callback) {
+    if (!m_line.empty()) {
+      callback(m_line);
+      m_line.clear();
     }
   }
 
-  int status = PCLOSE(pipe);
-  int exit_code = WEXITSTATUS(status);
-  return exit_code;
-}
+ private:
+  std::string m_line;
+};
 
-int CFG_execute_cmd_with_callback(
-    const std::string& cmd, std::string& output, std::ostream* outStream,
-    std::regex patternToMatch, std::atomic<bool>& stopCommand,
-    std::function<void(const std::string&)> progressCallback,
-    std::function<void(const std::string&)> generalCallback) {
-#ifdef _WIN32
-#define POPEN _popen
-#define PCLOSE _pclose
-#define WEXITSTATUS
+#ifndef _WIN32
+// Pipe whose ends are closed on exec, so a command started by another thread
+// does not inherit them and hold the output of this one open
+static int CFG_cloexec_pipe(int fds[2]) {
+#ifdef __APPLE__
+  // No pipe2(), a fork between the two calls can still inherit the ends
+  if (pipe(fds) != 0) {
+    return -1;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  return 0;
 #else
-#define POPEN popen
-#define PCLOSE pclose
+  return pipe2(fds, O_CLOEXEC);
+#endif
+}
 #endif
 
-  FILE* pipe = POPEN(cmd.c_str(), "r");
+// Run cmd through the shell and pass every line of its stdout (isError false)
+// and stderr (isError true) to callback, as soon as it is complete
+static int CFG_run_cmd(
+    const std::string& cmd, std::atomic<bool>& stopCommand,
+    const std::function<void(const std::string&, bool)>& callback) {
+  CFG_LineSplitter splitters[2];
+#ifdef _WIN32
+  // No poll() on pipes, stderr stays on the console and stopCommand is only
+  // checked between lines
+  FILE* pipe = _popen(cmd.c_str(), "r");
   if (pipe == nullptr) {
     return -1;
   }
-
-  // Read the output of the command and store it in the output string.
   char buffer[1024];
-  std::string newline;
-  while (fgets(buffer, sizeof(buffer), pipe) != nullptr && !stopCommand) {
-    output += buffer;
-    newline = buffer;
-    if (generalCallback != nullptr) {
-      generalCallback(newline);
+  while (!stopCommand && fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+    splitters[0].feed(buffer, strlen(buffer),
+                      [&](const std::string& line) { callback(line, false); });
+  }
+  splitters[0].finish([&](const std::string& line) { callback(line, false); });
+  int exit_code = _pclose(pipe);
+  return stopCommand ? -1 : exit_code;
+#else
+  int out[2];
+  int err[2];
+  if (CFG_cloexec_pipe(out) != 0) {
+    return -1;
+  }
+  if (CFG_cloexec_pipe(err) != 0) {
+    close(out[0]);
+    close(out[1]);
+    return -1;
+  }
+  const char* command = cmd.c_str();
+  pid_t pid = fork();
+  if (pid == 0) {
+    // Only async-signal-safe calls until exec. The command gets its own
+    // process group so a stop also reaches the processes it starts. dup2()
+    // clears close-on-exec on stdout and stderr
+    setpgid(0, 0);
+    dup2(out[1], STDOUT_FILENO);
+    dup2(err[1], STDERR_FILENO);
+    close(out[0]);
+    close(out[1]);
+    close(err[0]);
+    close(err[1]);
+    execl("/bin/sh", "sh", "-c", command, (char*)nullptr);
+    _exit(127);
+  }
+  close(out[1]);
+  close(err[1]);
+  if (pid < 0) {
+    close(out[0]);
+    close(err[0]);
+    return -1;
+  }
+  // Also set from the parent, the group must exist before it is signaled
+  setpgid(pid, pid);
+
+  struct pollfd fds[2] = {{out[0], POLLIN, 0}, {err[0], POLLIN, 0}};
+  int opened = 2;
+  char buffer[4096];
+  // A quiet command still gets stopped within the poll timeout
+  while (opened > 0 && !stopCommand) {
+    int rc = poll(fds, 2, 100);
+    if (rc < 0 && errno != EINTR) {
+      break;
     }
-
-    if (outStream) {
-      *outStream << newline;
+    for (int i = 0; i < 2 && rc > 0 && !stopCommand; i++) {
+      if (fds[i].fd < 0 || fds[i].revents == 0) {
+        continue;
+      }
+      ssize_t size = read(fds[i].fd, buffer, sizeof(buffer));
+      if (size > 0) {
+        bool isError = i == 1;
+        splitters[i].feed(buffer, size_t(size), [&](const std::string& line) {
+          callback(line, isError);
+        });
+      } else if (size == 0 || errno != EINTR) {
+        close(fds[i].fd);
+        fds[i].fd = -1;
+        opened--;
+      }
     }
-
-    if (stopCommand) {
-      break;
+  }
+  bool interrupted = opened > 0;
+  if (interrupted) {
+    kill(-pid, SIGTERM);
+  } else {
+    splitters[0].finish(
+        [&](const std::string& line) { callback(line, false); });
+    splitters[1].finish([&](const std::string& line) { callback(line, true); });
+  }
+  for (auto& fd : fds) {
+    if (fd.fd >= 0) {
+      close(fd.fd);
     }
-
-    std::smatch matches;
-    if (progressCallback &&
-        std::regex_search(newline, matches, patternToMatch)) {
-      progressCallback(matches.str());
+  }
+  int status = 0;
+  pid_t reaped = 0;
+  if (interrupted) {
+    // A command ignoring SIGTERM is killed after two seconds
+    for (int i = 0; i < 200 && reaped == 0; i++) {
+      usleep(10 * 1000);
+      reaped = waitpid(pid, &status, WNOHANG);
+      if (reaped < 0 && errno == EINTR) {
+        reaped = 0;
+      }
+    }
+    if (reaped == 0) {
+      kill(-pid, SIGKILL);
+    }
+  }
+  if (reaped <= 0) {
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
     }
   }
+  if (interrupted || !WIFEXITED(status)) {
+    return -1;
+  }
+  return WEXITSTATUS(status);
+#endif
+}
+
+int CFG_execute_cmd(const std::string& cmd, std::string& output,
+                    std::ostream* outStream, std::atomic<bool>& stopCommand,
+                    size_t outputLimit) {
+  return CFG_execute_cmd_with_callback(cmd, output, outStream, std::regex{},
+                                       stopCommand, nullptr, nullptr,
+                                       outputLimit);
+}
+
+int CFG_execute_cmd_with_callback(
+    const std::string& cmd, std::string& output, std::ostream* outStream,
+    const std::regex& patternToMatch, std::atomic<bool>& stopCommand,
+    std::function<void(const std::string&)> progressCallback,
+    std::function<void(const std::string&)> generalCallback,
+    size_t outputLimit) {
+  CFG_RingBuffer tail(outputLimit);
+  std::smatch matches;
+  int exit_code = CFG_run_cmd(
+      cmd, stopCommand, [&](const std::string& line, bool isError) {
+        if (isError) {
+          std::cerr << line << std::flush;
+        } else {
+          tail.append(line);
+          if (outStream) {
+            *outStream << line;
+          }
+        }
+        if (generalCallback != nullptr) {
+          generalCallback(line);
+        }
+        if (progressCallback &&
+            std::regex_search(line, matches, patternToMatch)) {
+          progressCallback(matches.str());
+        }
+      });
 
-  int status = PCLOSE(pipe);
-  int exit_code = WEXITSTATUS(status);
+  output += tail.str();
+  if (output.size() > outputLimit) {
+    output.erase(0, output.size() - outputLimit);
+  }
   return exit_code;
 }
 
@@ -622,6 +791,19 @@ void CFG_sleep_ms(uint32_t milisecond) {
 void CFG_read_text_file(const std::string& filepath,
                         std::vector<std::string>& data,
                         bool trim_trailer_whitespace) {
+  CFG_read_text_file_lines(
+      filepath,
+      [&data](const std::string& line) {
+        data.push_back(line);
+        return true;
+      },
+      trim_trailer_whitespace);
+}
+
+void CFG_read_text_file_lines(
+    const std::string& filepath,
+    const std::function<bool(const std::string&)>& callback,
+    bool trim_trailer_whitespace) {
   std::fstream file;
   file.open(filepath.c_str(), std::ios::in);
   CFG_ASSERT_MSG(file.is_open(), "Fail to open %s", filepath.c_str());
@@ -630,7 +812,28 @@ void CFG_read_text_file(const std::string& filepath,
     if (trim_trailer_whitespace) {
       CFG_get_rid_trailing_whitespace(line);
     }
-    data.push_back(line);
+    if (!callback(line)) {
+      break;
+    }
+  }
+  file.close();
+}
+
+void CFG_read_binary_file_chunks(
+    const std::string& filepath,
+    const std::function<bool(const uint8_t*, size_t)>& callback,
+    size_t chunk_size) {
+  CFG_ASSERT(chunk_size > 0);
+  std::ifstream file(filepath.c_str(), std::ios::in | std::ios::binary);
+  CFG_ASSERT_MSG(file.is_open(), "Fail to open binary file %s",
+                 filepath.c_str());
+  std::vector<uint8_t> chunk(chunk_size);
+  while (file) {
+    file.read((char*)(&chunk[0]), chunk.size());
+    size_t size = (size_t)(file.gcount());
+    if (size == 0 || !callback(&chunk[0], size)) {
+      break;
+    }
   }
   file.close();
 }
@@ -669,21 +872,31 @@ void CFG_write_binary_file(const std::string& filepath, const uint8_t* data,
 bool CFG_compare_two_text_files(const std::string& filepath1,
                                 const std::string& filepath2,
                                 bool debug_if_diff) {
-  std::vector<std::string> data1;
-  std::vector<std::string> data2;
-  CFG_read_text_file(filepath1, data1, false);
-  CFG_read_text_file(filepath2, data2, false);
-  bool status = false;
-  if (data1.size() == data2.size()) {
-    status = true;
-    for (size_t i = 0; i < data1.size(); i++) {
-      if (data1[i] != data2[i]) {
-        status = false;
-        break;
-      }
+  // Compare line by line and stop at the first difference
+  std::fstream file1(filepath1.c_str(), std::ios::in);
+  std::fstream file2(filepath2.c_str(), std::ios::in);
+  CFG_ASSERT_MSG(file1.is_open(), "Fail to open %s", filepath1.c_str());
+  CFG_ASSERT_MSG(file2.is_open(), "Fail to open %s", filepath2.c_str());
+  std::string line1 = "";
+  std::string line2 = "";
+  bool status = true;
+  while (status) {
+    bool got1 = bool(getline(file1, line1));
+    bool got2 = bool(getline(file2, line2));
+    if (!got1 || !got2) {
+      status = got1 == got2;
+      break;
     }
+    status = line1 == line2;
   }
+  file1.close();
+  file2.close();
   if (!status && debug_if_diff) {
+    // Only a failing comparison pays for loading both files
+    std::vector<std::string> data1;
+    std::vector<std::string> data2;
+    CFG_read_text_file(filepath1, data1, false);
+    CFG_read_text_file(filepath2, data2, false);
     printf("CFG Diff:\n");
     printf("  1. %s (%d)\n", filepath1.c_str(), (uint32_t)(data1.size()));
     printf("  2. %s (%d)\n", filepath2.c_str(), (uint32_t)(data2.size()));
@@ -717,12 +930,32 @@ bool CFG_compare_two_text_files(const std::string& filepath1,
 
 bool CFG_compare_two_binary_files(const std::string& filepath1,
                                   const std::string& filepath2) {
-  std::vector<uint8_t> data1;
-  std::vector<uint8_t> data2;
-  CFG_read_binary_file(filepath1, data1);
-  CFG_read_binary_file(filepath2, data2);
-  return (data1.size() == data2.size()) &&
-         (data1.size() == 0 || memcmp(&data1[0], &data2[0], data1.size()) == 0);
+  std::ifstream file1(filepath1.c_str(), std::ios::in | std::ios::binary);
+  std::ifstream file2(filepath2.c_str(), std::ios::in | std::ios::binary);
+  CFG_ASSERT_MSG(file1.is_open(), "Fail to open binary file %s",
+                 filepath1.c_str());
+  CFG_ASSERT_MSG(file2.is_open(), "Fail to open binary file %s",
+                 filepath2.c_str());
+  std::error_code ec1;
+  std::error_code ec2;
+  if (std::filesystem::file_size(filepath1, ec1) !=
+          std::filesystem::file_size(filepath2, ec2) ||
+      ec1 || ec2) {
+    return false;
+  }
+  // Compare chunk by chunk and stop at the first difference
+  std::vector<char> chunk1(CFG_FILE_CHUNK_SIZE);
+  std::vector<char> chunk2(CFG_FILE_CHUNK_SIZE);
+  while (file1 && file2) {
+    file1.read(&chunk1[0], chunk1.size());
+    file2.read(&chunk2[0], chunk2.size());
+    size_t size = (size_t)(file1.gcount());
+    if (size != (size_t)(file2.gcount()) ||
+        memcmp(&chunk1[0], &chunk2[0], size) != 0) {
+      return false;
+    }
+  }
+  return file1.eof() && file2.eof();
 }
 
 static CFG_Python_OBJ CFG_Python_get_result(PyObject*& value,
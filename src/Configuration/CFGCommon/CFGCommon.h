@@ -22,6 +22,9 @@
 
 #define CFG_PRINT_MINIMUM_SIZE (256)
 #define CFG_PRINT_MAXIMUM_SIZE (8192)
+// Only the tail of a command output is kept, see CFG_execute_cmd()
+#define CFG_EXECUTE_CMD_OUTPUT_LIMIT (1024 * 1024)
+#define CFG_FILE_CHUNK_SIZE (64 * 1024)
 typedef std::chrono::high_resolution_clock::time_point CFG_TIME;
 
 typedef void (*cfg_callback_post_msg_function)(const std::string& message,
@@ -218,14 +221,27 @@ int CFG_compiler_execute_cmd(const std::string& command,
                              const std::string logFile = std::string{},
                              bool appendLog = false);
 
+/*
+  Run cmd through the shell. Its stdout is appended to output, trimmed to the
+  last outputLimit bytes, and copied to outStream line by line. Its stderr is
+  forwarded to std::cerr. Setting stopCommand terminates the command, -1 is
+  returned then or when the command cannot be started, else its exit code.
+*/
 int CFG_execute_cmd(const std::string& cmd, std::string& output,
-                    std::ostream* outStream, std::atomic<bool>& stopCommand);
-
+                    std::ostream* outStream, std::atomic<bool>& stopCommand,
+                    size_t outputLimit = CFG_EXECUTE_CMD_OUTPUT_LIMIT);
+
+/*
+  Same as CFG_execute_cmd(), every line of stdout and stderr is also passed to
+  generalCallback and, when it matches patternToMatch, the match to
+  progressCallback.
+*/
 int CFG_execute_cmd_with_callback(
     const std::string& cmd, std::string& output, std::ostream* outstream,
-    std::regex patternToMatch, std::atomic<bool>& stopCommand,
+    const std::regex& patternToMatch, std::atomic<bool>& stopCommand,
     std::function<void(const std::string&)> progressCallback = nullptr,
-    std::function<void(const std::string&)> generalCallback = nullptr);
+    std::function<void(const std::string&)> generalCallback = nullptr,
+    size_t outputLimit = CFG_EXECUTE_CMD_OUTPUT_LIMIT);
 
 std::filesystem::path CFG_find_file(const std::filesystem::path& filePath,
                                     const std::filesystem::path& defaultDir);
@@ -239,6 +255,17 @@ void CFG_read_text_file(const std::string& filepath,
 void CFG_read_binary_file(const std::string& filepath,
                           std::vector<uint8_t>& data);
 
+// Streaming readers, the callback returns false to stop reading
+void CFG_read_text_file_lines(
+    const std::string& filepath,
+    const std::function<bool(const std::string&)>& callback,
+    bool trim_trailer_whitespace);
+
+void CFG_read_binary_file_chunks(
+    const std::string& filepath,
+    const std::function<bool(const uint8_t*, size_t)>& callback,
+    size_t chunk_size = CFG_FILE_CHUNK_SIZE);
+
 void CFG_write_binary_file(const std::string& filepath, const uint8_t* data,
                            const size_t data_size);
 
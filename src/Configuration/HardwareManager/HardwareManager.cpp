@@ -21,6 +21,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "HardwareManager.h"
 
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 #include "Configuration/CFGCommon/CFGCommon.h"
 #include "libusb.h"
 
@@ -41,88 +45,198 @@ HardwareManager::HardwareManager(JtagAdapter* adapter) : m_adapter(adapter) {
 
 HardwareManager::~HardwareManager() {}
 
-std::vector<Cable> HardwareManager::get_cables() {
-  struct libusb_context* ctx = nullptr;         /**< Libusb context **/
-  struct libusb_device** device_list = nullptr; /**< The usb device list **/
-  struct libusb_device_handle* device_handle = nullptr;
-  uint32_t cable_index = 1;
-  char desc_string[HM_USB_DESC_LENGTH]; /* Max size of string descriptor */
-  int rc;
-  int device_count;
-  std::vector<Cable> cables;
-
-  rc = libusb_init(&ctx);
-  CFG_ASSERT_MSG(rc == 0, "libusb_init() fail. Error: %s",
-                 libusb_error_name(rc));
-
-  device_count = (int)libusb_get_device_list(ctx, &device_list);
-  for (int index = 0; index < device_count; index++) {
-    struct libusb_device_descriptor device_descriptor;
+/*
+  Process wide cable list: the libusb context stays alive and the cables are
+  only enumerated again after a hotplug event of a known cable, or after
+  HM_CABLE_RESCAN_MS when the platform has no hotplug support. Enumeration
+  opens every cable to read its descriptors which is too slow to repeat on
+  each query.
+*/
+class HardwareManager_CABLE_CACHE {
+ public:
+  static HardwareManager_CABLE_CACHE& instance() {
+    static HardwareManager_CABLE_CACHE cache;
+    return cache;
+  }
 
-    if (libusb_get_device_descriptor(device_list[index], &device_descriptor) !=
-        0) {
-      continue;
+  std::vector<Cable> get_cables(
+      const std::vector<HardwareManager_CABLE_INFO>& cable_db) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ctx == nullptr) {
+      init(cable_db);
+    }
+    uint64_t generation = m_generation;
+    bool expired = !m_hotplug && std::chrono::steady_clock::now() >=
+                                     m_scan_time + std::chrono::milliseconds(
+                                                       HM_CABLE_RESCAN_MS);
+    if (!m_scanned || generation != m_scanned_generation || expired) {
+      // A hotplug event during the scan bumps the generation again
+      m_cables = scan(cable_db);
+      m_scanned = true;
+      m_scanned_generation = generation;
+      m_scan_time = std::chrono::steady_clock::now();
     }
+    return m_cables;
+  }
 
-    for (auto& cable_info : m_cable_db) {
+ private:
+  HardwareManager_CABLE_CACHE() = default;
+  ~HardwareManager_CABLE_CACHE() {
+    if (m_ctx == nullptr) {
+      return;
+    }
+    if (m_events.joinable()) {
+      m_stop = true;
+      libusb_hotplug_deregister_callback(m_ctx, m_hotplug_handle);
+      m_events.join();
+    }
+    libusb_exit(m_ctx);
+  }
+
+  void init(const std::vector<HardwareManager_CABLE_INFO>& cable_db) {
+    int rc = libusb_init(&m_ctx);
+    if (rc != 0) {
+      m_ctx = nullptr;
+      CFG_ASSERT_MSG(false, "libusb_init() fail. Error: %s",
+                     libusb_error_name(rc));
+    }
+    m_cable_db = &cable_db;
+    m_hotplug = libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG) != 0;
+    if (m_hotplug) {
+      rc = libusb_hotplug_register_callback(
+          m_ctx,
+          static_cast<libusb_hotplug_event>(
+              LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED |
+              LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+          static_cast<libusb_hotplug_flag>(0), LIBUSB_HOTPLUG_MATCH_ANY,
+          LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, hotplug, this,
+          &m_hotplug_handle);
+      m_hotplug = rc == LIBUSB_SUCCESS;
+    }
+    if (m_hotplug) {
+      // Hotplug callbacks are only called while libusb handles events
+      m_events = std::thread([this]() {
+        while (!m_stop) {
+          struct timeval timeout = {0, 100000};
+          libusb_handle_events_timeout_completed(m_ctx, &timeout, nullptr);
+        }
+      });
+    }
+  }
+
+  static int LIBUSB_CALL hotplug(libusb_context* /*ctx*/,
+                                 libusb_device* device,
+                                 libusb_hotplug_event /*event*/,
+                                 void* user_data) {
+    auto cache = static_cast<HardwareManager_CABLE_CACHE*>(user_data);
+    struct libusb_device_descriptor device_descriptor;
+    if (libusb_get_device_descriptor(device, &device_descriptor) != 0) {
+      cache->m_generation++;
+      return 0;
+    }
+    for (auto& cable_info : *cache->m_cable_db) {
       if (device_descriptor.idVendor == cable_info.vid &&
           device_descriptor.idProduct == cable_info.pid) {
-        Cable cable{};
-
-        cable.index = cable_index++;
-        cable.vendor_id = device_descriptor.idVendor;
-        cable.product_id = device_descriptor.idProduct;
-        cable.port_addr = libusb_get_port_number(device_list[index]);
-        cable.device_addr = libusb_get_device_address(device_list[index]);
-        cable.bus_addr = libusb_get_bus_number(device_list[index]);
-        cable.name = cable_info.name + "_" + std::to_string(cable.bus_addr) +
-                     "_" + std::to_string(cable.port_addr);
-        cable.cable_type = cable_info.type;
-        cable.description = "";
-        cable.serial_number =
-            "";  // Note: not all usb cable has a serial number
-        cable.speed = HM_DEFAULT_CABLE_SPEED_KHZ;
-        cable.transport = TransportType::JTAG;
-        cable.channel = 0;
-
-        rc = libusb_open(device_list[index], &device_handle);
-        if (rc < 0) {
-          // free libusb resource
-          libusb_free_device_list(device_list, 1);
-          libusb_exit(ctx);
-          CFG_ASSERT_MSG(false, "libusb_open() fail. Error: %s",
-                         libusb_error_name(rc));
-        }
+        cache->m_generation++;
+        break;
+      }
+    }
+    // keep the callback registered
+    return 0;
+  }
 
-        rc = libusb_get_string_descriptor_ascii(
-            device_handle, device_descriptor.iProduct,
-            (unsigned char*)desc_string, sizeof(desc_string));
-        if (rc == 0) {
-          cable.description = desc_string;
-        }
+  std::vector<Cable> scan(
+      const std::vector<HardwareManager_CABLE_INFO>& cable_db) {
+    struct libusb_device** device_list = nullptr; /**< The usb device list **/
+    struct libusb_device_handle* device_handle = nullptr;
+    uint32_t cable_index = 1;
+    char desc_string[HM_USB_DESC_LENGTH]; /* Max size of string descriptor */
+    int rc;
+    int device_count;
+    std::vector<Cable> cables;
+
+    device_count = (int)libusb_get_device_list(m_ctx, &device_list);
+    for (int index = 0; index < device_count; index++) {
+      struct libusb_device_descriptor device_descriptor;
+
+      if (libusb_get_device_descriptor(device_list[index],
+                                       &device_descriptor) != 0) {
+        continue;
+      }
 
-        rc = libusb_get_string_descriptor_ascii(
-            device_handle, device_descriptor.iSerialNumber,
-            (unsigned char*)desc_string, sizeof(desc_string));
-        if (rc == 0) {
-          cable.serial_number = desc_string;
+      for (auto& cable_info : cable_db) {
+        if (device_descriptor.idVendor == cable_info.vid &&
+            device_descriptor.idProduct == cable_info.pid) {
+          Cable cable{};
+
+          cable.index = cable_index++;
+          cable.vendor_id = device_descriptor.idVendor;
+          cable.product_id = device_descriptor.idProduct;
+          cable.port_addr = libusb_get_port_number(device_list[index]);
+          cable.device_addr = libusb_get_device_address(device_list[index]);
+          cable.bus_addr = libusb_get_bus_number(device_list[index]);
+          cable.name = cable_info.name + "_" +
+                       std::to_string(cable.bus_addr) + "_" +
+                       std::to_string(cable.port_addr);
+          cable.cable_type = cable_info.type;
+          cable.description = "";
+          cable.serial_number =
+              "";  // Note: not all usb cable has a serial number
+          cable.speed = HM_DEFAULT_CABLE_SPEED_KHZ;
+          cable.transport = TransportType::JTAG;
+          cable.channel = 0;
+
+          rc = libusb_open(device_list[index], &device_handle);
+          if (rc < 0) {
+            // free libusb resource
+            libusb_free_device_list(device_list, 1);
+            CFG_ASSERT_MSG(false, "libusb_open() fail. Error: %s",
+                           libusb_error_name(rc));
+          }
+
+          rc = libusb_get_string_descriptor_ascii(
+              device_handle, device_descriptor.iProduct,
+              (unsigned char*)desc_string, sizeof(desc_string));
+          if (rc == 0) {
+            cable.description = desc_string;
+          }
+
+          rc = libusb_get_string_descriptor_ascii(
+              device_handle, device_descriptor.iSerialNumber,
+              (unsigned char*)desc_string, sizeof(desc_string));
+          if (rc == 0) {
+            cable.serial_number = desc_string;
+          }
+
+          libusb_close(device_handle);
+          cables.push_back(cable);
         }
-
-        libusb_close(device_handle);
-        cables.push_back(cable);
       }
     }
-  }
 
-  if (device_list != nullptr) {
-    libusb_free_device_list(device_list, 1);
-  }
+    if (device_list != nullptr) {
+      libusb_free_device_list(device_list, 1);
+    }
 
-  if (ctx != nullptr) {
-    libusb_exit(ctx);
+    return cables;
   }
 
-  return cables;
+  std::mutex m_mutex;
+  struct libusb_context* m_ctx = nullptr; /**< Libusb context **/
+  const std::vector<HardwareManager_CABLE_INFO>* m_cable_db = nullptr;
+  bool m_hotplug = false;
+  libusb_hotplug_callback_handle m_hotplug_handle = 0;
+  std::thread m_events;
+  std::atomic<bool> m_stop{false};
+  std::atomic<uint64_t> m_generation{0};
+  uint64_t m_scanned_generation = 0;
+  bool m_scanned = false;
+  std::chrono::steady_clock::time_point m_scan_time{};
+  std::vector<Cable> m_cables;
+};
+
+std::vector<Cable> HardwareManager::get_cables() {
+  return HardwareManager_CABLE_CACHE::instance().get_cables(m_cable_db);
 }
 
 bool HardwareManager::is_cable_exists(uint32_t cable_index) {
@@ -32,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define HM_USB_DESC_LENGTH (256)
 #define HM_DEFAULT_CABLE_SPEED_KHZ (1000)
+#define HM_CABLE_RESCAN_MS (1000)
 namespace FOEDAG {
 
 struct HardwareManager_CABLE_INFO {
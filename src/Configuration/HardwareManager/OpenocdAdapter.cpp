@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "OpenocdAdapter.h"
 
+#include <algorithm>
+#include <cctype>
 #include <filesystem>
 #include <map>
 #include <regex>
@@ -88,25 +90,50 @@ bool OpenocdAdapter::check_regex(std::string str, std::string pattern,
   return false;
 }
 
+static bool contains_nocase(const std::string& str, const std::string& word) {
+  return std::search(str.begin(), str.end(), word.begin(), word.end(),
+                     [](char a, char b) {
+                       return std::tolower((unsigned char)a) == b;
+                     }) != str.end();
+}
+
 CommandOutputType OpenocdAdapter::check_output(
     std::string str, std::vector<std::string>& output) {
-  static std::map<CommandOutputType, std::string> patterns = {
-      {CMD_PROGRESS, R"(Progress +(\d+.\d+)% +\((\d+)\/(\d+) +bytes\))"},
-      {CMD_ERROR, R"(\[RS\] Command error (\d+)\.*)"},
-      {CMD_TIMEOUT, R"(\[RS\] Timed out waiting for task to complete\.)"},
-      {CBUFFER_TIMEOUT, R"(\[RS\] Circular buffer timed out\.)"},
-      {FSBL_BOOT_FAILURE, R"(\[RS\] Failed to load FSBL firmware)"},
-      {UNKNOWN_FIRMWARE, R"(\[RS\] Unknown firmware)"},
-      {CONFIG_ERROR,
-       R"(\[RS\] FPGA fabric configuration error \(cfg_done *= *(\d+), *cfg_error *= *(\d+)\))"},
-      {CONFIG_SUCCESS,
-       R"(\[RS\] (Configured FPGA fabric|Programmed SPI Flash|Programmed OTP) successfully)"},
-      {INVALID_BITSTREAM,
-       R"(\[RS\] Unsupported UBI header version ([0-9a-f]+))"},
-  };
-
-  for (auto const& [key, pat] : patterns) {
-    if (check_regex(str, pat, output)) {
+  // Compiled once, this runs for every line openocd prints
+  static const std::vector<std::pair<CommandOutputType, std::regex>> patterns =
+      [] {
+        std::vector<std::pair<CommandOutputType, std::string>> sources = {
+            {CMD_PROGRESS, R"(Progress +(\d+.\d+)% +\((\d+)\/(\d+) +bytes\))"},
+            {CMD_ERROR, R"(\[RS\] Command error (\d+)\.*)"},
+            {CMD_TIMEOUT, R"(\[RS\] Timed out waiting for task to complete\.)"},
+            {CBUFFER_TIMEOUT, R"(\[RS\] Circular buffer timed out\.)"},
+            {CONFIG_ERROR,
+             R"(\[RS\] FPGA fabric configuration error \(cfg_done *= *(\d+), *cfg_error *= *(\d+)\))"},
+            {CONFIG_SUCCESS,
+             R"(\[RS\] (Configured FPGA fabric|Programmed SPI Flash|Programmed OTP) successfully)"},
+            {UNKNOWN_FIRMWARE, R"(\[RS\] Unknown firmware)"},
+            {FSBL_BOOT_FAILURE, R"(\[RS\] Failed to load FSBL firmware)"},
+            {INVALID_BITSTREAM,
+             R"(\[RS\] Unsupported UBI header version ([0-9a-f]+))"},
+        };
+        std::vector<std::pair<CommandOutputType, std::regex>> compiled;
+        for (auto const& [key, pat] : sources) {
+          compiled.emplace_back(key, std::regex{pat, std::regex::icase});
+        }
+        return compiled;
+      }();
+
+  // Every pattern has one of these words, most lines have none
+  if (!contains_nocase(str, "[rs]") && !contains_nocase(str, "progress")) {
+    return NOT_OUTPUT;
+  }
+  std::smatch m;
+  for (auto const& [key, re] : patterns) {
+    if (std::regex_search(str, m, re)) {
+      output.clear();
+      for (size_t i = 1; i < m.size(); i++) {
+        output.push_back(m[i]);
+      }
       return key;
     }
   }
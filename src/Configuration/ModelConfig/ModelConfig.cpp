@@ -19,14 +19,21 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "ModelConfig.h"
+
 #include "CFGCommon/CFGArg.h"
 #include "CFGCommon/CFGCommon.h"
 #include "DeviceModeling/Model.h"
 #include "DeviceModeling/device.h"
+#include "ModelConfig_BITSTREAM_READER.h"
 #include "ModelConfig_BITSTREAM_SETTING_XML.h"
+#include "ModelConfig_BITSTREAM_WRITER.h"
 #include "ModelConfig_IO.h"
 #include "nlohmann_json/json.hpp"
 
+#include <future>
+#include <unordered_map>
+
 #define DEBUG_PRINT_API 0
 
 namespace FOEDAG {
@@ -36,6 +43,16 @@ bool is_none_config_block(const device_block* block) {
   return CFG_find_string_in_vector({"1", "true", "on"}, is_none_config) >= 0;
 }
 
+struct ModelConfig_ASSIGNMENT {
+ public:
+  ModelConfig_ASSIGNMENT(uint32_t source, uint32_t value,
+                         const std::string& reason)
+      : m_source(source), m_value(value), m_reason(reason) {}
+  uint32_t m_source = 0;
+  uint32_t m_value = 0;
+  std::string m_reason;
+};
+
 struct ModelConfig_BITFIELD {
  public:
   ModelConfig_BITFIELD(const std::string& block_name,
@@ -49,17 +66,18 @@ struct ModelConfig_BITFIELD {
         m_size(size),
         m_value(default_value),
         m_default_value(default_value),
+        m_written_value(default_value),
         m_type(type) {
     CFG_ASSERT(m_size > 0 && m_size <= 32);
     CFG_ASSERT(m_size == 32 || (m_value < ((uint32_t)(1) << m_size)));
   }
   std::string get_reasons() const {
     std::string reason = "";
-    for (auto& r : reasons) {
+    for (auto& a : m_assignments) {
       if (reason.size()) {
-        reason = CFG_print("%s, %s", reason.c_str(), r.c_str());
+        reason = CFG_print("%s, %s", reason.c_str(), a.m_reason.c_str());
       } else {
-        reason = r;
+        reason = a.m_reason;
       }
     }
     if (reason.size()) {
@@ -67,9 +85,38 @@ struct ModelConfig_BITFIELD {
     }
     return reason;
   }
+  bool assign(uint32_t source, uint32_t value, const std::string& reason) {
+    // Assignments stay in source order, the value is the last one. A source
+    // holds one assignment per bitfield, a later one replaces its value and
+    // adds its reason
+    auto iter = std::upper_bound(
+        m_assignments.begin(), m_assignments.end(), source,
+        [](uint32_t s, const ModelConfig_ASSIGNMENT& a) {
+          return s < a.m_source;
+        });
+    if (iter != m_assignments.begin() && (iter - 1)->m_source == source) {
+      (iter - 1)->m_value = value;
+      (iter - 1)->m_reason =
+          CFG_print("%s, %s", (iter - 1)->m_reason.c_str(), reason.c_str());
+      update_value();
+      return false;
+    }
+    m_assignments.insert(iter, ModelConfig_ASSIGNMENT(source, value, reason));
+    update_value();
+    return true;
+  }
+  void unassign(uint32_t source) {
+    m_assignments.erase(
+        std::remove_if(m_assignments.begin(), m_assignments.end(),
+                       [source](const ModelConfig_ASSIGNMENT& a) {
+                         return a.m_source == source;
+                       }),
+        m_assignments.end());
+    update_value();
+  }
   void reset() {
-    m_value = m_default_value;
-    reasons.clear();
+    m_assignments.clear();
+    update_value();
   }
   const std::string m_block_name;
   const std::string m_user_name;
@@ -78,8 +125,16 @@ struct ModelConfig_BITFIELD {
   const uint32_t m_size;
   uint32_t m_value = 0;
   const uint32_t m_default_value = 0;
+  uint32_t m_written_value = 0;
+  bool m_dirty = false;
   std::shared_ptr<ParameterType<int>> m_type;
-  std::vector<std::string> reasons;
+  std::vector<ModelConfig_ASSIGNMENT> m_assignments;
+
+ protected:
+  void update_value() {
+    m_value = m_assignments.size() ? m_assignments.back().m_value
+                                   : m_default_value;
+  }
 };
 
 struct ModelConfig_API_ATTRIBUTE {
@@ -202,6 +257,7 @@ class ModelConfig_DEVICE {
         CFG_ASSERT(b == 0xFF);
       }
     }
+    index_bitfields();
   }
   ~ModelConfig_DEVICE() {
     while (m_bitfields.size()) {
@@ -214,6 +270,7 @@ class ModelConfig_DEVICE {
     }
   }
   const device* get_device() { return m_device; }
+  const std::string& get_model() { return m_model; }
   void check_json_setting(nlohmann::json& json,
                           const std::vector<std::string>& vector) {
     CFG_ASSERT(json.is_object());
@@ -294,12 +351,29 @@ class ModelConfig_DEVICE {
       }
       CFG_ASSERT(bitfield->m_size == 32 ||
                  (v < ((uint32_t)(1) << bitfield->m_size)));
-      bitfield->m_value = v;
-      bitfield->reasons.push_back(reason);
+      if (bitfield->assign(m_source, v, reason)) {
+        m_source_bitfields[m_source].push_back(bitfield);
+      }
+      mark_dirty(bitfield);
     }
   }
+  void set_attr(const std::map<std::string, std::string>& options) {
+    // Commands of a named source accumulate. Consecutive commands without a
+    // source share one implicit source, a new one is only started when
+    // another source was applied in between, so the last command still wins
+    if (options.find("source") != options.end()) {
+      m_source = get_source(options.at("source"), false);
+    } else {
+      if (m_source_bitfields.empty() ||
+          m_implicit_source != m_source_bitfields.size() - 1) {
+        m_implicit_source = get_source("", true);
+      }
+      m_source = m_implicit_source;
+    }
+    set_attr(options, "");
+  }
   void set_attr(const std::map<std::string, std::string>& options,
-                std::string reason = "") {
+                std::string reason) {
     std::string instance = options.at("instance");
     std::string name = options.at("name");
     std::string value = options.at("value");
@@ -429,7 +503,16 @@ class ModelConfig_DEVICE {
                        description.c_str());
     }
   }
-  void set_design(const std::string& filepath) {
+  void set_design(const std::string& filepath, const std::string& source,
+                  bool incremental) {
+    // An incremental update replaces what the previous application of the
+    // source did, only the bitfields it touches are recomputed
+    if (incremental) {
+      clear_source(source);
+      m_source = get_source(source, false);
+    } else {
+      m_source = get_source(source, true);
+    }
     std::ifstream file(filepath.c_str());
     CFG_ASSERT_MSG(file.is_open() && file.good(), "Cannot open design file %s",
                    filepath.c_str());
@@ -478,109 +561,144 @@ class ModelConfig_DEVICE {
           filepath.c_str());
     }
   }
+  void clear_source(const std::string& source) {
+    auto iter = m_sources.find(source);
+    if (iter != m_sources.end()) {
+      for (auto bitfield : m_source_bitfields[iter->second]) {
+        bitfield->unassign(iter->second);
+        mark_dirty(bitfield);
+      }
+      m_source_bitfields[iter->second].clear();
+    }
+  }
   void write(const std::map<std::string, std::string>& options,
-             const std::string& filename) {
+             const std::string& filename, bool delta = false) {
     CFG_ASSERT(m_total_bits);
     std::string format = options.at("format");
     CFG_ASSERT(format == "BIT" || format == "WORD" || format == "DETAIL" ||
                format == "TCL" || format == "BIN");
-    uint32_t addr = 0;
-    std::vector<uint8_t> data;
-    std::ofstream file;
+    if (delta) {
+      write_delta(format, filename);
+      return;
+    }
+    ModelConfig_BITSTREAM_WRITER writer(filename, format, m_total_bits);
     if (format != "BIN") {
-      file.open(filename.c_str());
-      CFG_ASSERT(file.is_open());
-      CFG_ASSERT(file.good());
-      file
-          << CFG_print("// Feature Bitstream: %s\n", m_feature.c_str()).c_str();
-      file << CFG_print("// Model: %s\n", m_model.c_str()).c_str();
-      file << CFG_print("// Total Bits: %d\n", m_total_bits).c_str();
-      file << CFG_print("// Timestamp:\n").c_str();
-      file << CFG_print("// Format: %s\n", format.c_str()).c_str();
+      writer.write(CFG_print("// Feature Bitstream: %s\n", m_feature.c_str()));
+      writer.write(CFG_print("// Model: %s\n", m_model.c_str()));
+      writer.write(CFG_print("// Total Bits: %d\n", m_total_bits));
+      writer.write(CFG_print("// Timestamp:\n"));
+      writer.write(CFG_print("// Format: %s\n", format.c_str()));
       if (format == "TCL") {
-        file << CFG_print("model_config set_model -feature %s %s\n",
-                          m_feature.c_str(), m_model.c_str())
-                    .c_str();
-      }
-    }
-    if (format == "BIT" || format == "WORD" || format == "BIN") {
-      for (uint32_t i = 0; i < (((m_total_bits + 31) / 32) * 4); i++) {
-        data.push_back(0);
+        writer.write(CFG_print("model_config set_model -feature %s %s\n",
+                               m_feature.c_str(), m_model.c_str()));
       }
     }
+    uint32_t addr = 0;
     std::string block_name = "";
-    while (addr < m_total_bits) {
-      CFG_ASSERT(m_bitfields.find(addr) != m_bitfields.end());
-      const ModelConfig_BITFIELD* bitfield = m_bitfields.at(addr);
+    for (auto& iter : m_bitfields) {
+      const ModelConfig_BITFIELD* bitfield = iter.second;
       CFG_ASSERT(addr == bitfield->m_addr);
-      if (data.size()) {
-        for (uint32_t i = 0; i < bitfield->m_size; i++, addr++) {
-          if (bitfield->m_value & (1 << i)) {
-            data[addr >> 3] |= (1 << (addr & 7));
-          }
-        }
-      } else if (format == "DETAIL") {
-        if (bitfield->m_block_name != block_name) {
-          file << CFG_print("Block %s [%s]\n", bitfield->m_block_name.c_str(),
-                            bitfield->m_user_name.c_str())
-                      .c_str();
-          file << "  Attributes:\n";
-          block_name = bitfield->m_block_name;
-        }
-        file << CFG_print(
-                    "    %*s - Addr: 0x%08X, Size: %2d, Value: (0x%08X) %d%s\n",
-                    m_max_attr_name_length, bitfield->m_name.c_str(),
-                    bitfield->m_addr, bitfield->m_size, bitfield->m_value,
-                    bitfield->m_value, bitfield->get_reasons().c_str())
-                    .c_str();
-        addr += bitfield->m_size;
+      if (writer.is_bitstream()) {
+        writer.append_bits(bitfield->m_value, bitfield->m_size);
       } else {
-        block_name = bitfield->m_user_name.size() ? bitfield->m_user_name
-                                                  : bitfield->m_block_name;
-        file << CFG_print(
-                    "model_config set_attr -instance %s -name %s -value %d\n",
-                    block_name.c_str(), bitfield->m_name.c_str(),
-                    bitfield->m_value)
-                    .c_str();
-        addr += bitfield->m_size;
+        write_bitfield(writer, format, bitfield, block_name);
       }
+      addr += bitfield->m_size;
     }
     CFG_ASSERT(addr == m_total_bits);
-    if (data.size()) {
-      if (format == "BIT") {
-        for (uint32_t i = 0; i < m_total_bits; i++) {
-          if (data[i >> 3] & (1 << (i & 7))) {
-            file << "1\n";
-          } else {
-            file << "0\n";
-          }
-        }
-      } else if (format == "WORD") {
-        uint32_t* words = (uint32_t*)(&data[0]);
-        uint32_t word_count = (m_total_bits + 31) / 32;
-        for (uint32_t i = 0; i < word_count; i++) {
-          file << CFG_print("%08X", words[i]).c_str();
-          if ((i + 1) == word_count && (m_total_bits % 32) != 0) {
-            file << CFG_print(" // (Valid LSBits: %d, Dummy MSBits: %d)\n",
-                              m_total_bits % 32, 32 - (m_total_bits % 32))
-                        .c_str();
-          } else {
-            file << "\n";
-          }
+    writer.close();
+    mark_written();
+  }
+  uint32_t diff(const std::string& format, const std::string& image1,
+                const std::string& image2, const std::string& filename) {
+    // Both images are streamed word by word and only the words that differ
+    // are decoded. A bitfield is at most 32 bits, so it spans at most two
+    // words: each word is compared with its neighbours loaded, and the
+    // bitfield holding a different bit is found in the address map
+    CFG_ASSERT(m_total_bits);
+    ModelConfig_BITSTREAM_READER reader1(image1, format, m_total_bits);
+    ModelConfig_BITSTREAM_READER reader2(image2, format, m_total_bits);
+    ModelConfig_BITSTREAM_READER* readers[2] = {&reader1, &reader2};
+    uint64_t windows[2][3] = {{0, 0, 0}, {0, 0, 0}};
+    auto read_next = [&readers, &windows]() {
+      uint32_t valid_bits[2] = {0, 0};
+      bool status[2] = {false, false};
+      for (int i = 0; i < 2; i++) {
+        windows[i][0] = windows[i][1];
+        windows[i][1] = windows[i][2];
+        status[i] = readers[i]->read_word(windows[i][2], valid_bits[i]);
+      }
+      CFG_ASSERT(status[0] == status[1] && valid_bits[0] == valid_bits[1]);
+      return status[0];
+    };
+    std::vector<const ModelConfig_BITFIELD*> changes;
+    std::vector<std::pair<uint32_t, uint32_t>> values;
+    bool has_word = read_next();
+    // End address of the last reported bitfield, which may reach this word
+    uint32_t reported_end = 0;
+    for (uint32_t base = 0; has_word; base += 64) {
+      has_word = read_next();
+      // Current word is now windows[i][1], its bit 0 is at address base
+      uint64_t difference = windows[0][1] ^ windows[1][1];
+      if (reported_end > base) {
+        difference &= ~(((uint64_t)(1) << (reported_end - base)) - 1);
+      }
+      while (difference) {
+        uint32_t bit = 0;
+        while (((difference >> bit) & 1) == 0) {
+          bit++;
         }
-      } else {
-        CFG_write_binary_file(filename, &data[0], (m_total_bits + 7) / 8);
+        auto iter = m_bitfields.upper_bound(base + bit);
+        CFG_ASSERT(iter != m_bitfields.begin());
+        const ModelConfig_BITFIELD* bitfield = (--iter)->second;
+        CFG_ASSERT((bitfield->m_addr + bitfield->m_size) > (base + bit));
+        uint32_t offset = bitfield->m_addr + 64 - base;
+        changes.push_back(bitfield);
+        values.push_back(
+            {get_window_bits(windows[0], offset, bitfield->m_size),
+             get_window_bits(windows[1], offset, bitfield->m_size)});
+        reported_end = bitfield->m_addr + bitfield->m_size;
+        uint32_t end = reported_end - base;
+        difference =
+            end >= 64 ? 0 : (difference & ~(((uint64_t)(1) << end) - 1));
       }
     }
-    if (file.is_open()) {
-      file.flush();
-      file.close();
+    ModelConfig_BITSTREAM_WRITER writer(filename, "DETAIL", m_total_bits);
+    writer.write(CFG_print("// Feature Bitstream: %s\n", m_feature.c_str()));
+    writer.write(CFG_print("// Model: %s\n", m_model.c_str()));
+    writer.write(CFG_print("// Total Bits: %d\n", m_total_bits));
+    writer.write(
+        CFG_print("// Changed Bitfields: %d\n", (int)(changes.size())));
+    writer.write(CFG_print("// Format: %s\n", format.c_str()));
+    std::string block_name = "";
+    for (size_t i = 0; i < changes.size(); i++) {
+      const ModelConfig_BITFIELD* bitfield = changes[i];
+      if (bitfield->m_block_name != block_name) {
+        writer.write(CFG_print("Block %s [%s]\n",
+                               bitfield->m_block_name.c_str(),
+                               bitfield->m_user_name.c_str()));
+        writer.write("  Attributes:\n");
+        block_name = bitfield->m_block_name;
+      }
+      writer.write(CFG_print(
+          "    %*s - Addr: 0x%08X, Size: %2d, Value: %s -> %s\n",
+          m_max_attr_name_length, bitfield->m_name.c_str(), bitfield->m_addr,
+          bitfield->m_size, get_value_name(bitfield, values[i].first).c_str(),
+          get_value_name(bitfield, values[i].second).c_str()));
     }
+    writer.close();
+    return (uint32_t)(changes.size());
   }
   void reset() {
     for (auto& b : m_bitfields) {
-      b.second->reset();
+      if (b.second->m_assignments.size()) {
+        b.second->reset();
+        mark_dirty(b.second);
+      }
     }
+    m_sources.clear();
+    m_source_bitfields.clear();
+    m_implicit_source = UINT32_MAX;
   }
 
  protected:
@@ -589,32 +707,119 @@ class ModelConfig_DEVICE {
     value = (uint32_t)(CFG_convert_string_to_u64(str, true, &status));
     return status;
   }
-  bool is_valid_block(const std::string& instance) {
-    bool valid = false;
-    for (auto& b : m_bitfields) {
-      if (b.second->m_block_name == instance ||
-          b.second->m_user_name == instance) {
-        valid = true;
-        break;
+  uint32_t get_source(const std::string& source, bool fresh) {
+    if (!fresh && m_sources.find(source) != m_sources.end()) {
+      return m_sources.at(source);
+    }
+    uint32_t index = (uint32_t)(m_source_bitfields.size());
+    m_source_bitfields.push_back({});
+    if (source.size()) {
+      m_sources[source] = index;
+    }
+    return index;
+  }
+  uint32_t get_window_bits(const uint64_t* window, uint32_t offset,
+                           uint32_t size) {
+    uint32_t value = 0;
+    for (uint32_t i = 0, j = offset; i < size; i++, j++) {
+      if ((window[j >> 6] >> (j & 63)) & 1) {
+        value |= ((uint32_t)(1) << i);
       }
     }
-    return valid;
+    return value;
   }
-  std::string get_block_name(const std::string& instance) {
-    bool valid = false;
-    std::string block_name = instance;
-    for (auto& b : m_bitfields) {
-      if (b.second->m_user_name == instance) {
-        block_name = b.second->m_block_name;
-        valid = true;
-        break;
-      } else if (b.second->m_block_name == instance) {
-        valid = true;
-        break;
+  std::string get_value_name(const ModelConfig_BITFIELD* bitfield,
+                             uint32_t value) {
+    // Enum names are unordered, the smallest name wins for stable output
+    std::string enum_name = "";
+    if (bitfield->m_type != nullptr) {
+      for (auto& e : bitfield->m_type->get_enum_values()) {
+        if (e.second == value && (enum_name.empty() || e.first < enum_name)) {
+          enum_name = e.first;
+        }
+      }
+    }
+    std::string name = CFG_print("(0x%08X) %d", value, value);
+    if (enum_name.size()) {
+      name = CFG_print("%s [%s]", name.c_str(), enum_name.c_str());
+    }
+    return name;
+  }
+  void mark_dirty(ModelConfig_BITFIELD* bitfield) {
+    if (!bitfield->m_dirty) {
+      bitfield->m_dirty = true;
+      m_dirty_bitfields.push_back(bitfield);
+    }
+  }
+  void mark_written() {
+    for (auto bitfield : m_dirty_bitfields) {
+      bitfield->m_written_value = bitfield->m_value;
+      bitfield->m_dirty = false;
+    }
+    m_dirty_bitfields.clear();
+  }
+  void write_bitfield(ModelConfig_BITSTREAM_WRITER& writer,
+                      const std::string& format,
+                      const ModelConfig_BITFIELD* bitfield,
+                      std::string& block_name) {
+    if (format == "DETAIL") {
+      if (bitfield->m_block_name != block_name) {
+        writer.write(CFG_print("Block %s [%s]\n",
+                               bitfield->m_block_name.c_str(),
+                               bitfield->m_user_name.c_str()));
+        writer.write("  Attributes:\n");
+        block_name = bitfield->m_block_name;
+      }
+      writer.write(CFG_print(
+          "    %*s - Addr: 0x%08X, Size: %2d, Value: (0x%08X) %d%s\n",
+          m_max_attr_name_length, bitfield->m_name.c_str(), bitfield->m_addr,
+          bitfield->m_size, bitfield->m_value, bitfield->m_value,
+          bitfield->get_reasons().c_str()));
+    } else {
+      block_name = bitfield->m_user_name.size() ? bitfield->m_user_name
+                                                : bitfield->m_block_name;
+      writer.write(CFG_print(
+          "model_config set_attr -instance %s -name %s -value %d\n",
+          block_name.c_str(), bitfield->m_name.c_str(), bitfield->m_value));
+    }
+  }
+  void write_delta(const std::string& format, const std::string& filename) {
+    // Only the bitfields changed since the last written image, as text that
+    // can be reviewed (DETAIL) or replayed on top of that image (TCL)
+    CFG_ASSERT_MSG(format == "DETAIL" || format == "TCL",
+                   "Delta image only supports DETAIL and TCL format, but "
+                   "found %s",
+                   format.c_str());
+    std::vector<const ModelConfig_BITFIELD*> changes;
+    for (auto bitfield : m_dirty_bitfields) {
+      if (bitfield->m_value != bitfield->m_written_value) {
+        changes.push_back(bitfield);
       }
     }
-    CFG_ASSERT(valid);
-    return block_name;
+    std::sort(changes.begin(), changes.end(),
+              [](const ModelConfig_BITFIELD* a, const ModelConfig_BITFIELD* b) {
+                return a->m_addr < b->m_addr;
+              });
+    ModelConfig_BITSTREAM_WRITER writer(filename, format, m_total_bits);
+    writer.write(CFG_print("// Feature Bitstream: %s\n", m_feature.c_str()));
+    writer.write(CFG_print("// Model: %s\n", m_model.c_str()));
+    writer.write(CFG_print("// Total Bits: %d\n", m_total_bits));
+    writer.write(CFG_print("// Delta Bitfields: %d\n", (int)(changes.size())));
+    writer.write(CFG_print("// Format: %s\n", format.c_str()));
+    std::string block_name = "";
+    for (auto bitfield : changes) {
+      write_bitfield(writer, format, bitfield, block_name);
+    }
+    writer.close();
+    mark_written();
+  }
+  bool is_valid_block(const std::string& instance) {
+    return m_block_names.find(instance) != m_block_names.end();
+  }
+  std::string get_block_name(const std::string& instance) {
+    auto iter = m_block_names.find(instance);
+    CFG_ASSERT(iter != m_block_names.end());
+    return iter->second;
   }
   std::string get_mapped_block_name(const std::string& instance,
                                     const std::string& mapped_location,
@@ -637,16 +842,21 @@ class ModelConfig_DEVICE {
   }
   ModelConfig_BITFIELD* get_bitfield(const std::string& instance,
                                      const std::string& name) {
-    ModelConfig_BITFIELD* bitfield = nullptr;
+    auto iter = m_bitfield_index.find(instance + '\n' + name);
+    return iter != m_bitfield_index.end() ? iter->second : nullptr;
+  }
+  void index_bitfields() {
+    // Bitfields are fixed once the model is set. Index them by block and
+    // user name, the lowest address wins like the former linear searches.
     for (auto& b : m_bitfields) {
-      if ((b.second->m_block_name == instance ||
-           b.second->m_user_name == instance) &&
-          b.second->m_name == name) {
-        bitfield = b.second;
-        break;
-      }
+      ModelConfig_BITFIELD* bitfield = b.second;
+      m_block_names.emplace(bitfield->m_user_name, bitfield->m_block_name);
+      m_block_names.emplace(bitfield->m_block_name, bitfield->m_block_name);
+      m_bitfield_index.emplace(bitfield->m_user_name + '\n' + bitfield->m_name,
+                               bitfield);
+      m_bitfield_index.emplace(
+          bitfield->m_block_name + '\n' + bitfield->m_name, bitfield);
     }
-    return bitfield;
   }
   void add_bitfield(const std::string& block_name, const std::string& user_name,
                     const std::string& bitfield_name, uint32_t addr,
@@ -712,7 +922,16 @@ class ModelConfig_DEVICE {
   uint32_t m_total_bits = 0;
   uint32_t m_max_attr_name_length = 0;
   std::map<size_t, ModelConfig_BITFIELD*> m_bitfields;
+  std::unordered_map<std::string, ModelConfig_BITFIELD*> m_bitfield_index;
+  std::unordered_map<std::string, std::string> m_block_names;
   std::map<std::string, ModelConfig_API*> m_api;
+  // Design input sources in application order, each with the bitfields it
+  // assigned, and the bitfields changed since the last written image
+  uint32_t m_source = 0;
+  uint32_t m_implicit_source = UINT32_MAX;
+  std::map<std::string, uint32_t> m_sources;
+  std::vector<std::vector<ModelConfig_BITFIELD*>> m_source_bitfields;
+  std::vector<ModelConfig_BITFIELD*> m_dirty_bitfields;
 };
 
 static class ModelConfig_MRG {
@@ -746,15 +965,74 @@ static class ModelConfig_MRG {
     set_feature("set_attr", options);
     m_current_device->set_attr(options);
   }
-  void set_design(const std::map<std::string, std::string>& options,
+  void set_design(const std::vector<std::string>& flag_options,
+                  const std::map<std::string, std::string>& options,
                   const std::string& filepath) {
     set_feature("set_design", options);
-    m_current_device->set_design(filepath);
+    std::string source = options.find("source") != options.end()
+                             ? options.at("source")
+                             : filepath;
+    bool incremental = std::find(flag_options.begin(), flag_options.end(),
+                                 "incremental") != flag_options.end();
+    m_current_device->set_design(filepath, source, incremental);
   }
-  void write(const std::map<std::string, std::string>& options,
+  void clear_source(const std::map<std::string, std::string>& options,
+                    const std::string& source) {
+    set_feature("clear_source", options);
+    m_current_device->clear_source(source);
+  }
+  void write(const std::vector<std::string>& flag_options,
+             const std::map<std::string, std::string>& options,
              const std::string& filename) {
     set_feature("write", options);
-    m_current_device->write(options, filename);
+    bool delta = std::find(flag_options.begin(), flag_options.end(),
+                           "delta") != flag_options.end();
+    m_current_device->write(options, filename, delta);
+  }
+  void write_all(const std::map<std::string, std::string>& options,
+                 const std::string& filename) {
+    CFG_ASSERT_MSG(m_feature_devices.size(),
+                   "model_config is not able to 'write_all' because no "
+                   "feature device model is set");
+    // Each feature has its own model and address space, so every feature
+    // gets its own image: <stem>.<feature><extension>. The images do not
+    // share any state and are generated on their own thread.
+    std::filesystem::path path(filename);
+    std::vector<std::future<void>> jobs;
+    for (auto& iter : m_feature_devices) {
+      ModelConfig_DEVICE* device = iter.second;
+      std::filesystem::path output =
+          path.parent_path() /
+          CFG_print("%s.%s%s", path.stem().string().c_str(),
+                    iter.first.c_str(), path.extension().string().c_str());
+      jobs.push_back(
+          std::async(std::launch::async, [device, &options, output] {
+            device->write(options, output.string());
+          }));
+    }
+    std::exception_ptr error = nullptr;
+    for (auto& job : jobs) {
+      try {
+        job.get();
+      } catch (...) {
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+  void diff(const std::map<std::string, std::string>& options,
+            const std::string& image1, const std::string& image2,
+            const std::string& filename) {
+    set_feature("diff", options);
+    uint32_t count =
+        model_config_diff(m_current_feature, m_current_device->get_model(),
+                          options.at("format"), image1, image2, filename);
+    CFG_POST_MSG("Found %d changed bitfield(s) between %s and %s", count,
+                 image1.c_str(), image2.c_str());
   }
   void reset(const std::map<std::string, std::string>& options) {
     set_feature("reset", options);
@@ -866,6 +1144,17 @@ static class ModelConfig_MRG {
   std::map<std::string, ModelConfig_DEVICE*> m_feature_devices;
 } ModelConfig_DEVICE_DLL;
 
+uint32_t model_config_diff(const std::string& feature, const std::string& model,
+                           const std::string& format, const std::string& image1,
+                           const std::string& image2,
+                           const std::string& filename) {
+  device* dev = Model::get_modler().get_device_model(model);
+  CFG_ASSERT_MSG(dev != nullptr, "Could not find device model '%s'",
+                 model.c_str());
+  ModelConfig_DEVICE config(feature, model, dev);
+  return config.diff(format, image1, image2, filename);
+}
+
 void model_config_entry(CFGCommon_ARG* cmdarg) {
   CFG_ASSERT(cmdarg->raws.size());
   std::vector<std::string> flag_options;
@@ -884,18 +1173,35 @@ void model_config_entry(CFGCommon_ARG* cmdarg) {
   } else if (cmdarg->raws[0] == "set_attr") {
     CFGArg::parse("model_config|set_attr", cmdarg->raws.size(),
                   &cmdarg->raws[0], flag_options, options, positional_options,
-                  {}, {"instance", "name", "value"}, {"feature"}, 0);
+                  {}, {"instance", "name", "value"}, {"feature", "source"}, 0);
     ModelConfig_DEVICE_DLL.set_attr(options);
   } else if (cmdarg->raws[0] == "set_design") {
     CFGArg::parse("model_config|set_design", cmdarg->raws.size(),
+                  &cmdarg->raws[0], flag_options, options, positional_options,
+                  {"incremental"}, {}, {"feature", "source"}, 1);
+    ModelConfig_DEVICE_DLL.set_design(flag_options, options,
+                                      positional_options[0]);
+  } else if (cmdarg->raws[0] == "clear_source") {
+    CFGArg::parse("model_config|clear_source", cmdarg->raws.size(),
                   &cmdarg->raws[0], flag_options, options, positional_options,
                   {}, {}, {"feature"}, 1);
-    ModelConfig_DEVICE_DLL.set_design(options, positional_options[0]);
+    ModelConfig_DEVICE_DLL.clear_source(options, positional_options[0]);
   } else if (cmdarg->raws[0] == "write") {
     CFGArg::parse("model_config|write", cmdarg->raws.size(), &cmdarg->raws[0],
+                  flag_options, options, positional_options, {"delta"},
+                  {"format"}, {"feature"}, 1);
+    ModelConfig_DEVICE_DLL.write(flag_options, options, positional_options[0]);
+  } else if (cmdarg->raws[0] == "write_all") {
+    CFGArg::parse("model_config|write_all", cmdarg->raws.size(),
+                  &cmdarg->raws[0], flag_options, options, positional_options,
+                  {}, {"format"}, {}, 1);
+    ModelConfig_DEVICE_DLL.write_all(options, positional_options[0]);
+  } else if (cmdarg->raws[0] == "diff") {
+    CFGArg::parse("model_config|diff", cmdarg->raws.size(), &cmdarg->raws[0],
                   flag_options, options, positional_options, {}, {"format"},
-                  {"feature"}, 1);
-    ModelConfig_DEVICE_DLL.write(options, positional_options[0]);
+                  {"feature"}, 3);
+    ModelConfig_DEVICE_DLL.diff(options, positional_options[0],
+                                positional_options[1], positional_options[2]);
   } else if (cmdarg->raws[0] == "reset") {
     CFGArg::parse("model_config|reset", cmdarg->raws.size(), &cmdarg->raws[0],
                   flag_options, options, positional_options, {}, {},
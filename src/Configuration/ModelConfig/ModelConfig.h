@@ -28,6 +28,23 @@ namespace FOEDAG {
 
 void model_config_entry(CFGCommon_ARG* cmdarg);
 
+/**
+ * Compare two configuration images of a device model and report every
+ * bitfield that differs, with both values, in DETAIL format
+ *
+ * @param feature   Feature name written in the report header
+ * @param model     Device model the images were written for
+ * @param format    Format of both images: BIT, WORD or BIN
+ * @param image1    First image
+ * @param image2    Second image
+ * @param filename  Report file
+ * @return          Number of changed bitfields
+ */
+uint32_t model_config_diff(const std::string& feature, const std::string& model,
+                           const std::string& format, const std::string& image1,
+                           const std::string& image2,
+                           const std::string& filename);
+
 }  // namespace FOEDAG
 
 #endif
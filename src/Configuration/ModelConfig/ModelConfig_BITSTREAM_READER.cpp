@@ -0,0 +1,154 @@
+/*
+Copyright 2023 The Foedag team
+
+GPL License
+
+Copyright (c) 2023 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ModelConfig_BITSTREAM_READER.h"
+
+namespace FOEDAG {
+
+static constexpr size_t MODEL_CONFIG_BITSTREAM_READ_SIZE = 1 << 20;
+
+ModelConfig_BITSTREAM_READER::ModelConfig_BITSTREAM_READER(
+    const std::string& filepath, const std::string& format,
+    uint32_t total_bits)
+    : m_filepath(filepath), m_total_bits(total_bits) {
+  const std::vector<std::string> formats = {"BIT", "WORD", "BIN"};
+  int index = CFG_find_string_in_vector(formats, format);
+  CFG_ASSERT_MSG(index >= 0, "Invalid bitstream format %s to read",
+                 format.c_str());
+  m_format = (FORMAT)(index);
+  if (m_format == BIN) {
+    m_file.open(filepath.c_str(), std::ios::in | std::ios::binary);
+  } else {
+    m_file.open(filepath.c_str());
+  }
+  CFG_ASSERT_MSG(m_file.is_open(), "Fail to open bitstream %s",
+                 filepath.c_str());
+}
+
+ModelConfig_BITSTREAM_READER::~ModelConfig_BITSTREAM_READER() {
+  if (m_file.is_open()) {
+    m_file.close();
+  }
+}
+
+/*
+  Read the next (up to) 64 bits of the image, LSB first
+  Return false once all the bits had been read
+*/
+bool ModelConfig_BITSTREAM_READER::read_word(uint64_t& word,
+                                             uint32_t& valid_bits) {
+  word = 0;
+  valid_bits = 0;
+  if (m_bit_count >= m_total_bits) {
+    char c = 0;
+    if (m_format == BIN) {
+      CFG_ASSERT_MSG(!read_char(c), "Bitstream %s is bigger than %d bits",
+                     m_filepath.c_str(), m_total_bits);
+    } else {
+      std::string line = "";
+      CFG_ASSERT_MSG(!read_line(line), "Bitstream %s is bigger than %d bits",
+                     m_filepath.c_str(), m_total_bits);
+    }
+    return false;
+  }
+  valid_bits = m_total_bits - m_bit_count >= 64
+                   ? 64
+                   : (uint32_t)(m_total_bits - m_bit_count);
+  if (m_format == BIN) {
+    for (uint32_t i = 0; i < (valid_bits + 7) / 8; i++) {
+      char c = 0;
+      CFG_ASSERT_MSG(read_char(c), "Bitstream %s is smaller than %d bits",
+                     m_filepath.c_str(), m_total_bits);
+      word |= (uint64_t)((uint8_t)(c)) << (i * 8);
+    }
+  } else if (m_format == WORD) {
+    for (uint32_t half = 0; half < 2 && (half * 32) < valid_bits; half++) {
+      std::string line = "";
+      CFG_ASSERT_MSG(read_line(line) && line.size() >= 8,
+                     "Bitstream %s is smaller than %d bits",
+                     m_filepath.c_str(), m_total_bits);
+      bool status = false;
+      uint64_t value = CFG_convert_string_to_u64(
+          CFG_print("0x%s", line.substr(0, 8).c_str()), false, &status);
+      CFG_ASSERT_MSG(status, "Bitstream %s has invalid WORD line '%s'",
+                     m_filepath.c_str(), line.c_str());
+      word |= value << (half * 32);
+    }
+  } else {
+    for (uint32_t i = 0; i < valid_bits; i++) {
+      std::string line = "";
+      CFG_ASSERT_MSG(read_line(line), "Bitstream %s is smaller than %d bits",
+                     m_filepath.c_str(), m_total_bits);
+      CFG_ASSERT_MSG(line == "0" || line == "1",
+                     "Bitstream %s has invalid BIT line '%s'",
+                     m_filepath.c_str(), line.c_str());
+      if (line == "1") {
+        word |= (uint64_t)(1) << i;
+      }
+    }
+  }
+  if (valid_bits < 64) {
+    word &= ((uint64_t)(1) << valid_bits) - 1;
+  }
+  m_bit_count += valid_bits;
+  return true;
+}
+
+bool ModelConfig_BITSTREAM_READER::read_char(char& c) {
+  if (m_index == m_buffer.size()) {
+    m_buffer.resize(MODEL_CONFIG_BITSTREAM_READ_SIZE);
+    m_file.read(&m_buffer[0], m_buffer.size());
+    m_buffer.resize((size_t)(m_file.gcount()));
+    m_index = 0;
+    if (m_buffer.empty()) {
+      return false;
+    }
+  }
+  c = m_buffer[m_index++];
+  return true;
+}
+
+/*
+  Read the next line that is not empty nor a "//" comment
+*/
+bool ModelConfig_BITSTREAM_READER::read_line(std::string& line) {
+  char c = 0;
+  while (true) {
+    line.clear();
+    bool found = false;
+    while (read_char(c)) {
+      found = true;
+      if (c == '\n') {
+        break;
+      } else if (c != '\r') {
+        line.push_back(c);
+      }
+    }
+    if (!found) {
+      return false;
+    }
+    if (line.size() && line.find("//") != 0) {
+      return true;
+    }
+  }
+}
+
+}  // namespace FOEDAG
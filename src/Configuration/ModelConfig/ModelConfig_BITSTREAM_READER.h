@@ -0,0 +1,61 @@
+/*
+Copyright 2023 The Foedag team
+
+GPL License
+
+Copyright (c) 2023 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MODEL_CONFIG_BITSTREAM_READER_H
+#define MODEL_CONFIG_BITSTREAM_READER_H
+
+#include <Configuration/CFGCommon/CFGCommon.h>
+
+#include <fstream>
+
+namespace FOEDAG {
+
+/*
+  Streams a configuration image back from file.
+
+  The counterpart of ModelConfig_BITSTREAM_WRITER for BIT, WORD and BIN
+  formats: the image is returned as the same LSB first 64-bit words, one
+  buffer at a time, so the full image is never held in memory. The "//"
+  header lines of text formats are skipped.
+*/
+class ModelConfig_BITSTREAM_READER {
+ public:
+  ModelConfig_BITSTREAM_READER(const std::string& filepath,
+                               const std::string& format, uint32_t total_bits);
+  ~ModelConfig_BITSTREAM_READER();
+  bool read_word(uint64_t& word, uint32_t& valid_bits);
+
+ private:
+  enum FORMAT { BIT, WORD, BIN };
+  bool read_char(char& c);
+  bool read_line(std::string& line);
+  const std::string m_filepath = "";
+  const uint32_t m_total_bits = 0;
+  FORMAT m_format = BIT;
+  std::ifstream m_file;
+  std::string m_buffer;
+  size_t m_index = 0;
+  uint64_t m_bit_count = 0;
+};
+
+}  // namespace FOEDAG
+
+#endif
@@ -0,0 +1,139 @@
+/*
+Copyright 2023 The Foedag team
+
+GPL License
+
+Copyright (c) 2023 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ModelConfig_BITSTREAM_WRITER.h"
+
+namespace FOEDAG {
+
+static constexpr size_t MODEL_CONFIG_BITSTREAM_BUFFER_SIZE = 1 << 20;
+
+ModelConfig_BITSTREAM_WRITER::ModelConfig_BITSTREAM_WRITER(
+    const std::string& filepath, const std::string& format,
+    uint32_t total_bits)
+    : m_total_bits(total_bits) {
+  const std::vector<std::string> formats = {"BIT", "WORD", "DETAIL", "TCL",
+                                            "BIN"};
+  int index = CFG_find_string_in_vector(formats, format);
+  CFG_ASSERT_MSG(index >= 0, "Invalid bitstream format %s", format.c_str());
+  m_format = (FORMAT)(index);
+  if (m_format == BIN) {
+    m_file.open(filepath.c_str(), std::ios::out | std::ios::binary);
+  } else {
+    m_file.open(filepath.c_str());
+  }
+  CFG_ASSERT(m_file.is_open());
+  CFG_ASSERT(m_file.good());
+  m_buffer.reserve(MODEL_CONFIG_BITSTREAM_BUFFER_SIZE + 1024);
+}
+
+ModelConfig_BITSTREAM_WRITER::~ModelConfig_BITSTREAM_WRITER() {
+  if (m_file.is_open()) {
+    flush_buffer();
+    m_file.close();
+  }
+}
+
+void ModelConfig_BITSTREAM_WRITER::write(const std::string& text) {
+  m_buffer.append(text);
+  if (m_buffer.size() >= MODEL_CONFIG_BITSTREAM_BUFFER_SIZE) {
+    flush_buffer();
+  }
+}
+
+void ModelConfig_BITSTREAM_WRITER::append_bits(uint32_t value, uint32_t size) {
+  CFG_ASSERT(is_bitstream());
+  CFG_ASSERT(size > 0 && size <= 32);
+  CFG_ASSERT((m_bit_count + size) <= m_total_bits);
+  uint64_t bits = value;
+  if (size < 32) {
+    bits &= ((uint64_t)(1) << size) - 1;
+  }
+  m_word |= bits << m_fill;
+  m_bit_count += size;
+  if ((m_fill + size) >= 64) {
+    // Size is at most 32, so the word was at least half full
+    uint32_t consumed = 64 - m_fill;
+    emit_word(m_word, 64);
+    m_word = bits >> consumed;
+    m_fill = m_fill + size - 64;
+  } else {
+    m_fill += size;
+  }
+}
+
+void ModelConfig_BITSTREAM_WRITER::close() {
+  if (!m_file.is_open()) {
+    return;
+  }
+  if (is_bitstream()) {
+    CFG_ASSERT(m_bit_count == m_total_bits);
+    if (m_fill) {
+      emit_word(m_word, m_fill);
+      m_word = 0;
+      m_fill = 0;
+    }
+  }
+  flush_buffer();
+  m_file.flush();
+  CFG_ASSERT(m_file.good());
+  m_file.close();
+}
+
+void ModelConfig_BITSTREAM_WRITER::emit_word(uint64_t word,
+                                             uint32_t valid_bits) {
+  static const char hex[] = "0123456789ABCDEF";
+  if (m_format == BIN) {
+    uint32_t bytes = (valid_bits + 7) / 8;
+    for (uint32_t i = 0; i < bytes; i++) {
+      m_buffer.push_back((char)((word >> (i * 8)) & 0xFF));
+    }
+  } else if (m_format == WORD) {
+    for (uint32_t half = 0; half < 2 && (half * 32) < valid_bits; half++) {
+      uint32_t value = (uint32_t)(word >> (half * 32));
+      for (int shift = 28; shift >= 0; shift -= 4) {
+        m_buffer.push_back(hex[(value >> shift) & 0xF]);
+      }
+      if ((m_total_bits % 32) != 0 && (half * 32 + 32) > valid_bits) {
+        m_buffer.append(CFG_print(" // (Valid LSBits: %d, Dummy MSBits: %d)\n",
+                                  m_total_bits % 32, 32 - (m_total_bits % 32)));
+      } else {
+        m_buffer.push_back('\n');
+      }
+    }
+  } else {
+    for (uint32_t i = 0; i < valid_bits; i++) {
+      m_buffer.push_back((word >> i) & 1 ? '1' : '0');
+      m_buffer.push_back('\n');
+    }
+  }
+  if (m_buffer.size() >= MODEL_CONFIG_BITSTREAM_BUFFER_SIZE) {
+    flush_buffer();
+  }
+}
+
+void ModelConfig_BITSTREAM_WRITER::flush_buffer() {
+  if (m_buffer.size()) {
+    m_file.write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+  }
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,64 @@
+/*
+Copyright 2023 The Foedag team
+
+GPL License
+
+Copyright (c) 2023 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MODEL_CONFIG_BITSTREAM_WRITER_H
+#define MODEL_CONFIG_BITSTREAM_WRITER_H
+
+#include <Configuration/CFGCommon/CFGCommon.h>
+
+#include <fstream>
+
+namespace FOEDAG {
+
+/*
+  Streams a configuration image to file.
+
+  BIT, WORD and BIN formats pack the appended bitfields LSB first into 64-bit
+  words and convert each completed word straight into the output buffer, so
+  the full image is never held in memory. DETAIL and TCL formats, and the
+  header of every text format, go through write().
+*/
+class ModelConfig_BITSTREAM_WRITER {
+ public:
+  ModelConfig_BITSTREAM_WRITER(const std::string& filepath,
+                               const std::string& format, uint32_t total_bits);
+  ~ModelConfig_BITSTREAM_WRITER();
+  bool is_bitstream() const { return m_format != DETAIL && m_format != TCL; }
+  void write(const std::string& text);
+  void append_bits(uint32_t value, uint32_t size);
+  void close();
+
+ private:
+  enum FORMAT { BIT, WORD, DETAIL, TCL, BIN };
+  void emit_word(uint64_t word, uint32_t valid_bits);
+  void flush_buffer();
+  const uint32_t m_total_bits = 0;
+  FORMAT m_format = BIT;
+  std::ofstream m_file;
+  std::string m_buffer;
+  uint64_t m_word = 0;
+  uint32_t m_fill = 0;
+  uint64_t m_bit_count = 0;
+};
+
+}  // namespace FOEDAG
+
+#endif
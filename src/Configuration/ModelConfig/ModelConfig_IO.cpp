@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <fstream>
 #include <iostream>
+#include <set>
 
 #include "CFGCommon/CFGArg.h"
 #include "CFGCommon/CFGCommon.h"
@@ -127,6 +128,8 @@ ModelConfig_IO::ModelConfig_IO(
   invalidate_childs();
   // Assign location to instance that naturally does not location
   assign_no_location_instance();
+  // Query the pin information of all placed instances at once
+  prefetch_pin_info();
   // Allocate FCLK routing
   allocate_fclk_routing();
   // Set CLKBUF configuration attributes
@@ -248,6 +251,39 @@ void ModelConfig_IO::validate_instances(nlohmann::json& instances) {
   for (auto& instance : m_instances) {
     validate_instance(instance);
   }
+  index_instances();
+}
+
+/*
+  Index the instances by name, linked object and module (the resource they
+  need). Instances are never added or removed after this point
+*/
+void ModelConfig_IO::index_instances() {
+  CFG_ASSERT(m_instance_records.empty());
+  m_instance_records.reserve(m_instances.size());
+  for (auto& instance : m_instances) {
+    size_t index = m_instance_records.size();
+    m_instance_records.push_back(MODEL_IO_INSTANCE(&instance));
+    const MODEL_IO_INSTANCE& record = m_instance_records.back();
+    m_instances_by_name[record.name].push_back(index);
+    m_instances_by_linked_object[record.linked_object].push_back(index);
+    m_instances_by_module[record.module].push_back(index);
+  }
+}
+
+/*
+  Get the instances of an index entry, in netlist order
+*/
+std::vector<nlohmann::json*> ModelConfig_IO::get_instances(
+    const MODEL_IO_INSTANCE_INDEX& index, const std::string& key) {
+  std::vector<nlohmann::json*> instances;
+  auto iter = index.find(key);
+  if (iter != index.end()) {
+    for (size_t i : iter->second) {
+      instances.push_back(m_instance_records[i].record);
+    }
+  }
+  return instances;
 }
 
 /*
@@ -737,14 +773,15 @@ void ModelConfig_IO::invalidate_childs() {
   (if any of them is invalid)
 */
 void ModelConfig_IO::invalidate_chain(const std::string& linked_object) {
-  for (auto& instance : m_instances) {
+  for (auto instance_ptr :
+       get_instances(m_instances_by_linked_object, linked_object)) {
+    nlohmann::json& instance = *instance_ptr;
     validate_instance(instance);
     CFG_ASSERT(instance.contains("__validation__"));
     CFG_ASSERT(instance.contains("__validation_msg__"));
     CFG_ASSERT(instance["__validation__"].is_boolean());
     CFG_ASSERT(instance["__validation_msg__"].is_string());
-    if ((std::string)(instance["linked_object"]) == linked_object &&
-        instance["__validation__"]) {
+    if (instance["__validation__"]) {
       instance["__validation__"] = false;
       instance["__validation_msg__"] =
           "Invalidated because other instance in the chain is invalid";
@@ -785,7 +822,9 @@ void ModelConfig_IO::assign_no_location_instance() {
 void ModelConfig_IO::assign_no_location_instance_child_location(
     const std::string& linked_object) {
   POST_INFO_MSG(2, "Assign location for child from instance-without-location");
-  for (auto& instance : m_instances) {
+  for (auto instance_ptr :
+       get_instances(m_instances_by_linked_object, linked_object)) {
+    nlohmann::json& instance = *instance_ptr;
     validate_instance(instance);
     // basic validate_locations should have been called
     // Object key must be there
@@ -794,8 +833,7 @@ void ModelConfig_IO::assign_no_location_instance_child_location(
     CFG_ASSERT(instance["__validation__"].is_boolean());
     CFG_ASSERT(instance["__validation_msg__"].is_string());
     if (instance["__validation__"] && instance["module"] != "BOOT_CLOCK" &&
-        instance["module"] != "FCLK_BUF" &&
-        instance["linked_object"] == linked_object) {
+        instance["module"] != "FCLK_BUF") {
       for (auto iter : instance["linked_objects"].items()) {
         nlohmann::json& object = iter.value();
         CFG_ASSERT(((std::string)(object["location"])).size() == 0);
@@ -1068,7 +1106,8 @@ void ModelConfig_IO::allocate_pll_fclk_routing(nlohmann::json& instance,
 */
 void ModelConfig_IO::set_clkbuf_config_attributes() {
   POST_INFO_MSG(0, "Set CLKBUF configuration attributes");
-  for (auto& instance : m_instances) {
+  for (auto instance_ptr : get_instances(m_instances_by_module, "CLK_BUF")) {
+    nlohmann::json& instance = *instance_ptr;
     validate_instance(instance);
     // basic validate_locations should have been called
     // Object key must be there
@@ -1076,7 +1115,7 @@ void ModelConfig_IO::set_clkbuf_config_attributes() {
     CFG_ASSERT(instance.contains("__validation_msg__"));
     CFG_ASSERT(instance["__validation__"].is_boolean());
     CFG_ASSERT(instance["__validation_msg__"].is_string());
-    if (instance["__validation__"] && instance["module"] == "CLK_BUF") {
+    if (instance["__validation__"]) {
       if (instance["parameters"].contains("ROUTE_TO_FABRIC_CLK")) {
         set_clkbuf_config_attribute(instance);
       }
@@ -1122,7 +1161,8 @@ void ModelConfig_IO::set_clkbuf_config_attribute(nlohmann::json& instance) {
 */
 void ModelConfig_IO::set_pll_config_attributes() {
   POST_INFO_MSG(0, "Set PLL remaining configuration attributes");
-  for (auto& instance : m_instances) {
+  for (auto instance_ptr : get_instances(m_instances_by_module, "PLL")) {
+    nlohmann::json& instance = *instance_ptr;
     validate_instance(instance);
     // basic validate_locations should have been called
     // Object key must be there
@@ -1130,7 +1170,7 @@ void ModelConfig_IO::set_pll_config_attributes() {
     CFG_ASSERT(instance.contains("__validation_msg__"));
     CFG_ASSERT(instance["__validation__"].is_boolean());
     CFG_ASSERT(instance["__validation_msg__"].is_string());
-    if (instance["__validation__"] && instance["module"] == "PLL") {
+    if (instance["__validation__"]) {
       set_pll_config_attribute(instance);
     }
   }
@@ -1208,10 +1248,17 @@ void ModelConfig_IO::allocate_pll() {
 
 /*
   Real function to determine the PLL resource
+  A PLL with single choice takes it. When none of the PLLs has single choice
+  (force), all of them follow the assignment of solve_pll()
   Unittest: All negative tests included
 */
 void ModelConfig_IO::allocate_pll(bool force) {
-  for (auto& instance : m_instances) {
+  std::map<std::string, int32_t> decisions;
+  if (force) {
+    decisions = solve_pll();
+  }
+  for (auto instance_ptr : get_instances(m_instances_by_module, "PLL")) {
+    nlohmann::json& instance = *instance_ptr;
     validate_instance(instance);
     // basic validate_locations should have been called
     // Object key must be there
@@ -1219,33 +1266,17 @@ void ModelConfig_IO::allocate_pll(bool force) {
     CFG_ASSERT(instance.contains("__validation_msg__"));
     CFG_ASSERT(instance["__validation__"].is_boolean());
     CFG_ASSERT(instance["__validation_msg__"].is_string());
-    if (instance["module"] == "PLL" && instance["__validation__"] &&
-        !instance.contains("__pll_resource__")) {
+    if (instance["__validation__"] && !instance.contains("__pll_resource__")) {
       std::string name = instance["name"];
       std::string src_location = get_location(name);
       PIN_INFO src_pin_info = get_pin_info(src_location);
       // Check if FCLK decided which PLL to use
-      std::vector<const ModelConfig_IO_MODEL*> fclks =
-          m_resource->get_used_resource(
-              "fclk", CFG_print("PLL:%s", src_location.c_str()));
+      uint64_t pin_resource = 0;
       std::string fclk_names = "";
-      for (auto& fclk : fclks) {
-        if (fclk_names.size()) {
-          fclk_names =
-              CFG_print("%s, %s", fclk_names.c_str(), fclk->m_name.c_str());
-        } else {
-          fclk_names = fclk->m_name;
-        }
-      }
+      uint64_t requested_pll_resource = get_pll_request(
+          src_location, src_pin_info, pin_resource, fclk_names);
       POST_DEBUG_MSG(1, "PLL %s (location:%s) uses FCLK '%s'", name.c_str(),
                      src_location.c_str(), fclk_names.c_str());
-      uint64_t requested_pll_resource = 0;
-      for (auto& fclk : fclks) {
-        uint32_t request_bank = fclk_use_pll_resource(fclk->m_name);
-        requested_pll_resource |= ((uint64_t)(1) << request_bank);
-      }
-      uint64_t pin_resource =
-          src_pin_info.type == "HVL" ? 1 : (src_pin_info.type == "HVR" ? 2 : 3);
       uint64_t pll_availability =
           m_resource->get_resource_availability_index("pll");
       POST_DEBUG_MSG(2,
@@ -1269,11 +1300,20 @@ void ModelConfig_IO::allocate_pll(bool force) {
         if (final_resource & ((uint64_t)(1) << i)) {
           one_count++;
           pll_index = i;
-          if (force) {
-            POST_DEBUG_MSG(3, "Force to use first found resource");
-            force = false;
-            break;
-          }
+        }
+      }
+      // When forced, follow the solver so that no PLL takes the resource
+      // that the others need, the PLL it cannot place will decide later
+      bool decide_later = false;
+      if (force && one_count) {
+        CFG_ASSERT(decisions.find(name) != decisions.end());
+        if (decisions[name] >= 0) {
+          pll_index = (uint32_t)(decisions[name]);
+          CFG_ASSERT(final_resource & ((uint64_t)(1) << pll_index));
+          one_count = 1;
+          POST_DEBUG_MSG(3, "Force to use resource decided by solver");
+        } else {
+          decide_later = true;
         }
       }
       if (one_count == 0) {
@@ -1281,7 +1321,7 @@ void ModelConfig_IO::allocate_pll(bool force) {
         instance["__validation__"] = false;
         instance["__validation_msg__"] = msg;
         POST_WARN_MSG(3, msg.c_str());
-      } else if (one_count == 1) {
+      } else if (one_count == 1 && !decide_later) {
         instance["__pll_resource__"] = std::to_string(pll_index);
         instance["__pll_enable__"] =
             m_pll_workaround.size() ? m_pll_workaround : "1";
@@ -1311,6 +1351,8 @@ void ModelConfig_IO::allocate_pll(bool force) {
           instance["__BANK__"] = std::to_string(src_pin_info.bank);
         }
         instance["__DIV__"] = std::to_string(divide_by_2);
+      } else if (decide_later) {
+        POST_DEBUG_MSG(3, "Solver cannot fit it with the others. Decide later");
       } else {
         msg =
             CFG_print("It is flexible to use more than one PLL. Decide later");
@@ -1320,17 +1362,81 @@ void ModelConfig_IO::allocate_pll(bool force) {
   }
 }
 
+/*
+  Get the PLL resource requested by the FCLK(s) that the PLL uses, and the
+  PLL resource that the source pin can reach
+*/
+uint64_t ModelConfig_IO::get_pll_request(const std::string& src_location,
+                                         const PIN_INFO& src_pin_info,
+                                         uint64_t& pin_resource,
+                                         std::string& fclk_names) {
+  std::vector<const ModelConfig_IO_MODEL*> fclks =
+      m_resource->get_used_resource("fclk",
+                                    CFG_print("PLL:%s", src_location.c_str()));
+  fclk_names = "";
+  for (auto& fclk : fclks) {
+    if (fclk_names.size()) {
+      fclk_names =
+          CFG_print("%s, %s", fclk_names.c_str(), fclk->m_name.c_str());
+    } else {
+      fclk_names = fclk->m_name;
+    }
+  }
+  uint64_t requested_pll_resource = 0;
+  for (auto& fclk : fclks) {
+    uint32_t request_bank = fclk_use_pll_resource(fclk->m_name);
+    requested_pll_resource |= ((uint64_t)(1) << request_bank);
+  }
+  pin_resource =
+      src_pin_info.type == "HVL" ? 1 : (src_pin_info.type == "HVR" ? 2 : 3);
+  return requested_pll_resource;
+}
+
+/*
+  Decide the PLL resource of every undecided PLL at once, maximizing the
+  number of PLL that can be placed with the current availability
+  Return PLL name to resource index, -1 if it cannot be placed
+*/
+std::map<std::string, int32_t> ModelConfig_IO::solve_pll() {
+  std::vector<std::string> names;
+  std::vector<uint64_t> candidates;
+  for (auto instance_ptr : get_instances(m_instances_by_module, "PLL")) {
+    nlohmann::json& instance = *instance_ptr;
+    if (instance["__validation__"] && !instance.contains("__pll_resource__")) {
+      std::string name = instance["name"];
+      std::string src_location = get_location(name);
+      uint64_t pin_resource = 0;
+      std::string fclk_names = "";
+      uint64_t requested_pll_resource = get_pll_request(
+          src_location, get_pin_info(src_location), pin_resource, fclk_names);
+      names.push_back(name);
+      candidates.push_back(requested_pll_resource
+                               ? (pin_resource & requested_pll_resource)
+                               : pin_resource);
+    }
+  }
+  std::vector<int32_t> decisions;
+  solve_resource(candidates,
+                 m_resource->get_resource_availability_index("pll"),
+                 decisions);
+  std::map<std::string, int32_t> results;
+  for (size_t i = 0; i < names.size(); i++) {
+    results[names[i]] = decisions[i];
+  }
+  return results;
+}
+
 /*
   Determine the FCLK resource ultilization by PLL
 */
 uint32_t ModelConfig_IO::undecided_pll() {
   uint32_t count = 0;
-  for (auto& instance : m_instances) {
+  for (auto instance_ptr : get_instances(m_instances_by_module, "PLL")) {
+    nlohmann::json& instance = *instance_ptr;
     validate_instance(instance);
     CFG_ASSERT(instance.contains("__validation__"));
     CFG_ASSERT(instance["__validation__"].is_boolean());
-    if (instance["module"] == "PLL" && instance["__validation__"] &&
-        !instance.contains("__pll_resource__")) {
+    if (instance["__validation__"] && !instance.contains("__pll_resource__")) {
       count++;
     }
   }
@@ -1648,30 +1754,29 @@ void ModelConfig_IO::assign_json_object(nlohmann::json& object,
 std::string ModelConfig_IO::get_location(const std::string& name,
                                          std::string* module) {
   std::string location = "";
-  for (auto& instance : m_instances) {
+  for (auto instance_ptr : get_instances(m_instances_by_name, name)) {
+    nlohmann::json& instance = *instance_ptr;
     validate_instance(instance);
     CFG_ASSERT(instance.contains("__validation__"));
     CFG_ASSERT(instance.contains("__validation_msg__"));
     CFG_ASSERT(instance["__validation__"].is_boolean());
     CFG_ASSERT(instance["__validation_msg__"].is_string());
     if ((bool)(instance["__validation__"])) {
-      if (instance["name"] == name) {
-        for (auto iter : instance["linked_objects"].items()) {
-          nlohmann::json& port = iter.value();
-          location = (std::string)(port["location"]);
-          if (location.find("__SKIP_LOCATION_CHECK__") == 0) {
-            location = location.substr(23);
-            if (location.find(":") == 0) {
-              location = location.substr(1);
-            }
-          }
-          if (module != nullptr) {
-            (*module) = (std::string)(instance["module"]);
+      for (auto iter : instance["linked_objects"].items()) {
+        nlohmann::json& port = iter.value();
+        location = (std::string)(port["location"]);
+        if (location.find("__SKIP_LOCATION_CHECK__") == 0) {
+          location = location.substr(23);
+          if (location.find(":") == 0) {
+            location = location.substr(1);
           }
-          break;
+        }
+        if (module != nullptr) {
+          (*module) = (std::string)(instance["module"]);
         }
         break;
       }
+      break;
     }
   }
   return location;
@@ -1872,10 +1977,100 @@ std::string ModelConfig_IO::pll_routing_failure_msg(
   return msg;
 }
 
+/*
+  Getting pin information of every placed instance, and FCLK PLL resource
+  if there is PLL, from Python in one call each. Names that Python cannot
+  resolve are not memoized, get_pin_info() will query and fail on them
+*/
+void ModelConfig_IO::prefetch_pin_info() {
+  std::vector<std::string> pins;
+  std::set<std::string> unique_pins;
+  bool has_pll = false;
+  for (auto& record : m_instance_records) {
+    nlohmann::json& instance = *record.record;
+    CFG_ASSERT(instance.contains("__validation__"));
+    if (instance["__validation__"]) {
+      std::string location = get_location(record.name);
+      if (location.size() && unique_pins.insert(location).second) {
+        pins.push_back(location);
+      }
+      has_pll = has_pll || record.module == "PLL";
+    }
+  }
+  std::vector<std::string> results = run_python_batch("get_pin_info", pins);
+  for (size_t i = 0; i < pins.size(); i++) {
+    std::vector<std::string> values = CFG_split_string(results[i], ";");
+    if (values.size() == 6) {
+      m_pin_infos.emplace(
+          pins[i],
+          PIN_INFO(values[0], (uint32_t)(CFG_convert_string_to_u64(values[1])),
+                   values[2] == "True",
+                   (uint32_t)(CFG_convert_string_to_u64(values[3])),
+                   (uint32_t)(CFG_convert_string_to_u64(values[4])),
+                   (uint32_t)(CFG_convert_string_to_u64(values[5]))));
+    }
+  }
+  if (has_pll) {
+    std::vector<std::string> fclks;
+    if (m_resource->m_resources.find("fclk") != m_resource->m_resources.end()) {
+      for (auto& fclk : *m_resource->m_resources.at("fclk")) {
+        fclks.push_back(fclk->m_name);
+      }
+    }
+    results = run_python_batch("fclk_use_pll_resource", fclks);
+    for (size_t i = 0; i < fclks.size(); i++) {
+      if (results[i].size()) {
+        m_fclk_pll_resources[fclks[i]] =
+            (uint32_t)(CFG_convert_string_to_u64(results[i]));
+      }
+    }
+  }
+}
+
+/*
+  Call a function of the config module for each name in a single Python
+  run. Each result is returned as its values joined by ';', or empty if the
+  function raised
+*/
+std::vector<std::string> ModelConfig_IO::run_python_batch(
+    const std::string& function, const std::vector<std::string>& names) {
+  CFG_ASSERT(m_python != nullptr);
+  if (names.empty()) {
+    return {};
+  }
+  std::string list = "";
+  for (auto& name : names) {
+    CFG_ASSERT(name.find_first_of("'\\\n") == std::string::npos);
+    list = CFG_print("%s%s'%s'", list.c_str(), list.size() ? ", " : "",
+                     name.c_str());
+  }
+  m_python->run({"import config",
+                 "def __batch__(function, names) :\n"
+                 "  results = []\n"
+                 "  for name in names :\n"
+                 "    try :\n"
+                 "      values = function(name)\n"
+                 "      results.append(';'.join([str(v) for v in values]))\n"
+                 "    except Exception :\n"
+                 "      results.append('')\n"
+                 "  return results\n\n",
+                 CFG_print("__batch_results__ = __batch__(config.%s, [%s])",
+                           function.c_str(), list.c_str())},
+                {"__batch_results__"});
+  std::vector<std::string> results =
+      m_python->result_strs("__batch_results__");
+  CFG_ASSERT(results.size() == names.size());
+  return results;
+}
+
 /*
   Getting pin information from Python
 */
 PIN_INFO ModelConfig_IO::get_pin_info(const std::string& name) {
+  auto iter = m_pin_infos.find(name);
+  if (iter != m_pin_infos.end()) {
+    return iter->second;
+  }
   CFG_ASSERT(m_python != nullptr);
   std::vector<CFG_Python_OBJ> results =
       m_python->run_file("config", "get_pin_info",
@@ -1887,21 +2082,28 @@ PIN_INFO ModelConfig_IO::get_pin_info(const std::string& name) {
   CFG_ASSERT(results[3].type == CFG_Python_OBJ::TYPE::INT);
   CFG_ASSERT(results[4].type == CFG_Python_OBJ::TYPE::INT);
   CFG_ASSERT(results[5].type == CFG_Python_OBJ::TYPE::INT);
-  return PIN_INFO(results[0].get_str(), results[1].get_u32(),
-                  results[2].get_bool(), results[3].get_u32(),
-                  results[4].get_u32(), results[5].get_u32());
+  PIN_INFO info(results[0].get_str(), results[1].get_u32(),
+                results[2].get_bool(), results[3].get_u32(),
+                results[4].get_u32(), results[5].get_u32());
+  m_pin_infos.emplace(name, info);
+  return info;
 }
 
 /*
   Getting FCLK PLL resource from Python
 */
 uint32_t ModelConfig_IO::fclk_use_pll_resource(const std::string& name) {
+  auto iter = m_fclk_pll_resources.find(name);
+  if (iter != m_fclk_pll_resources.end()) {
+    return iter->second;
+  }
   CFG_ASSERT(m_python != nullptr);
   std::vector<CFG_Python_OBJ> results =
       m_python->run_file("config", "fclk_use_pll_resource",
                          std::vector<CFG_Python_OBJ>({CFG_Python_OBJ(name)}));
   CFG_ASSERT(results.size() == 1);
   CFG_ASSERT(results[0].type == CFG_Python_OBJ::TYPE::INT);
+  m_fclk_pll_resources[name] = results[0].get_u32();
   return results[0].get_u32();
 }
 
@@ -2366,6 +2568,61 @@ bool ModelConfig_IO::allocate_resource(
   return status;
 }
 
+/*
+  Entry function of the backtracking resource solver
+  Each instance picks one resource of its candidate bitmask, at most one
+  instance per resource. Find the assignment that places the most instances,
+  the first one in search order (lowest resource first) when there is a tie
+  Return the number of instances placed, decision is -1 for the others
+*/
+uint32_t ModelConfig_IO::solve_resource(const std::vector<uint64_t>& candidates,
+                                        uint64_t availability,
+                                        std::vector<int32_t>& decisions) {
+  std::vector<int32_t> trial(candidates.size(), -1);
+  uint32_t best_count = 0;
+  decisions = trial;
+  solve_resource(candidates, 0, availability, 0, trial, best_count,
+                 decisions);
+  return best_count;
+}
+
+/*
+  Real function of the backtracking resource solver
+  The availability bitmask is passed by value, so backtracking is free
+*/
+void ModelConfig_IO::solve_resource(const std::vector<uint64_t>& candidates,
+                                    size_t index, uint64_t availability,
+                                    uint32_t count, std::vector<int32_t>& trial,
+                                    uint32_t& best_count,
+                                    std::vector<int32_t>& decisions) {
+  if (count > best_count) {
+    best_count = count;
+    decisions = trial;
+  }
+  // Stop when all remaining instances cannot beat the best found so far
+  if (index == candidates.size() ||
+      count + (uint32_t)(candidates.size() - index) <= best_count) {
+    return;
+  }
+  uint64_t possible = candidates[index] & availability;
+  while (possible) {
+    uint64_t bit = possible & (~possible + 1);
+    possible &= ~bit;
+    trial[index] = 0;
+    while ((bit >> trial[index]) != 1) {
+      trial[index]++;
+    }
+    solve_resource(candidates, index + 1, availability & ~bit, count + 1,
+                   trial, best_count, decisions);
+    if (best_count == (uint32_t)(candidates.size())) {
+      return;
+    }
+  }
+  trial[index] = -1;
+  solve_resource(candidates, index + 1, availability, count, trial,
+                 best_count, decisions);
+}
+
 /*
   Move the resource if it is flexible and give opportunity to those that less
   flexible
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ModelConfig_IO_resource.h"
@@ -73,6 +74,26 @@ struct MODEL_RESOURCE_INSTANCE {
 typedef std::map<std::string, std::vector<MODEL_RESOURCE_INSTANCE*>>
     MODEL_RESOURCES;
 
+/*
+  Typed view of a netlist instance. The identity fields never change after
+  validation, so they are read once from the JSON record, which stays the
+  store of the mutable fields and of the output
+*/
+struct MODEL_IO_INSTANCE {
+  MODEL_IO_INSTANCE(nlohmann::json* r)
+      : record(r),
+        module((*r)["module"]),
+        name((*r)["name"]),
+        linked_object((*r)["linked_object"]) {}
+  nlohmann::json* record = nullptr;
+  const std::string module = "";
+  const std::string name = "";
+  const std::string linked_object = "";
+};
+
+typedef std::unordered_map<std::string, std::vector<size_t>>
+    MODEL_IO_INSTANCE_INDEX;
+
 namespace FOEDAG {
 
 class ModelConfig_IO {
@@ -87,6 +108,9 @@ class ModelConfig_IO {
   void read_resources();
   void validate_instances(nlohmann::json& instances);
   void validate_instance(nlohmann::json& instance, bool is_final = false);
+  void index_instances();
+  std::vector<nlohmann::json*> get_instances(
+      const MODEL_IO_INSTANCE_INDEX& index, const std::string& key);
   void merge_property_instances(nlohmann::json property_instances);
   void merge_property_instance(nlohmann::json& netlist_instance,
                                nlohmann::json property_instances);
@@ -111,6 +135,10 @@ class ModelConfig_IO {
   void set_clkbuf_config_attribute(nlohmann::json& instance);
   void allocate_pll();
   void allocate_pll(bool force);
+  uint64_t get_pll_request(const std::string& src_location,
+                           const PIN_INFO& src_pin_info,
+                           uint64_t& pin_resource, std::string& fclk_names);
+  std::map<std::string, int32_t> solve_pll();
   void set_pll_config_attributes();
   void set_pll_config_attribute(nlohmann::json& instance);
   void set_fclk_config_attribute(nlohmann::json& instance);
@@ -178,6 +206,9 @@ class ModelConfig_IO {
                                       const std::string& gearbox,
                                       const std::string& gearbox_module,
                                       const std::string& gearbox_location);
+  void prefetch_pin_info();
+  std::vector<std::string> run_python_batch(
+      const std::string& function, const std::vector<std::string>& names);
   PIN_INFO get_pin_info(const std::string& name);
   uint32_t fclk_use_pll_resource(const std::string& name);
   /*
@@ -210,19 +241,33 @@ class ModelConfig_IO {
   static bool allocate_resource(
       std::vector<MODEL_RESOURCE_INSTANCE*>& instances,
       MODEL_RESOURCE_INSTANCE*& new_instance, bool print_msg);
+  static uint32_t solve_resource(const std::vector<uint64_t>& candidates,
+                                 uint64_t availability,
+                                 std::vector<int32_t>& decisions);
 
  private:
   static bool shift_instance_resource(
       uint32_t try_resource, uint32_t& allocated_resource_track,
       std::vector<MODEL_RESOURCE_INSTANCE*>& instances, bool print_msg);
+  static void solve_resource(const std::vector<uint64_t>& candidates,
+                             size_t index, uint64_t availability,
+                             uint32_t count, std::vector<int32_t>& trial,
+                             uint32_t& best_count,
+                             std::vector<int32_t>& decisions);
 
  protected:
   CFG_Python_MGR* m_python = nullptr;
   std::string m_pll_workaround = "";
   nlohmann::json m_instances;
+  std::vector<MODEL_IO_INSTANCE> m_instance_records;
+  MODEL_IO_INSTANCE_INDEX m_instances_by_name;
+  MODEL_IO_INSTANCE_INDEX m_instances_by_linked_object;
+  MODEL_IO_INSTANCE_INDEX m_instances_by_module;
   nlohmann::json m_config_mapping;
   std::map<std::string, std::string> m_global_args;
   ModelConfig_IO_RESOURCE* m_resource = nullptr;
+  std::map<std::string, PIN_INFO> m_pin_infos;
+  std::map<std::string, uint32_t> m_fclk_pll_resources;
   std::vector<ModelConfig_IO_MSG*> m_messages;
 };
 
@@ -27,12 +27,13 @@ ModelConfig_IO_MODEL::ModelConfig_IO_MODEL(const std::string& name,
                                            const std::string& ric_name,
                                            const std::string& type,
                                            const std::string& subtype,
-                                           uint32_t bank)
+                                           uint32_t bank, uint32_t index)
     : m_name(name),
       m_ric_name(ric_name),
       m_type(type),
       m_subtype(subtype),
-      m_bank(bank) {}
+      m_bank(bank),
+      m_index(index) {}
 
 void ModelConfig_IO_MODEL::assign(const std::string* const_ptr,
                                   const std::string& value) const {
@@ -40,14 +41,6 @@ void ModelConfig_IO_MODEL::assign(const std::string* const_ptr,
   (*ptr) = value;
 }
 
-void ModelConfig_IO_MODEL::backup() const {
-  assign(&m_backup_instantiator, m_instantiator);
-}
-
-void ModelConfig_IO_MODEL::restore() const {
-  assign(&m_instantiator, m_backup_instantiator);
-}
-
 void ModelConfig_IO_MODEL::set_instantiator(
     const std::string& instantiator) const {
   assign(&m_instantiator, instantiator);
@@ -67,6 +60,7 @@ ModelConfig_IO_RESOURCE::~ModelConfig_IO_RESOURCE() {
 
 /*
   Add resource, retrieving from the config map
+  Availability is tracked as a bitmask, hence up to 64 models per resource
 */
 void ModelConfig_IO_RESOURCE::add_resource(const std::string& resource,
                                            const std::string& name,
@@ -76,9 +70,17 @@ void ModelConfig_IO_RESOURCE::add_resource(const std::string& resource,
                                            uint32_t bank) {
   if (m_resources.find(resource) == m_resources.end()) {
     m_resources[resource] = new std::vector<const ModelConfig_IO_MODEL*>;
+    m_availabilities[resource] = 0;
   }
-  m_resources[resource]->push_back(
-      new ModelConfig_IO_MODEL(name, ric_name, type, subtype, bank));
+  std::vector<const ModelConfig_IO_MODEL*>* models = m_resources[resource];
+  uint32_t index = (uint32_t)(models->size());
+  CFG_ASSERT_MSG(index < 64, "Resource %s has more than 64 models",
+                 resource.c_str());
+  models->push_back(
+      new ModelConfig_IO_MODEL(name, ric_name, type, subtype, bank, index));
+  m_availabilities[resource] |= ((uint64_t)(1) << index);
+  // Lookup by name finds the first model of that name
+  m_indexes[resource].emplace(name, index);
 }
 
 /*
@@ -95,16 +97,8 @@ size_t ModelConfig_IO_RESOURCE::get_resource_count(
 */
 uint64_t ModelConfig_IO_RESOURCE::get_resource_availability_index(
     const std::string& resource) {
-  CFG_ASSERT(m_resources.find(resource) != m_resources.end());
-  uint64_t availability = 0;
-  uint64_t index = 0;
-  for (auto& r : *m_resources[resource]) {
-    if (r->m_instantiator.size() == 0) {
-      availability |= ((uint64_t)(1) << index);
-    }
-    index++;
-  }
-  return availability;
+  CFG_ASSERT(m_availabilities.find(resource) != m_availabilities.end());
+  return m_availabilities[resource];
 }
 
 /*
@@ -132,78 +126,93 @@ std::vector<const ModelConfig_IO_MODEL*>
 ModelConfig_IO_RESOURCE::get_used_resource(const std::string& resource,
                                            const std::string& instantiator) {
   CFG_ASSERT(m_resources.find(resource) != m_resources.end());
-  return get_used_resource(m_resources[resource], instantiator);
+  CFG_ASSERT(instantiator.size());
+  std::vector<const ModelConfig_IO_MODEL*>* models = m_resources[resource];
+  uint64_t used = 0;
+  if (instantiator == "__ALL__") {
+    used = ~m_availabilities[resource];
+  } else {
+    std::map<std::string, uint64_t>& usages = m_usages[resource];
+    if (usages.find(instantiator) != usages.end()) {
+      used = usages[instantiator];
+    }
+  }
+  std::vector<const ModelConfig_IO_MODEL*> resources;
+  for (size_t i = 0; i < models->size(); i++) {
+    if (used & ((uint64_t)(1) << i)) {
+      resources.push_back((*models)[i]);
+    }
+  }
+  return resources;
 }
 
 /*
   Try to use the resource
 */
-bool ModelConfig_IO_RESOURCE::use_resource(
-    std::vector<const ModelConfig_IO_MODEL*>* models,
-    const std::string& instantiator, const std::string& name,
-    const std::string& type) {
+bool ModelConfig_IO_RESOURCE::use_resource(const std::string& resource,
+                                           const std::string& instantiator,
+                                           const std::string& name) {
+  CFG_ASSERT(m_resources.find(resource) != m_resources.end());
   CFG_ASSERT(instantiator.size());
   CFG_ASSERT(name.size());
-  m_msg = "";
-  bool status = false;
-  for (auto& model : *models) {
-    if (model->m_name == name) {
-      if (model->m_instantiator.size()) {
-        if (model->m_instantiator == instantiator) {
-          m_msg = CFG_print("Use %s: %s", type.c_str(), model->m_name.c_str());
-          status = true;
-        } else {
-          m_msg = CFG_print("Attemp to use %s: %s, but it had been used by %s",
-                            type.c_str(), model->m_name.c_str(),
-                            model->m_instantiator.c_str());
-        }
-      } else {
-        model->set_instantiator(instantiator);
-        m_msg = CFG_print("Use %s: %s", type.c_str(), model->m_name.c_str());
-        status = true;
-      }
-      break;
-    }
-  }
-  if (!status && m_msg.size() == 0) {
+  std::string type = resource;
+  type = CFG_string_toupper(type);
+  std::map<std::string, uint32_t>& indexes = m_indexes[resource];
+  if (indexes.find(name) == indexes.end()) {
     m_msg =
         CFG_print("Cannot find %s resource: %s", type.c_str(), name.c_str());
+    return false;
+  }
+  const ModelConfig_IO_MODEL* model = (*m_resources[resource])[indexes[name]];
+  if (model->m_instantiator.size() && model->m_instantiator != instantiator) {
+    m_msg = CFG_print("Attemp to use %s: %s, but it had been used by %s",
+                      type.c_str(), model->m_name.c_str(),
+                      model->m_instantiator.c_str());
+    return false;
   }
-  return status;
+  if (model->m_instantiator.empty()) {
+    set_instantiator(resource, model, instantiator);
+    m_journal.push_back(ModelConfig_IO_JOURNAL(resource, model));
+  }
+  m_msg = CFG_print("Use %s: %s", type.c_str(), model->m_name.c_str());
+  return true;
 }
 
 /*
-  Entry function to try to use the resource
+  Fail-safe mechanism
+  Mark a checkpoint: restore() releases what had been used since then
 */
-bool ModelConfig_IO_RESOURCE::use_resource(const std::string& resource,
-                                           const std::string& instantiator,
-                                           const std::string& name) {
-  CFG_ASSERT(m_resources.find(resource) != m_resources.end());
-  std::string r = resource;
-  return use_resource(m_resources[resource], instantiator, name,
-                      CFG_string_toupper(r));
-}
+void ModelConfig_IO_RESOURCE::backup() { m_journal.clear(); }
 
 /*
   Fail-safe mechanism
+  Undo the journal in reverse order instead of copying every model
 */
-void ModelConfig_IO_RESOURCE::backup() {
-  for (auto& iter : m_resources) {
-    for (auto& item : *(iter.second)) {
-      item->backup();
-    }
+void ModelConfig_IO_RESOURCE::restore() {
+  while (m_journal.size()) {
+    ModelConfig_IO_JOURNAL& journal = m_journal.back();
+    set_instantiator(journal.resource, journal.model, "");
+    m_journal.pop_back();
   }
 }
 
 /*
-  Fail-safe mechanism
+  Change the instantiator of a model and keep the bitmasks in sync
 */
-void ModelConfig_IO_RESOURCE::restore() {
-  for (auto& iter : m_resources) {
-    for (auto& item : *(iter.second)) {
-      item->restore();
-    }
+void ModelConfig_IO_RESOURCE::set_instantiator(
+    const std::string& resource, const ModelConfig_IO_MODEL* model,
+    const std::string& instantiator) {
+  uint64_t mask = (uint64_t)(1) << model->m_index;
+  std::map<std::string, uint64_t>& usages = m_usages[resource];
+  if (model->m_instantiator.size()) {
+    usages[model->m_instantiator] &= ~mask;
+    m_availabilities[resource] |= mask;
+  }
+  if (instantiator.size()) {
+    usages[instantiator] |= mask;
+    m_availabilities[resource] &= ~mask;
   }
+  model->set_instantiator(instantiator);
 }
 
 }  // namespace FOEDAG
@@ -46,18 +46,26 @@ struct PIN_INFO {
 struct ModelConfig_IO_MODEL {
   ModelConfig_IO_MODEL(const std::string& name, const std::string& ric_name,
                        const std::string& type, const std::string& subtype,
-                       uint32_t bank);
+                       uint32_t bank, uint32_t index);
   void assign(const std::string* const_ptr, const std::string& value) const;
-  void backup() const;
-  void restore() const;
   void set_instantiator(const std::string& instantiator) const;
   const std::string m_name = "";
   const std::string m_ric_name = "";
   const std::string m_type = "";
   const std::string m_subtype = "";
   const uint32_t m_bank = 0;
+  const uint32_t m_index = 0;
   std::string m_instantiator = "";
-  std::string m_backup_instantiator = "";
+};
+
+/*
+  Undo record of one resource taken since the last backup()
+*/
+struct ModelConfig_IO_JOURNAL {
+  ModelConfig_IO_JOURNAL(const std::string& r, const ModelConfig_IO_MODEL* m)
+      : resource(r), model(m) {}
+  const std::string resource = "";
+  const ModelConfig_IO_MODEL* model = nullptr;
 };
 
 struct ModelConfig_IO_RESOURCE {
@@ -76,15 +84,21 @@ struct ModelConfig_IO_RESOURCE {
   std::vector<const ModelConfig_IO_MODEL*> get_used_resource(
       const std::string& resource, const std::string& instantiator);
   // Try to use the resource
-  bool use_resource(std::vector<const ModelConfig_IO_MODEL*>* models,
-                    const std::string& instantiator, const std::string& name,
-                    const std::string& type);
   bool use_resource(const std::string& resource,
                     const std::string& instantiator, const std::string& name);
   // Fail-safe mechanism
   void backup();
   void restore();
+  void set_instantiator(const std::string& resource,
+                        const ModelConfig_IO_MODEL* model,
+                        const std::string& instantiator);
   std::map<std::string, std::vector<const ModelConfig_IO_MODEL*>*> m_resources;
+  // Per resource: bit N set when model N is free, model index by name and
+  // the models used by each instantiator
+  std::map<std::string, uint64_t> m_availabilities;
+  std::map<std::string, std::map<std::string, uint32_t>> m_indexes;
+  std::map<std::string, std::map<std::string, uint64_t>> m_usages;
+  std::vector<ModelConfig_IO_JOURNAL> m_journal;
   std::string m_msg = "";
 };
 
@@ -21,9 +21,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Programmer.h"
 
-#include <numeric>  // for std::accumulate
-#include <sstream>  // for std::stringstream
-#include <thread>   // for std::this_thread::sleep_for
+#include <algorithm>  // for std::any_of
+#include <numeric>    // for std::accumulate
+#include <sstream>    // for std::stringstream
+#include <thread>     // for std::this_thread::sleep_for
 
 #include "CFGCommon/CFGArg_auto.h"
 #include "CFGCommon/CFGCommon.h"
@@ -64,6 +65,133 @@ std::map<int, std::string> ErrorMessages = {
     {OpenOCDExecutableNotFound, "Openocd executable not found"},
     {InvalidFlashSize, "Invalid flash size"}};
 
+// Expand "programmer batch" into one job per bitstream. An option given once
+// applies to every job, otherwise it takes one value per bitstream. The cable
+// name and device index are resolved by the caller.
+static bool GetBatchJobs(const CFGArg_PROGRAMMER_BATCH* batch_arg,
+                         std::vector<ProgrammingJob>& jobs) {
+  const size_t count = batch_arg->m_args.size();
+  const std::vector<std::pair<std::string, size_t>> sizes = {
+      {"cable", batch_arg->cable.size()},
+      {"index", batch_arg->index.size()},
+      {"type", batch_arg->type.size()},
+      {"operations", batch_arg->operations.size()}};
+  for (auto& [option, size] : sizes) {
+    if (size != 1 && size != count) {
+      CFG_POST_ERR("Option -%s expects 1 or %d values, but %d are given",
+                   option.c_str(), (int)count, (int)size);
+      return false;
+    }
+  }
+  for (size_t i = 0; i < count; i++) {
+    auto value = [i](const auto& values) {
+      return values[values.size() == 1 ? 0 : i];
+    };
+    ProgrammingJob job;
+    job.cable.name = value(batch_arg->cable);
+    job.device.index = static_cast<uint32_t>(value(batch_arg->index));
+    job.bitfile = batch_arg->m_args[i];
+    std::string type = value(batch_arg->type);
+    if (type == "fpga_config") {
+      job.type = ProgramType::Fpga;
+    } else if (type == "otp") {
+      job.type = ProgramType::Otp;
+    } else if (type == "flash") {
+      job.type = ProgramType::Flash;
+      job.modes = static_cast<ProgramFlashOperation>(0);
+      auto operations = parseOperationString(value(batch_arg->operations));
+      for (auto& operation : operations) {
+        if (operation == "erase") {
+          job.modes = job.modes | ProgramFlashOperation::Erase;
+        } else if (operation == "blankcheck") {
+          job.modes = job.modes | ProgramFlashOperation::BlankCheck;
+        } else if (operation == "program") {
+          job.modes = job.modes | ProgramFlashOperation::Program;
+        } else if (operation == "verify") {
+          job.modes = job.modes | ProgramFlashOperation::Verify;
+        } else {
+          CFG_POST_ERR("Invalid flash operation '%s'", operation.c_str());
+          return false;
+        }
+      }
+    } else {
+      CFG_POST_ERR(
+          "Invalid job type '%s', it must be fpga_config, otp or flash",
+          type.c_str());
+      return false;
+    }
+    jobs.push_back(job);
+  }
+  bool otp = std::any_of(jobs.begin(), jobs.end(), [](const auto& job) {
+    return job.type == ProgramType::Otp;
+  });
+  if (otp && batch_arg->confirm == false) {
+    CFG_post_msg(
+        "WARNING: The OTP programming is not reversable. Please use -y to "
+        "indicate your consensus to proceed.\n\n",
+        "", false);
+    return false;
+  }
+  return true;
+}
+
+// Run the batch jobs, all the console and GUI updates of the workers are
+// posted from this thread. The Tcl output is the status of each job.
+static void RunBatchJobs(CFGCommon_ARG* cmdarg,
+                         std::vector<ProgrammingJob>& jobs,
+                         const ProgrammingJobRunner& runner) {
+  std::atomic<bool> stop = false;
+  std::vector<bool> started(jobs.size(), false);
+  auto gui = Gui::GuiInterface();
+  ProgrammingJobCallbacks callbacks;
+  callbacks.started = [&](size_t index) {
+    const ProgrammingJob& job = jobs[index];
+    started[index] = true;
+    if (!gui) return;
+    if (job.type == ProgramType::Otp) {
+      gui->ProgramOtp(job.cable, job.device, job.bitfile);
+    } else if (job.type == ProgramType::Flash) {
+      gui->Flash(job.cable, job.device, job.bitfile);
+    } else {
+      gui->ProgramFpga(job.cable, job.device, job.bitfile);
+    }
+  };
+  callbacks.progress = [&](size_t index, const std::string& progress) {
+    const ProgrammingJob& job = jobs[index];
+    if (gui) gui->Progress(job.cable, job.device, progress);
+    // One line per update, the devices progress at the same time
+    CFG_POST_MSG("%s Progress....%s%%",
+                 buildCableDeviceAliasName(job.cable, job.device).c_str(),
+                 progress.c_str());
+  };
+  callbacks.finished = [&](size_t index, int status) {
+    const ProgrammingJob& job = jobs[index];
+    if (gui) gui->Status(job.cable, job.device, status);
+    std::string alias = buildCableDeviceAliasName(job.cable, job.device);
+    if (status != ProgrammerErrorCode::NoError) {
+      CFG_POST_ERR("Failed to program %s with '%s'. Error code: %d. %s",
+                   alias.c_str(), job.bitfile.c_str(), status,
+                   GetErrorMessage(status).c_str());
+    } else {
+      CFG_POST_MSG("Programmed %s with '%s' successfully.", alias.c_str(),
+                   job.bitfile.c_str());
+    }
+  };
+  int status = RunProgrammingJobs(jobs, gui ? gui->Stop() : stop, runner,
+                                  callbacks);
+  for (size_t i = 0; i < jobs.size(); i++) {
+    if (!started[i]) {
+      CFG_POST_WARNING(
+          "Skipped %s, programming was stopped",
+          buildCableDeviceAliasName(jobs[i].cable, jobs[i].device).c_str());
+    }
+    cmdarg->tclOutput += (i ? " " : "") + std::to_string(jobs[i].status);
+  }
+  if (status != ProgrammerErrorCode::NoError) {
+    cmdarg->tclStatus = TCL_ERROR;
+  }
+}
+
 void programmer_entry(CFGCommon_ARG* cmdarg) {
   auto arg = std::static_pointer_cast<CFGArg_PROGRAMMER>(cmdarg->arg);
   if (arg == nullptr) return;
@@ -71,6 +199,9 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
   if (arg->m_help) {
     return;
   }
+  // A stop request only applies to the command it was made for, the flag is
+  // not reset when each device of a batch starts
+  if (Gui::GuiInterface()) Gui::GuiInterface()->Stop() = false;
   // setup hardware manager and its depencencies
   OpenocdAdapter openOcd{cmdarg->toolPath.string()};
   HardwareManager hardware_manager{&openOcd};
@@ -117,7 +248,7 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
       for (int i = 10; i <= 100; i += 10) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         if (Gui::GuiInterface())
-          Gui::GuiInterface()->Progress(std::to_string(i));
+          Gui::GuiInterface()->Progress(cable1, device, std::to_string(i));
         if (Gui::GuiInterface() && Gui::GuiInterface()->Stop()) {
           status = TCL_ERROR;
           break;
@@ -139,7 +270,7 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
       for (int i = 10; i <= 100; i += 10) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         if (Gui::GuiInterface())
-          Gui::GuiInterface()->Progress(std::to_string(i));
+          Gui::GuiInterface()->Progress(cable1, device, std::to_string(i));
         if (Gui::GuiInterface() && Gui::GuiInterface()->Stop()) {
           status = TCL_ERROR;
           break;
@@ -163,7 +294,7 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
         for (int i = 10; i <= 100; i += 10) {
           std::this_thread::sleep_for(std::chrono::milliseconds(20));
           if (Gui::GuiInterface())
-            Gui::GuiInterface()->Progress(std::to_string(i));
+            Gui::GuiInterface()->Progress(cable1, device, std::to_string(i));
           CFG_POST_MSG("<test> erase flash - %d %% ", i);
         }
       }
@@ -177,7 +308,7 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
         for (int i = 10; i <= 100; i += 10) {
           std::this_thread::sleep_for(std::chrono::milliseconds(20));
           if (Gui::GuiInterface())
-            Gui::GuiInterface()->Progress(std::to_string(i));
+            Gui::GuiInterface()->Progress(cable1, device, std::to_string(i));
           if (Gui::GuiInterface() && Gui::GuiInterface()->Stop()) {
             status = TCL_ERROR;
             break;
@@ -194,6 +325,36 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
           CFG_POST_MSG("<test> flash verified- %d %% ", i);
         }
       }
+    } else if (subCmd == "batch") {
+      auto batch_arg =
+          static_cast<const CFGArg_PROGRAMMER_BATCH*>(arg->get_sub_arg());
+      std::vector<ProgrammingJob> jobs{};
+      if (!GetBatchJobs(batch_arg, jobs)) {
+        cmdarg->tclStatus = TCL_ERROR;
+        return;
+      }
+      for (auto& job : jobs) {
+        Cable cable = (job.cable.name == cable2.name || job.cable.name == "2")
+                          ? cable2
+                          : cable1;
+        job.device = job.device.index == 1 ? device1 : device2;
+        job.device.cable = job.cable = cable;
+      }
+      RunBatchJobs(cmdarg, jobs,
+                   [](size_t, std::atomic<bool>& stop,
+                      ProgressCallback progress) {
+                     int status = ProgrammerErrorCode::NoError;
+                     for (int i = 10; i <= 100 && status == 0; i += 10) {
+                       std::this_thread::sleep_for(
+                           std::chrono::milliseconds(100));
+                       if (stop) {
+                         status = ProgrammerErrorCode::GeneralCmdError;
+                       } else {
+                         progress(std::to_string(i));
+                       }
+                     }
+                     return status;
+                   });
     } else if (subCmd == "jtag_frequency") {
       auto jtag_frequency_arg =
           static_cast<const CFGArg_PROGRAMMER_JTAG_FREQUENCY*>(
@@ -333,8 +494,8 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
       ProgressCallback progress = nullptr;
       auto gui = Gui::GuiInterface();
       if (gui) {
-        progress = [gui](const std::string& progress) {
-          gui->Progress(progress);
+        progress = [gui, device](const std::string& progress) {
+          gui->Progress(device.cable, device, progress);
         };
         gui->ProgramFpga(device.cable, device, bitstreamFile);
       }
@@ -398,8 +559,8 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
       ProgressCallback progress = nullptr;
       auto gui = Gui::GuiInterface();
       if (gui) {
-        progress = [gui](const std::string& progress) {
-          gui->Progress(progress);
+        progress = [gui, device](const std::string& progress) {
+          gui->Progress(device.cable, device, progress);
         };
         gui->ProgramOtp(device.cable, device, bitstreamFile);
       }
@@ -456,8 +617,8 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
       ProgressCallback progress = nullptr;
       auto gui = Gui::GuiInterface();
       if (gui) {
-        progress = [gui](const std::string& progress) {
-          gui->Progress(progress);
+        progress = [gui, device](const std::string& progress) {
+          gui->Progress(device.cable, device, progress);
         };
         gui->Flash(device.cable, device, bitstreamFile);
       }
@@ -484,6 +645,54 @@ void programmer_entry(CFGCommon_ARG* cmdarg) {
         CFG_POST_MSG("Flash programming '%s' successfully.",
                      bitstreamFile.c_str());
       }
+    } else if (subCmd == "batch") {
+      auto batch_arg =
+          static_cast<const CFGArg_PROGRAMMER_BATCH*>(arg->get_sub_arg());
+      std::vector<ProgrammingJob> jobs{};
+      if (!GetBatchJobs(batch_arg, jobs)) {
+        cmdarg->tclStatus = TCL_ERROR;
+        return;
+      }
+      // Resolve every device before starting, the scan is not repeated by the
+      // workers
+      std::vector<std::vector<Tap>> taplists(jobs.size());
+      for (size_t i = 0; i < jobs.size(); i++) {
+        std::string cableInput = jobs[i].cable.name;
+        uint32_t deviceIndex = jobs[i].device.index;
+        if (!hardware_manager.is_cable_exists(cableInput, true)) {
+          CFG_POST_ERR("Cable '%s' not found", cableInput.c_str());
+          cmdarg->tclStatus = TCL_ERROR;
+          return;
+        }
+        if (!hardware_manager.find_device(cableInput, deviceIndex,
+                                          jobs[i].device, taplists[i], true)) {
+          CFG_POST_ERR("Device %d not found", deviceIndex);
+          cmdarg->tclStatus = TCL_ERROR;
+          return;
+        }
+        jobs[i].device.cable.speed = GetCableSpeedFromMap(jobs[i].device.cable);
+        jobs[i].cable = jobs[i].device.cable;
+      }
+      std::string openOcdPath = cmdarg->toolPath.string();
+      RunBatchJobs(
+          cmdarg, jobs,
+          [&](size_t index, std::atomic<bool>& stop,
+              ProgressCallback progress) {
+            const ProgrammingJob& job = jobs[index];
+            OpenocdAdapter adapter{openOcdPath};
+            adapter.update_taplist(taplists[index]);
+            ProgrammerTool programmer{&adapter};
+            if (job.type == ProgramType::Otp) {
+              return programmer.program_otp(job.device, job.bitfile, stop,
+                                            nullptr, nullptr, progress);
+            } else if (job.type == ProgramType::Flash) {
+              return programmer.program_flash(job.device, job.bitfile, stop,
+                                              job.modes, nullptr, nullptr,
+                                              progress);
+            }
+            return programmer.program_fpga(job.device, job.bitfile, stop,
+                                           nullptr, nullptr, progress);
+          });
     } else if (subCmd == "jtag_frequency") {
       Cable cable;
       uint32_t speed;
@@ -641,4 +850,34 @@ int ProgramFlash(const Cable& cable, const Device& device,
                                   callbackMsg, callbackProgress);
 }
 
+int ProgramDevices(std::vector<ProgrammingJob>& jobs, std::atomic<bool>& stop,
+                   JobProgressCallback callbackProgress /*=nullptr*/,
+                   JobStatusCallback callbackStatus /*=nullptr*/) {
+  ProgrammingJobCallbacks callbacks;
+  if (callbackProgress) {
+    callbacks.progress = [&](size_t job, const std::string& progress) {
+      callbackProgress(job, progress);
+    };
+  }
+  callbacks.finished = callbackStatus;
+  return RunProgrammingJobs(
+      jobs, stop,
+      [&jobs](size_t index, std::atomic<bool>& stop,
+              ProgressCallback progress) {
+        const ProgrammingJob& job = jobs[index];
+        switch (job.type) {
+          case ProgramType::Otp:
+            return ProgramOTP(job.cable, job.device, job.bitfile, stop,
+                              nullptr, nullptr, progress);
+          case ProgramType::Flash:
+            return ProgramFlash(job.cable, job.device, job.bitfile, stop,
+                                job.modes, nullptr, nullptr, progress);
+          default:
+            return ProgramFpga(job.cable, job.device, job.bitfile, stop,
+                               nullptr, nullptr, progress);
+        }
+      },
+      callbacks);
+}
+
 }  // namespace FOEDAG
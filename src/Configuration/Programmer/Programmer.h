@@ -62,6 +62,25 @@ inline ProgramFlashOperation operator&(ProgramFlashOperation lhs,
 using ProgressCallback = std::function<void(std::string)>;
 using OutputMessageCallback = std::function<void(std::string)>;
 
+enum class ProgramType : uint32_t { Fpga, Otp, Flash };
+
+/**
+ * One bitstream to program on one device, see ProgramDevices().
+ */
+struct ProgrammingJob {
+  Cable cable{};
+  Device device{};
+  std::string bitfile;
+  ProgramType type = ProgramType::Fpga;
+  ProgramFlashOperation modes =
+      ProgramFlashOperation::Erase | ProgramFlashOperation::Program;
+  // Result of the job, GeneralCmdError when it never ran
+  int status = -1;
+};
+
+using JobProgressCallback = std::function<void(size_t, std::string)>;
+using JobStatusCallback = std::function<void(size_t, int)>;
+
 void programmer_entry(CFGCommon_ARG* cmdarg);
 
 // Backend API
@@ -221,6 +240,25 @@ int ProgramFlash(const Cable& cable, const Device& device,
                  OutputMessageCallback callbackMsg = nullptr,
                  ProgressCallback callbackProgress = nullptr);
 
+/**
+ * Programs several devices concurrently. Each cable gets its own worker, the
+ * jobs of one cable run in order because its devices share the JTAG chain.
+ *
+ * @param jobs The jobs to run, the status of each job is updated.
+ * @param stop An atomic boolean flag that can be used to stop the programming
+ * process. Jobs not started yet are skipped.
+ * @param callbackProgress An optional callback function to receive the
+ * progress updates of each job, identified by its index in `jobs`.
+ * @param callbackStatus An optional callback function to receive the status of
+ * each job when it completes.
+ * @return 0 if every job succeeded, or the error code of the first failed job
+ * otherwise.
+ * @note Both callbacks are called on the calling thread, never on a worker.
+ */
+int ProgramDevices(std::vector<ProgrammingJob>& jobs, std::atomic<bool>& stop,
+                   JobProgressCallback callbackProgress = nullptr,
+                   JobStatusCallback callbackStatus = nullptr);
+
 }  // namespace FOEDAG
 
 #endif
@@ -32,7 +32,8 @@ class ProgrammerGuiInterface {
   virtual void Cables(const std::vector<Cable> &cables) = 0;
   virtual void Devices(const Cable &cable,
                        const std::vector<Device> &devices) = 0;
-  virtual void Progress(const std::string &progress) = 0;
+  virtual void Progress(const Cable &cable, const Device &device,
+                        const std::string &progress) = 0;
   virtual void ProgramFpga(const Cable &cable, const Device &device,
                            const std::string &file) = 0;
   virtual void ProgramOtp(const Cable &cable, const Device &device,
@@ -21,9 +21,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Programmer_helper.h"
 
+#include <condition_variable>
+#include <deque>
 #include <iomanip>
+#include <map>
+#include <mutex>
 #include <regex>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
 #include "CFGCommon/CFGArg_auto.h"
@@ -224,6 +229,99 @@ int CheckCableAndDevice(HardwareManager& hardware_manager, const Cable& cable,
   return ProgrammerErrorCode::NoError;
 }
 
+int RunProgrammingJobs(std::vector<ProgrammingJob>& jobs,
+                       std::atomic<bool>& stop,
+                       const ProgrammingJobRunner& runner,
+                       const ProgrammingJobCallbacks& callbacks) {
+  enum EventType { Started, Progress, Finished };
+  struct Event {
+    EventType type;
+    size_t job;
+    std::string progress;
+    int status;
+  };
+  // Devices of one cable share its JTAG chain: one worker per cable runs them
+  // in order while the cables run concurrently
+  std::map<Cable, std::vector<size_t>, CompareCable> queues;
+  for (size_t i = 0; i < jobs.size(); i++) {
+    jobs[i].status = ProgrammerErrorCode::GeneralCmdError;
+    queues[jobs[i].cable].push_back(i);
+  }
+  std::mutex mutex;
+  std::condition_variable wakeup;
+  std::deque<Event> events;
+  size_t running = queues.size();
+  // Latched from stop so a caller resetting its flag cannot resume the jobs
+  std::atomic<bool> cancel{stop.load()};
+  auto post = [&](Event&& event) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      events.push_back(std::move(event));
+    }
+    wakeup.notify_one();
+  };
+  std::vector<std::thread> workers;
+  for (auto& queue : queues) {
+    const std::vector<size_t>* indexes = &queue.second;
+    workers.emplace_back([&, indexes]() {
+      for (size_t job : *indexes) {
+        if (cancel) break;
+        post({Started, job, {}, 0});
+        int status = ProgrammerErrorCode::GeneralCmdError;
+        try {
+          status = runner(job, cancel, [&, job](std::string progress) {
+            post({Progress, job, std::move(progress), 0});
+          });
+        } catch (...) {
+          // a failing job must not take its cable's remaining jobs with it
+        }
+        post({Finished, job, {}, status});
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+      }
+      wakeup.notify_one();
+    });
+  }
+  // Callbacks run here, the console and the GUI are not thread safe
+  std::exception_ptr error = nullptr;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wakeup.wait_for(lock, std::chrono::milliseconds(100),
+                    [&]() { return !events.empty() || running == 0; });
+    if (stop) cancel = true;
+    std::deque<Event> ready;
+    ready.swap(events);
+    bool done = running == 0;
+    lock.unlock();
+    for (auto& event : ready) {
+      if (event.type == Finished) jobs[event.job].status = event.status;
+      if (error) continue;
+      try {
+        if (event.type == Started && callbacks.started) {
+          callbacks.started(event.job);
+        } else if (event.type == Progress && callbacks.progress) {
+          callbacks.progress(event.job, event.progress);
+        } else if (event.type == Finished && callbacks.finished) {
+          callbacks.finished(event.job, event.status);
+        }
+      } catch (...) {
+        error = std::current_exception();
+        cancel = true;
+      }
+    }
+    if (done) break;
+    lock.lock();
+  }
+  for (auto& worker : workers) worker.join();
+  if (error) std::rethrow_exception(error);
+  for (auto& job : jobs) {
+    if (job.status != ProgrammerErrorCode::NoError) return job.status;
+  }
+  return ProgrammerErrorCode::NoError;
+}
+
 void Gui::SetGuiInterface(ProgrammerGuiInterface* guiInterface) {
   m_guiInterface = guiInterface;
 }
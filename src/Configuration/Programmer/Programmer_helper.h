@@ -20,6 +20,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
 #pragma once
+#include <atomic>
+#include <functional>
+
 #include "../HardwareManager/HardwareManager.h"
 
 struct libusb_device_handle;
@@ -31,6 +34,7 @@ struct CfgStatus;
 class ProgrammerGuiInterface;
 enum class ProgramFlashOperation : uint32_t;
 enum TransportType;
+struct ProgrammingJob;
 
 struct ProgrammerCommand {
   std::string name;
@@ -38,6 +42,17 @@ struct ProgrammerCommand {
   bool is_error = false;
 };
 
+// Runs the job at the given index, progress is reported through the callback
+using ProgrammingJobRunner = std::function<int(
+    size_t, std::atomic<bool>&, std::function<void(std::string)>)>;
+
+// Job events, delivered on the thread calling RunProgrammingJobs()
+struct ProgrammingJobCallbacks {
+  std::function<void(size_t)> started = nullptr;
+  std::function<void(size_t, const std::string&)> progress = nullptr;
+  std::function<void(size_t, int)> finished = nullptr;
+};
+
 class Gui {
   static ProgrammerGuiInterface* m_guiInterface;
 
@@ -69,6 +84,11 @@ int CheckCableAndDevice(HardwareManager& hardware_manager, const Cable& cable,
                         const Device& device, Device& detectedDevice,
                         std::vector<Tap>& taplist);
 
+int RunProgrammingJobs(std::vector<ProgrammingJob>& jobs,
+                       std::atomic<bool>& stop,
+                       const ProgrammingJobRunner& runner,
+                       const ProgrammingJobCallbacks& callbacks);
+
 CfgStatus extractStatus(const std::string& statusString, bool& statusFound);
 
 }  // namespace FOEDAG
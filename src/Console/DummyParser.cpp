@@ -29,7 +29,8 @@ namespace FOEDAG {
 DummyParser::DummyParser() {}
 
 LineParser::Result DummyParser::handleLine(const QString &message,
-                                           OutputFormat format) {
+                                           OutputFormat format,
+                                           const QDir &workingDir) {
   Q_UNUSED(format);
   const QRegularExpression getFile{"(?<=File: )(.*)(?= just)"};
   auto regExpMatch = getFile.match(message);
@@ -37,7 +38,7 @@ LineParser::Result DummyParser::handleLine(const QString &message,
     QString file = regExpMatch.captured();
     file.replace("\"", "");
     file = file.trimmed();
-    const QFileInfo fileInfo{file};
+    const QFileInfo fileInfo{workingDir, file};
     LinkSpec link{
         regExpMatch.capturedStart(), regExpMatch.capturedLength(),
         addLinkSpecForAbsoluteFilePath(fileInfo.absoluteFilePath(), "-1")};
@@ -27,6 +27,7 @@ namespace FOEDAG {
 class DummyParser : public LineParser {
  public:
   DummyParser();
-  Result handleLine(const QString &message, OutputFormat format) override;
+  Result handleLine(const QString &message, OutputFormat format,
+                    const QDir &workingDir) override;
 };
 }  // namespace FOEDAG
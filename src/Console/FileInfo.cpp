@@ -21,6 +21,27 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "FileInfo.h"
 
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+static constexpr qint64 DirCacheTimeoutMs{5000};
+static constexpr int DirCacheMaxSize{1024};
+
+struct DirEntries {
+  QSet<QString> names;
+  QElapsedTimer timer;
+};
+
+static QString fileKey(const QString &name) {
+#ifdef _WIN32
+  return name.toLower();
+#else
+  return name;
+#endif
+}
 
 FileInfo::FileInfo() {}
 
@@ -34,3 +55,29 @@ QStringList FileInfo::getFileList(const QString &path,
 }
 
 QChar FileInfo::separator() { return QDir::separator(); }
+
+bool FileInfo::exists(const QString &path) {
+  const QFileInfo info{path};
+  const QString name = info.fileName();
+  if (name.isEmpty()) return info.exists();
+
+  static QMutex mutex;
+  static QHash<QString, DirEntries> cache;
+  QMutexLocker locker{&mutex};
+  const QString dir = info.absolutePath();
+  if (!cache.contains(dir) && cache.size() >= DirCacheMaxSize) cache.clear();
+  DirEntries &entries = cache[dir];
+  // Expire the entries so the files created by the tools are found
+  if (!entries.timer.isValid() || entries.timer.hasExpired(DirCacheTimeoutMs)) {
+    entries.names.clear();
+    const QStringList names = QDir{dir}.entryList(
+        QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    for (const auto &n : names) entries.names.insert(fileKey(n));
+    entries.timer.start();
+  }
+  if (entries.names.contains(fileKey(name))) return true;
+  // Only a hit is trusted, the file may have been created since the listing
+  if (!QFileInfo::exists(path)) return false;
+  entries.names.insert(fileKey(name));
+  return true;
+}
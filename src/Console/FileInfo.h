@@ -28,4 +28,11 @@ class FileInfo {
   static QStringList getFileList(const QString &path,
                                  const QStringList &filter);
   static QChar separator();
+  /*!
+   * \brief exists. Same as QFileInfo::exists but the content of each
+   * directory is listed once and cached for a few seconds, one directory
+   * listing instead of one stat per file on network filesystems. A file
+   * missing from the listing is checked with QFileInfo::exists. Thread safe.
+   */
+  static bool exists(const QString &path);
 };
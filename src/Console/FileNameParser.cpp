@@ -23,10 +23,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QFileInfo>
 #include <QRegularExpression>
 
+#include "FileInfo.h"
+
 namespace FOEDAG {
 
 LineParser::Result FileNameParser::handleLine(const QString &message,
-                                              OutputFormat format) {
+                                              OutputFormat format,
+                                              const QDir &workingDir) {
   // use static to fix use-static-qregularexpression clazy warning
   static const QRegularExpression fileWithLine{
       "(\\S+[^\\.]\\.[a-zA-Z]+)(?:[:]|[(]|\\s)(\\d+)"};
@@ -36,9 +39,10 @@ LineParser::Result FileNameParser::handleLine(const QString &message,
     const int cap{1};
     QString file = regExpMatch.captured(cap);
     file = file.trimmed();
-    const QFileInfo fileInfo{file};
-    const QString filePath =
-        fileInfo.exists() ? fileInfo.absoluteFilePath() : file;
+    const QFileInfo fileInfo{workingDir, file};
+    const QString filePath = FileInfo::exists(fileInfo.filePath())
+                                 ? fileInfo.absoluteFilePath()
+                                 : file;
     const QString line = regExpMatch.captured(2);
     LinkSpec link{regExpMatch.capturedStart(cap),
                   regExpMatch.capturedLength(cap),
@@ -53,9 +57,10 @@ LineParser::Result FileNameParser::handleLine(const QString &message,
   if (regExpMatch.hasMatch()) {
     QString file = regExpMatch.captured(1);
     file = file.trimmed();
-    const QFileInfo fileInfo{file};
-    const QString filePath =
-        fileInfo.exists() ? fileInfo.absoluteFilePath() : file;
+    const QFileInfo fileInfo{workingDir, file};
+    const QString filePath = FileInfo::exists(fileInfo.filePath())
+                                 ? fileInfo.absoluteFilePath()
+                                 : file;
     const QString line = "-1";
     LinkSpec link{regExpMatch.capturedStart(1), regExpMatch.capturedLength(1),
                   addLinkSpecForAbsoluteFilePath(filePath, line)};
@@ -27,7 +27,8 @@ namespace FOEDAG {
 class FileNameParser : public LineParser {
  public:
   FileNameParser() = default;
-  Result handleLine(const QString &message, OutputFormat format) override;
+  Result handleLine(const QString &message, OutputFormat format,
+                    const QDir &workingDir) override;
 };
 
 }  // namespace FOEDAG
@@ -21,6 +21,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "OutputFormatter.h"
 
 #include <QDebug>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
 #include <QTextEdit>
 #include <QtAlgorithms>
 
@@ -30,7 +33,10 @@ Q_GLOBAL_STATIC_WITH_ARGS(QString, linkSep, {"::"})
 
 OutputFormatter::OutputFormatter() {}
 
-OutputFormatter::~OutputFormatter() { qDeleteAll(m_parsers); }
+OutputFormatter::~OutputFormatter() {
+  stopWorker();
+  qDeleteAll(m_parsers);
+}
 
 void OutputFormatter::appendMessage(const QString &message,
                                     OutputFormat format) {
@@ -39,30 +45,115 @@ void OutputFormatter::appendMessage(const QString &message,
   if (format < 0 || format >= Count) return;
 
   m_messageBuffer.append(message);
+  // One edit block, the document is laid out once for the whole message
+  // instead of once per line
+  QTextCursor cursor = textEdit()->textCursor();
+  cursor.beginEditBlock();
+  std::deque<ParseJob> jobs;
+  // The worker may parse after the working directory changed
+  const QString workingDir =
+      m_parsers.empty() ? QString{} : QDir::currentPath();
   int index = m_messageBuffer.indexOf('\n', Qt::CaseInsensitive);
-  while (index != -1) {  // perform parsing line by line
+  while (index != -1) {  // insert line by line
     auto line = m_messageBuffer.mid(0, index + 1);
+    const quint64 block = m_removedBlocks + cursor.blockNumber();
+    const int column = cursor.positionInBlock();
+    cursor.insertText(line, m_formats[format]);
+    // The parsers run on the worker, the links are applied when it is done.
+    // A cursor per line would be updated by every later insert, the block
+    // number is resolved only once the links are there.
+    if (!m_parsers.empty()) {
+      const quint64 id = m_nextLine++;
+      m_pending.emplace(id,
+                        PendingLine{block, column, line.chopped(1), format});
+      jobs.push_back({id, line, format, workingDir});
+    }
+
+    m_messageBuffer.remove(0, index + 1);
+    index = m_messageBuffer.indexOf('\n', Qt::CaseInsensitive);
+  }
+  cursor.endEditBlock();
+
+  if (jobs.empty()) return;
+  if (!m_worker.joinable()) {
+    m_worker = std::thread{&OutputFormatter::parseLines, this};
+  }
+  {
+    std::lock_guard<std::mutex> lock{m_jobsMutex};
+    for (auto &job : jobs) m_jobs.push_back(std::move(job));
+  }
+  m_wakeup.notify_one();
+}
 
-    LineParser::Status status{LineParser::Status::NotHandled};
-    for (auto parser : m_parsers) {
-      auto res = parser->handleLine(line, format);
-      if (res.status == LineParser::Status::Done) {
-        status = res.status;
-        auto outputFormats = parseResults(line, format, res.linkSpecs);
-        for (auto const &output : outputFormats) {
-          textEdit()->textCursor().insertText(output.text, output.format);
+void OutputFormatter::parseLines() {
+  std::unique_lock<std::mutex> lock{m_jobsMutex};
+  while (true) {
+    m_wakeup.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+    if (m_stop) break;
+    std::deque<ParseJob> jobs;
+    jobs.swap(m_jobs);
+    lock.unlock();
+
+    ParsedLines lines;
+    {
+      std::lock_guard<std::mutex> parsersLock{m_parsersMutex};
+      for (const auto &job : jobs) {
+        const QDir workingDir{job.workingDir};
+        for (auto parser : m_parsers) {
+          auto res = parser->handleLine(job.line, job.format, workingDir);
+          if (res.status == LineParser::Status::Done) {
+            if (!res.linkSpecs.empty()) {
+              lines.push_back({job.id, res.linkSpecs});
+            }
+            break;  // break, when one of the parsers was success to parse line
+          }
         }
-        break;  // break, when one of the parsers was success to parse line
       }
     }
+    const quint64 lastLine = jobs.back().id;
+    QMetaObject::invokeMethod(
+        textEdit(),
+        [this, lines, lastLine]() { applyLinks(lines, lastLine); },
+        Qt::QueuedConnection);
+    lock.lock();
+  }
+}
 
-    if (status == LineParser::Status::NotHandled) {
-      textEdit()->textCursor().insertText(line, m_formats[format]);
+void OutputFormatter::applyLinks(const ParsedLines &lines, quint64 lastLine) {
+  QTextDocument *document = textEdit()->document();
+  QTextCursor cursor{document};
+  cursor.beginEditBlock();
+  for (auto const &[id, links] : lines) {
+    auto pending = m_pending.find(id);
+    if (pending == m_pending.end()) continue;
+    const PendingLine &line = pending->second;
+    // The line was removed in the meantime (clear, scrollback)
+    if (line.block < m_removedBlocks) continue;
+    const QTextBlock block = document->findBlockByNumber(
+        static_cast<int>(line.block - m_removedBlocks));
+    if (!block.isValid() ||
+        block.text().mid(line.column, line.text.size()) != line.text)
+      continue;
+    const int start = block.position() + line.column;
+    for (auto const &link : links) {
+      cursor.setPosition(start + link.startPos);
+      cursor.setPosition(start + link.startPos + link.length,
+                         QTextCursor::KeepAnchor);
+      cursor.setCharFormat(linkedText(m_formats[line.format], link.href));
     }
+  }
+  cursor.endEditBlock();
+  m_pending.erase(m_pending.begin(), m_pending.upper_bound(lastLine));
+}
 
-    m_messageBuffer.remove(0, index + 1);
-    index = m_messageBuffer.indexOf('\n', Qt::CaseInsensitive);
+void OutputFormatter::stopWorker() {
+  if (!m_worker.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock{m_jobsMutex};
+    m_stop = true;
   }
+  m_wakeup.notify_one();
+  m_worker.join();
 }
 
 const std::vector<LineParser *> &OutputFormatter::parsers() const {
@@ -70,11 +161,13 @@ const std::vector<LineParser *> &OutputFormatter::parsers() const {
 }
 
 void OutputFormatter::setParsers(const std::vector<LineParser *> &newParsers) {
+  std::lock_guard<std::mutex> lock{m_parsersMutex};
   qDeleteAll(m_parsers);
   m_parsers = newParsers;
 }
 
 void OutputFormatter::addParser(LineParser *parser) {
+  std::lock_guard<std::mutex> lock{m_parsersMutex};
   m_parsers.push_back(parser);
 }
 
@@ -93,27 +186,6 @@ void OutputFormatter::initFormats() {
   for (auto &format : m_formats) format.setFont(f);
 }
 
-OutputFormatter::FormattedTexts OutputFormatter::parseResults(
-    const QString &text, OutputFormat format,
-    const LineParser::LinkSpecs &links) const {
-  FormattedTexts texts;
-  int totalLength = 0;
-  for (auto const &link : links) {
-    QString t = text.mid(totalLength, link.startPos - totalLength);
-    texts.push_back(FormattedText{t, m_formats[format]});
-    totalLength += t.length();
-
-    QString linked = text.mid(link.startPos, link.length);
-    texts.push_back(
-        FormattedText{linked, linkedText(m_formats[format], link.href)});
-    totalLength += link.length;
-  }
-  if (totalLength < text.length()) {
-    texts.push_back(FormattedText{text.mid(totalLength), m_formats[format]});
-  }
-  return texts;
-}
-
 QTextCharFormat OutputFormatter::linkedText(const QTextCharFormat &inputFormat,
                                             const QString &href) {
   QTextCharFormat linked = inputFormat;
@@ -124,6 +196,10 @@ QTextCharFormat OutputFormatter::linkedText(const QTextCharFormat &inputFormat,
   return linked;
 }
 
+void OutputFormatter::blocksRemoved(int count) {
+  if (count > 0) m_removedBlocks += count;
+}
+
 QTextEdit *OutputFormatter::textEdit() const { return m_textEdit; }
 
 void OutputFormatter::setTextEdit(QTextEdit *newTextEdit) {
@@ -20,7 +20,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <QDir>
 #include <QTextCharFormat>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 class QTextEdit;
@@ -62,7 +68,13 @@ class LineParser {
     Status status;
   };
 
-  virtual Result handleLine(const QString &message, OutputFormat format) = 0;
+  /*!
+   * \brief handleLine. Runs on the worker thread, relative file names are
+   * resolved against \param workingDir, the working directory when the line
+   * was appended
+   */
+  virtual Result handleLine(const QString &message, OutputFormat format,
+                            const QDir &workingDir) = 0;
 };
 
 class FormattedText {
@@ -73,8 +85,13 @@ class FormattedText {
   QTextCharFormat format;
 };
 
+/*!
+ * \brief The OutputFormatter class. Lines are inserted as soon as they are
+ * appended, the parsers run on a worker thread and their links are applied
+ * to the inserted lines afterwards.
+ */
 class OutputFormatter {
-  using FormattedTexts = std::vector<FormattedText>;
+  using ParsedLines = std::vector<std::pair<quint64, LineParser::LinkSpecs>>;
 
  public:
   OutputFormatter();
@@ -96,17 +113,47 @@ class OutputFormatter {
   void setTextEdit(QTextEdit *newTextEdit);
   QTextEdit *textEdit() const;
 
+  /*!
+   * \brief blocksRemoved. Must be called when the first \param count blocks
+   * of the document were removed, the pending lines are tracked by block
+   * number
+   */
+  void blocksRemoved(int count);
+
  private:
   void initFormats();
-  FormattedTexts parseResults(const QString &text, OutputFormat format,
-                              const LineParser::LinkSpecs &links) const;
   static QTextCharFormat linkedText(const QTextCharFormat &inputFormat,
                                     const QString &href);
+  void parseLines();
+  void applyLinks(const ParsedLines &lines, quint64 lastLine);
+  void stopWorker();
 
  private:
+  struct PendingLine {
+    quint64 block;  // counted from the first block ever inserted
+    int column;
+    QString text;  // without the line break
+    OutputFormat format;
+  };
+  struct ParseJob {
+    quint64 id;
+    QString line;
+    OutputFormat format;
+    QString workingDir;
+  };
   std::vector<LineParser *> m_parsers;
   std::vector<QTextCharFormat> m_formats{Count};
   QTextEdit *m_textEdit;
   QString m_messageBuffer;
+  // GUI thread only, lines waiting for their links
+  std::map<quint64, PendingLine> m_pending;
+  quint64 m_nextLine{0};
+  quint64 m_removedBlocks{0};
+  std::mutex m_parsersMutex;
+  std::mutex m_jobsMutex;  // guards m_jobs and m_stop
+  std::condition_variable m_wakeup;
+  std::deque<ParseJob> m_jobs;
+  bool m_stop{false};
+  std::thread m_worker;
 };
 }  // namespace FOEDAG
@@ -9,7 +9,9 @@
 #include <QProcess>
 #include <QScrollBar>
 #include <QStack>
+#include <QTemporaryFile>
 #include <QTextBlock>
+#include <QTextDocumentFragment>
 
 #include "Compiler/Log.h"
 #include "ConsoleDefines.h"
@@ -45,8 +47,14 @@ TclConsoleWidget::TclConsoleWidget(TclInterp *interp,
   setMouseTracking(true);
   setObjectName(consoleObjectName());
   setLineWrapMode(QTextEdit::NoWrap);
+  // Opened now so that its path can be queried from the Tcl thread
+  m_scrollback = std::make_unique<QTemporaryFile>(
+      QDir::temp().filePath("console_XXXXXX.log"));
+  m_scrollback->open();
 }
 
+TclConsoleWidget::~TclConsoleWidget() {}
+
 bool TclConsoleWidget::isRunning() const {
   return state() == State::IN_PROGRESS;
 }
@@ -59,7 +67,18 @@ TclConsoleBuffer *TclConsoleWidget::getErrorBuffer() { return m_errorBuffer; }
 
 const char *TclConsoleWidget::consoleObjectName() { return "TclConsole"; }
 
+void TclConsoleWidget::setScrollbackLimit(int lines) {
+  m_scrollbackLimit = std::max(0, lines);
+}
+
+int TclConsoleWidget::scrollbackLimit() const { return m_scrollbackLimit; }
+
+QString TclConsoleWidget::scrollbackFile() const {
+  return m_scrollback->fileName();
+}
+
 void TclConsoleWidget::clearText() {
+  m_formatter.blocksRemoved(document()->blockCount());
   clear();
   displayPrompt();
 }
@@ -169,9 +188,32 @@ void FOEDAG::TclConsoleWidget::putMessage(const QString &message,
     moveCursor(QTextCursor::End);
     LOG_OUTPUT(message);
     m_formatter.appendMessage(message, format);
+    trimScrollback();
   }
 }
 
+void TclConsoleWidget::trimScrollback() {
+  const int limit = m_scrollbackLimit;
+  const int extra = document()->blockCount() - limit;
+  // Removing the top lines relayouts the document, let it grow 10% over the
+  // limit before trimming
+  if (limit == 0 || extra <= limit / 10) return;
+
+  QTextCursor cursor{document()};
+  cursor.movePosition(QTextCursor::Start);
+  cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, extra);
+  if (m_scrollback->isOpen()) {
+    m_scrollback->write(cursor.selection().toPlainText().toUtf8());
+    m_scrollback->flush();
+  }
+  const bool undoRedo = isUndoRedoEnabled();
+  setUndoRedoEnabled(false);
+  cursor.removeSelectedText();
+  setUndoRedoEnabled(undoRedo);
+  m_formatter.blocksRemoved(extra);
+  promptParagraph = std::max(0, promptParagraph - extra);
+}
+
 void TclConsoleWidget::handleLink(const QPoint &p) {
   const QString anchor{anchorAt(p)};
   if (!anchor.isEmpty()) {
@@ -238,6 +280,36 @@ void TclConsoleWidget::registerCommands(TclInterp *interp) {
   };
   Tcl_CreateCommand(interp, "set_prompt", set_prompt, this, nullptr);
 
+  auto set_scrollback = [](ClientData clientData, Tcl_Interp *interp,
+                           int argc, const char *argv[]) {
+    TclConsoleWidget *console = static_cast<TclConsoleWidget *>(clientData);
+    if (!console) return TCL_ERROR;
+    Tcl_ResetResult(interp);
+    bool ok{false};
+    const int lines = (argc == 2) ? QString{argv[1]}.toInt(&ok) : -1;
+    if (!ok || lines < 0) {
+      QString usageMsg = QString("Usage: %1 lines\n").arg(argv[0]);
+      usageMsg += QString("Keep about lines lines in the console, 0 for no "
+                          "limit. Older lines are moved to the file given by "
+                          "scrollback_file");
+      TclAppendResult(interp, qPrintable(usageMsg));
+      return TCL_ERROR;
+    }
+    console->setScrollbackLimit(lines);
+    return TCL_OK;
+  };
+  Tcl_CreateCommand(interp, "set_scrollback", set_scrollback, this, nullptr);
+
+  auto scrollback_file = [](ClientData clientData, Tcl_Interp *interp,
+                            int argc, const char *argv[]) {
+    TclConsoleWidget *console = static_cast<TclConsoleWidget *>(clientData);
+    if (!console) return TCL_ERROR;
+    Tcl_ResetResult(interp);
+    TclAppendResult(interp, qPrintable(console->scrollbackFile()));
+    return TCL_OK;
+  };
+  Tcl_CreateCommand(interp, "scrollback_file", scrollback_file, this, nullptr);
+
   auto clear_ = [](ClientData clientData, Tcl_Interp *interp, int argc,
                    const char *argv[]) {
     TclConsoleWidget *console = static_cast<TclConsoleWidget *>(clientData);
@@ -2,6 +2,7 @@
 
 #include <QPlainTextEdit>
 #include <QTextBlock>
+#include <atomic>
 #include <memory>
 #include <ostream>
 
@@ -11,6 +12,7 @@
 #include "QConsole/qconsole.h"
 
 class QProcess;
+class QTemporaryFile;
 namespace FOEDAG {
 
 enum class State {
@@ -31,6 +33,7 @@ class TclConsoleWidget : public QConsole {
                             std::unique_ptr<ConsoleInterface> iConsole,
                             TclConsoleBuffer *buffer,
                             QWidget *parent = nullptr);
+  ~TclConsoleWidget() override;
   bool isRunning() const override;
   QString getPrompt() const;
   TclConsoleBuffer *getBuffer();
@@ -48,6 +51,20 @@ class TclConsoleWidget : public QConsole {
    */
   void addParser(LineParser *parser);
 
+  static constexpr int DefaultScrollbackLimit{100000};
+  /*!
+   * \brief setScrollbackLimit. Keep about \param lines lines in the console,
+   * the oldest ones are moved to scrollbackFile(). 0 means no limit. Thread
+   * safe, the console is trimmed on the next output.
+   */
+  void setScrollbackLimit(int lines);
+  int scrollbackLimit() const;
+  /*!
+   * \brief scrollbackFile. Path of the file holding the lines removed from
+   * the console
+   */
+  QString scrollbackFile() const;
+
  public slots:
   void clearText();
   void showPrompt();
@@ -74,6 +91,7 @@ class TclConsoleWidget : public QConsole {
 
  private:
   void putMessage(const QString &message, OutputFormat format);
+  void trimScrollback();
   void setState(const State &state);
   void handleLink(const QPoint &p);
   void registerCommands(TclInterp *interp);
@@ -95,6 +113,8 @@ class TclConsoleWidget : public QConsole {
   bool m_linkActivated{true};
   Qt::MouseButton m_mouseButtonPressed{Qt::NoButton};
   OutputFormatter m_formatter;
+  std::atomic<int> m_scrollbackLimit{DefaultScrollbackLimit};
+  std::unique_ptr<QTemporaryFile> m_scrollback;
 };
 
 }  // namespace FOEDAG
@@ -28,7 +28,8 @@ namespace FOEDAG {
 TclErrorParser::TclErrorParser() {}
 
 LineParser::Result TclErrorParser::handleLine(const QString &message,
-                                              OutputFormat format) {
+                                              OutputFormat format,
+                                              const QDir &workingDir) {
   Q_UNUSED(format);
   // use static to fix use-static-qregularexpression clazy warning
   static const QRegularExpression getFile{"(?<=file \")(.*)(?=\" line*)"};
@@ -39,7 +40,7 @@ LineParser::Result TclErrorParser::handleLine(const QString &message,
     QString file = regExpMatch.captured();
     file.replace("\"", "");
     file = file.trimmed();
-    const QFileInfo fileInfo{file};
+    const QFileInfo fileInfo{workingDir, file};
     const QString line = lineMatch.captured();
     LinkSpec link{
         regExpMatch.capturedStart(), regExpMatch.capturedLength(),
@@ -0,0 +1,312 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DesignQuery/DesignDatabase.h"
+
+#include <stdexcept>
+#include <unordered_set>
+
+#include "DesignQuery/HierInfoReader.h"
+#include "Utils/JsonCache.h"
+#include "Utils/StringUtils.h"
+
+using json = nlohmann::ordered_json;
+
+namespace FOEDAG {
+
+static const std::string InputDir{"Input"};
+static const std::string OutputDir{"Output"};
+
+bool DesignDatabase::Stamp(const std::filesystem::path& path,
+                           FileStamp& stamp) {
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) return false;
+  stamp.path = path;
+  stamp.size = std::filesystem::file_size(path, ec);
+  if (ec) return false;
+  stamp.time = std::filesystem::last_write_time(path, ec);
+  return !ec;
+}
+
+template <typename Json>
+DesignDatabase::Status DesignDatabase::Load(const std::filesystem::path& path,
+                                            Entry<Json>& entry) {
+  FileStamp stamp;
+  if (!Stamp(path, stamp)) {
+    entry = Entry<Json>{};
+    return std::make_pair(
+        false,
+        StringUtils::format(R"(Unable to locate file "%")", path.string()));
+  }
+  if (entry.loaded && entry.stamp == stamp) {
+    return std::make_pair(true, std::string{});
+  }
+  try {
+    if (!JsonCache::Load(path, entry.json))
+      throw std::runtime_error{"Can't read " + path.string()};
+  } catch (std::exception&) {
+    entry = Entry<Json>{};
+    return std::make_pair(
+        false, StringUtils::format("Failed to parse file %", path.string()));
+  }
+  entry.stamp = stamp;
+  entry.loaded = true;
+  return std::make_pair(true, std::string{});
+}
+
+DesignDatabase::Status DesignDatabase::LoadHierInfo(
+    const std::filesystem::path& path) {
+  FileStamp stamp;
+  const bool stamped = Stamp(path, stamp);
+  if (stamped && m_hierLoaded && m_hierStamp == stamp)
+    return std::make_pair(true, std::string{});
+
+  // hier_info.json can be huge for netlist level designs, stream it instead
+  // of building the json DOM
+  HierInfo info;
+  auto status = HierInfoReader::Read(path, info);
+  if (status.first) {
+    status = BuildHierIndex(std::move(info));
+    if (!status.first) BuildHierIndex(HierInfo{});
+  } else {
+    BuildHierIndex(HierInfo{});
+  }
+  m_hierLoaded = status.first;
+  m_hierStamp = status.first ? stamp : FileStamp{};
+  return status;
+}
+
+DesignDatabase::Status DesignDatabase::LoadPortInfo(
+    const std::filesystem::path& path) {
+  return Load(path, m_port);
+}
+
+DesignDatabase::Status DesignDatabase::LoadSdtInfo(
+    const std::filesystem::path& path) {
+  return Load(path, m_sdt);
+}
+
+void DesignDatabase::Invalidate() {
+  m_hierLoaded = false;
+  m_hierStamp = FileStamp{};
+  m_port = Entry<nlohmann::ordered_json>{};
+  m_sdt = Entry<nlohmann::json>{};
+  BuildHierIndex(HierInfo{});
+}
+
+int DesignDatabase::DirectionFlag(const std::string& direction) {
+  if (direction == InputDir) return Input;
+  if (direction == OutputDir) return Output;
+  return 0;
+}
+
+DesignDatabase::Status DesignDatabase::BuildHierIndex(HierInfo&& info) {
+  m_fileIDs = std::move(info.fileIDs);
+  m_portList.clear();
+  m_ports.clear();
+  m_buses.clear();
+  m_modules.clear();
+  m_moduleInsts.clear();
+  m_instanceCount = 0;
+
+  for (auto& [name, module] : info.modules) {
+    m_modules.emplace(name, DesignModule{name, module.file, module.language,
+                                         module.line, false, {}});
+    AddModuleInstances(name, std::move(module.moduleInsts));
+  }
+
+  for (auto& item : info.hierTree) {
+    DesignModule top{item.name, item.file, item.language, item.line, true, {}};
+    for (const auto& p : item.ports) {
+      DesignPort port{p.name, p.direction, p.type, top.name, p.lsb, p.msb};
+      top.ports.push_back(port.name);
+      const size_t index = m_portList.size();
+      m_ports.emplace(port.name, index);
+      if (port.isBus()) m_buses.emplace(port.name, index);
+      m_portList.push_back(std::move(port));
+    }
+    AddModuleInstances(top.name, std::move(item.moduleInsts));
+    m_modules[top.name] = std::move(top);
+  }
+
+  std::unordered_map<std::string, size_t> counts;
+  for (const auto& item : info.hierTree) {
+    size_t count{0};
+    auto status = CountInstances(item.name, counts, count);
+    if (!status.first) return status;
+    m_instanceCount += count;
+  }
+  return std::make_pair(true, std::string{});
+}
+
+void DesignDatabase::AddModuleInstances(const std::string& module,
+                                        std::vector<HierInfo::Inst>&& insts) {
+  ModuleInstances& entry = m_moduleInsts[module];
+  entry.insts = std::move(insts);
+  entry.byName.clear();
+  // insts is not resized anymore, the views stay valid
+  for (size_t i = 0; i < entry.insts.size(); i++)
+    entry.byName.emplace(entry.insts[i].instName, i);
+}
+
+DesignDatabase::Status DesignDatabase::CountInstances(
+    const std::string& top, std::unordered_map<std::string, size_t>& counts,
+    size_t& count) const {
+  static const std::vector<HierInfo::Inst> NoInsts{};
+  auto instances = [this](const std::string& module)
+      -> const std::vector<HierInfo::Inst>& {
+    auto it = m_moduleInsts.find(module);
+    return it != m_moduleInsts.end() ? it->second.insts : NoInsts;
+  };
+  // Depth first walk with an explicit stack, the hierarchy can be deeper
+  // than the call stack allows. counts holds the finished modules.
+  struct Frame {
+    const std::string* module;
+    const std::vector<HierInfo::Inst>* insts;
+    size_t next;
+    size_t count;
+  };
+  std::unordered_set<std::string_view> inProgress;
+  std::vector<Frame> stack;
+  if (auto it = counts.find(top); it != counts.end()) {
+    count = it->second;
+    return std::make_pair(true, std::string{});
+  }
+  stack.push_back(Frame{&top, &instances(top), 0, 0});
+  inProgress.insert(top);
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    if (frame.next == frame.insts->size()) {
+      const size_t done = frame.count;
+      inProgress.erase(*frame.module);
+      counts.emplace(*frame.module, done);
+      stack.pop_back();
+      if (!stack.empty()) stack.back().count += 1 + done;
+      continue;
+    }
+    const std::string& module = (*frame.insts)[frame.next++].module;
+    if (auto it = counts.find(module); it != counts.end()) {
+      frame.count += 1 + it->second;
+    } else if (inProgress.count(module) != 0) {
+      return std::make_pair(
+          false,
+          StringUtils::format("Cyclic hierarchy, module % instantiates %",
+                              *frame.module, module));
+    } else {
+      inProgress.insert(module);
+      stack.push_back(Frame{&module, &instances(module), 0, 0});
+    }
+  }
+  count = counts.at(top);
+  return std::make_pair(true, std::string{});
+}
+
+std::vector<std::string> DesignDatabase::Ports(int portType) const {
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+  for (const auto& port : m_portList) {
+    const int dir = DirectionFlag(port.direction);
+    if ((portType & Input) != 0 && dir == Input) inputs.push_back(port.name);
+    if ((portType & Output) != 0 && dir == Output)
+      outputs.push_back(port.name);
+  }
+  inputs.insert(inputs.end(), outputs.begin(), outputs.end());
+  return inputs;
+}
+
+std::vector<const DesignPort*> DesignDatabase::Buses(int portType) const {
+  std::vector<const DesignPort*> inputs;
+  std::vector<const DesignPort*> outputs;
+  for (const auto& port : m_portList) {
+    if (!port.isBus()) continue;
+    const int dir = DirectionFlag(port.direction);
+    if ((portType & Input) != 0 && dir == Input) inputs.push_back(&port);
+    if ((portType & Output) != 0 && dir == Output) outputs.push_back(&port);
+  }
+  inputs.insert(inputs.end(), outputs.begin(), outputs.end());
+  return inputs;
+}
+
+const DesignPort* DesignDatabase::Port(const std::string& name) const {
+  auto it = m_ports.find(name);
+  return (it != m_ports.end()) ? &m_portList.at(it->second) : nullptr;
+}
+
+const DesignPort* DesignDatabase::Bus(const std::string& name) const {
+  auto it = m_buses.find(name);
+  return (it != m_buses.end()) ? &m_portList.at(it->second) : nullptr;
+}
+
+const DesignModule* DesignDatabase::Module(const std::string& name) const {
+  auto it = m_modules.find(name);
+  return (it != m_modules.end()) ? &it->second : nullptr;
+}
+
+std::optional<DesignInstance> DesignDatabase::Instance(
+    const std::string& name) const {
+  const size_t topEnd = name.find('.');
+  if (topEnd == std::string::npos) return std::nullopt;
+  const DesignModule* top = Module(name.substr(0, topEnd));
+  if (!top || !top->top) return std::nullopt;
+
+  // Walk down the per module indices, one path element per level
+  const std::string_view path{name};
+  std::string module = top->name;
+  size_t start = topEnd + 1;
+  while (start < path.size()) {
+    auto insts = m_moduleInsts.find(module);
+    if (insts == m_moduleInsts.end()) return std::nullopt;
+    const auto& byName = insts->second.byName;
+    // Instance names may contain dots, take the shortest known prefix
+    size_t end = path.find('.', start);
+    auto found = byName.end();
+    while (true) {
+      const size_t length =
+          (end == std::string_view::npos ? path.size() : end) - start;
+      found = byName.find(path.substr(start, length));
+      if (found != byName.end() || end == std::string_view::npos) break;
+      end = path.find('.', end + 1);
+    }
+    if (found == byName.end()) return std::nullopt;
+    const HierInfo::Inst& inst = insts->second.insts[found->second];
+    if (end == std::string_view::npos) {
+      return DesignInstance{name, inst.module, name.substr(0, start - 1),
+                            inst.file, inst.line};
+    }
+    module = inst.module;
+    start = end + 1;
+  }
+  return std::nullopt;
+}
+
+bool DesignDatabase::HasPort(const std::string& name, int portType) const {
+  const DesignPort* port = Port(name);
+  return port && (DirectionFlag(port->direction) & portType) != 0;
+}
+
+bool DesignDatabase::HasBusBit(const std::string& name, int bit,
+                               int portType) const {
+  const DesignPort* bus = Bus(name);
+  if (!bus || (DirectionFlag(bus->direction) & portType) == 0) return false;
+  return bit >= bus->lsb && bit <= bus->msb;
+}
+
+}  // namespace FOEDAG
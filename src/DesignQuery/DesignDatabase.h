@@ -0,0 +1,178 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DesignQuery/HierInfoReader.h"
+#include "nlohmann_json/json.hpp"
+
+namespace FOEDAG {
+
+struct DesignPort {
+  std::string name{};
+  std::string direction{};
+  std::string type{};
+  std::string module{};
+  int lsb{};
+  int msb{};
+  bool isBus() const { return msb != lsb; }
+};
+
+struct DesignInstance {
+  std::string name{};    // hierarchical name, e.g. top.u1.u2
+  std::string module{};  // module type of the instance
+  std::string parent{};  // hierarchical name of the parent
+  std::string file{};
+  int line{};
+};
+
+struct DesignModule {
+  std::string name{};
+  std::string file{};
+  std::string language{};
+  int line{};
+  bool top{false};
+  std::vector<std::string> ports{};
+};
+
+/*!
+ * \brief The DesignDatabase class
+ * Keeps analysis outputs (hier_info.json, port_info.json and the SDT json) in
+ * memory together with hash indices over modules, ports, buses and instances.
+ * hier_info.json is streamed and only the indices are kept. Instances are
+ * indexed per module and hierarchical paths are resolved on lookup, the
+ * elaborated hierarchy is never flattened.
+ * Every file is parsed once and re-parsed only when its size or modification
+ * time changes.
+ */
+class DesignDatabase {
+ public:
+  enum PortDirection { Input = 1, Output = 2 };
+  using Status = std::pair<bool, std::string>;
+
+  DesignDatabase() = default;
+  DesignDatabase(const DesignDatabase&) = delete;
+  DesignDatabase& operator=(const DesignDatabase&) = delete;
+
+  Status LoadHierInfo(const std::filesystem::path& path);
+  Status LoadPortInfo(const std::filesystem::path& path);
+  Status LoadSdtInfo(const std::filesystem::path& path);
+
+  bool HierInfoLoaded() const { return m_hierLoaded; }
+  const std::vector<std::pair<std::string, std::string>>& FileIDs() const {
+    return m_fileIDs;
+  }
+  const nlohmann::ordered_json& PortJson() const { return m_port.json; }
+  const nlohmann::json& SdtJson() const { return m_sdt.json; }
+  // The SDT node parsers read the tree with the non-const operator[]
+  nlohmann::json& SdtJson() { return m_sdt.json; }
+
+  /*!
+   * \brief Ports of top modules in file order, inputs first then outputs.
+   * \param portType combination of PortDirection flags
+   */
+  std::vector<std::string> Ports(int portType) const;
+  std::vector<const DesignPort*> Buses(int portType) const;
+
+  const DesignPort* Port(const std::string& name) const;
+  const DesignPort* Bus(const std::string& name) const;
+  const DesignModule* Module(const std::string& name) const;
+  /*!
+   * \brief Instance by hierarchical name, e.g. top.u1.u2
+   */
+  std::optional<DesignInstance> Instance(const std::string& name) const;
+  /*!
+   * \brief Number of instances in the elaborated hierarchy
+   */
+  size_t InstanceCount() const { return m_instanceCount; }
+  bool HasPort(const std::string& name, int portType) const;
+  bool HasBusBit(const std::string& name, int bit, int portType) const;
+
+  const std::unordered_map<std::string, DesignModule>& Modules() const {
+    return m_modules;
+  }
+
+  void Invalidate();
+
+ private:
+  struct FileStamp {
+    std::filesystem::path path{};
+    std::uintmax_t size{};
+    std::filesystem::file_time_type time{};
+    bool operator==(const FileStamp& other) const {
+      return path == other.path && size == other.size && time == other.time;
+    }
+  };
+  template <typename Json>
+  struct Entry {
+    Json json{};
+    FileStamp stamp{};
+    bool loaded{false};
+  };
+  template <typename Json>
+  static Status Load(const std::filesystem::path& path, Entry<Json>& entry);
+  static bool Stamp(const std::filesystem::path& path, FileStamp& stamp);
+  static int DirectionFlag(const std::string& direction);
+
+  struct ModuleInstances {
+    ModuleInstances() = default;
+    // A copy would keep the views into the source insts
+    ModuleInstances(const ModuleInstances&) = delete;
+    ModuleInstances& operator=(const ModuleInstances&) = delete;
+    ModuleInstances(ModuleInstances&&) = default;
+    ModuleInstances& operator=(ModuleInstances&&) = default;
+
+    std::vector<HierInfo::Inst> insts{};
+    // views of insts[i].instName
+    std::unordered_map<std::string_view, size_t> byName{};
+  };
+
+  Status BuildHierIndex(HierInfo&& info);
+  void AddModuleInstances(const std::string& module,
+                          std::vector<HierInfo::Inst>&& insts);
+  Status CountInstances(const std::string& top,
+                        std::unordered_map<std::string, size_t>& counts,
+                        size_t& count) const;
+
+  FileStamp m_hierStamp;
+  bool m_hierLoaded{false};
+  Entry<nlohmann::ordered_json> m_port;
+  Entry<nlohmann::json> m_sdt;
+
+  std::vector<std::pair<std::string, std::string>> m_fileIDs;
+  std::vector<DesignPort> m_portList;
+  std::unordered_map<std::string, size_t> m_ports;
+  std::unordered_map<std::string, size_t> m_buses;
+  std::unordered_map<std::string, DesignModule> m_modules;
+  std::unordered_map<std::string, ModuleInstances> m_moduleInsts;
+  size_t m_instanceCount{0};
+};
+
+}  // namespace FOEDAG
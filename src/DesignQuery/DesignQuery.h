@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 
+#include "DesignQuery/DesignDatabase.h"
 #include "nlohmann_json/json.hpp"
 
 namespace FOEDAG {
@@ -46,14 +47,20 @@ class DesignQuery {
   explicit DesignQuery(Compiler* compiler) : m_compiler(compiler) {}
   virtual ~DesignQuery() {}
   Compiler* GetCompiler() { return m_compiler; }
-  const nlohmann::ordered_json& getHierJson() const { return m_hier_json; }
-  const nlohmann::ordered_json& getPortJson() const { return m_port_json; }
+  const nlohmann::ordered_json& getPortJson() const {
+    return m_database.PortJson();
+  }
+  const nlohmann::json& getSdtJson() const { return m_database.SdtJson(); }
+  nlohmann::json& getSdtJson() { return m_database.SdtJson(); }
+  const DesignDatabase& Database() const { return m_database; }
   bool RegisterCommands(TclInterpreter* interp, bool batchMode);
   std::filesystem::path GetProjDir() const;
   std::filesystem::path GetHierInfoPath() const;
   std::filesystem::path GetPortInfoPath() const;
+  std::filesystem::path GetSdtInfoPath() const;
   std::pair<bool, std::string> LoadPortInfo();
   std::pair<bool, std::string> LoadHierInfo();
+  std::pair<bool, std::string> LoadSdtInfo();
 
   std::vector<std::string> GetPorts(int portType, bool& portsParsed) const;
   std::vector<Bus> GetBuses(int portType, bool& portsParsed) const;
@@ -62,8 +69,7 @@ class DesignQuery {
 
  protected:
   Compiler* m_compiler = nullptr;
-  nlohmann::ordered_json m_hier_json;
-  nlohmann::ordered_json m_port_json;
+  DesignDatabase m_database;
   bool m_read_sdc{false};  // temporary solution for reading sdc
 };
 
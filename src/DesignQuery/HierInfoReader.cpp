@@ -0,0 +1,261 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DesignQuery/HierInfoReader.h"
+
+#include <fstream>
+
+#include "Utils/StringUtils.h"
+#include "nlohmann_json/json.hpp"
+
+namespace FOEDAG {
+
+namespace {
+
+using json = nlohmann::json;
+
+// SAX handler which fills HierInfo. Every json container pushes a context
+// derived from its parent and the current key, anything that is not needed
+// is skipped without being stored.
+class HierInfoHandler : public nlohmann::json_sax<json> {
+ public:
+  explicit HierInfoHandler(HierInfo& info) : m_info(info) {}
+
+  bool null() override { return true; }
+  bool boolean(bool) override { return true; }
+  bool number_integer(number_integer_t val) override {
+    return number(static_cast<long long>(val));
+  }
+  bool number_unsigned(number_unsigned_t val) override {
+    return number(static_cast<long long>(val));
+  }
+  bool number_float(number_float_t val, const string_t&) override {
+    return number(static_cast<long long>(val));
+  }
+  bool string(string_t& val) override;
+  bool binary(binary_t&) override { return true; }
+  bool start_object(std::size_t) override;
+  bool end_object() override { return pop(); }
+  bool start_array(std::size_t) override;
+  bool end_array() override { return pop(); }
+  bool key(string_t& val) override {
+    m_key = val;
+    return true;
+  }
+  bool parse_error(std::size_t, const std::string&,
+                   const nlohmann::detail::exception& ex) override {
+    m_error = ex.what();
+    return false;
+  }
+
+  const std::string& error() const { return m_error; }
+  bool hierTreeFound() const { return m_hierTreeFound; }
+
+ private:
+  enum class Context {
+    Root,
+    FileIDs,
+    HierTree,
+    Modules,
+    Module,
+    Ports,
+    Port,
+    Range,
+    Insts,
+    Inst,
+    Skip
+  };
+  bool push(Context context) {
+    m_stack.push_back(context);
+    return true;
+  }
+  bool pop() {
+    if (!m_stack.empty()) {
+      if (m_stack.back() == Context::Module) m_module = nullptr;
+      m_stack.pop_back();
+    }
+    return true;
+  }
+  Context top() const {
+    return m_stack.empty() ? Context::Skip : m_stack.back();
+  }
+  bool number(long long val);
+
+  HierInfo& m_info;
+  std::vector<Context> m_stack;
+  std::string m_key;
+  std::string m_error;
+  HierInfo::Module* m_module{nullptr};
+  bool m_hierTreeFound{false};
+};
+
+bool HierInfoHandler::start_object(std::size_t) {
+  if (m_stack.empty()) return push(Context::Root);
+  switch (top()) {
+    case Context::Root:
+      if (m_key == "fileIDs") return push(Context::FileIDs);
+      if (m_key == "modules") return push(Context::Modules);
+      break;
+    case Context::HierTree:
+      m_info.hierTree.emplace_back();
+      m_module = &m_info.hierTree.back();
+      return push(Context::Module);
+    case Context::Modules:
+      m_module = &m_info.modules[m_key];
+      m_module->name = m_key;
+      return push(Context::Module);
+    case Context::Ports:
+      m_module->ports.emplace_back();
+      return push(Context::Port);
+    case Context::Port:
+      if (m_key == "range") return push(Context::Range);
+      break;
+    case Context::Insts:
+      m_module->moduleInsts.emplace_back();
+      return push(Context::Inst);
+    default:
+      break;
+  }
+  return push(Context::Skip);
+}
+
+bool HierInfoHandler::start_array(std::size_t) {
+  switch (top()) {
+    case Context::Root:
+      if (m_key == "hierTree") {
+        m_hierTreeFound = true;
+        return push(Context::HierTree);
+      }
+      break;
+    case Context::Module:
+      if (m_key == "ports") return push(Context::Ports);
+      if (m_key == "moduleInsts") return push(Context::Insts);
+      break;
+    default:
+      break;
+  }
+  return push(Context::Skip);
+}
+
+bool HierInfoHandler::string(string_t& val) {
+  switch (top()) {
+    case Context::FileIDs:
+      m_info.fileIDs.emplace_back(m_key, val);
+      break;
+    case Context::Module:
+      if (m_key == "topModule" || m_key == "module")
+        m_module->name = val;
+      else if (m_key == "file")
+        m_module->file = val;
+      else if (m_key == "language")
+        m_module->language = val;
+      break;
+    case Context::Port: {
+      auto& port = m_module->ports.back();
+      if (m_key == "name")
+        port.name = val;
+      else if (m_key == "direction")
+        port.direction = val;
+      else if (m_key == "type")
+        port.type = val;
+      break;
+    }
+    case Context::Inst: {
+      auto& inst = m_module->moduleInsts.back();
+      if (m_key == "instName")
+        inst.instName = val;
+      else if (m_key == "module")
+        inst.module = val;
+      else if (m_key == "file")
+        inst.file = val;
+      break;
+    }
+    default:
+      break;
+  }
+  return true;
+}
+
+bool HierInfoHandler::number(long long val) {
+  switch (top()) {
+    case Context::Module:
+      if (m_key == "line") m_module->line = static_cast<int>(val);
+      if (m_key == "file") m_module->file = std::to_string(val);
+      break;
+    case Context::Range: {
+      auto& port = m_module->ports.back();
+      if (m_key == "lsb") port.lsb = static_cast<int>(val);
+      if (m_key == "msb") port.msb = static_cast<int>(val);
+      break;
+    }
+    case Context::Inst: {
+      auto& inst = m_module->moduleInsts.back();
+      if (m_key == "line") inst.line = static_cast<int>(val);
+      if (m_key == "file") inst.file = std::to_string(val);
+      break;
+    }
+    default:
+      break;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::pair<bool, std::string> HierInfoReader::Read(std::istream& stream,
+                                                  HierInfo& info) {
+  info = HierInfo{};
+  HierInfoHandler handler{info};
+  bool ok{false};
+  try {
+    ok = json::sax_parse(stream, &handler);
+  } catch (std::exception& e) {
+    info = HierInfo{};
+    return std::make_pair(false, std::string{e.what()});
+  }
+  if (!ok) {
+    info = HierInfo{};
+    return std::make_pair(false, handler.error());
+  }
+  if (!handler.hierTreeFound()) {
+    info = HierInfo{};
+    return std::make_pair(false, std::string{R"(Key "hierTree" not found)"});
+  }
+  return std::make_pair(true, std::string{});
+}
+
+std::pair<bool, std::string> HierInfoReader::Read(
+    const std::filesystem::path& path, HierInfo& info) {
+  std::ifstream stream{path};
+  if (!stream.good()) {
+    info = HierInfo{};
+    return std::make_pair(
+        false,
+        StringUtils::format(R"(Unable to locate file "%")", path.string()));
+  }
+  auto [ok, message] = Read(stream, info);
+  if (!ok)
+    message = StringUtils::format("Failed to parse file %: %", path.string(),
+                                  message);
+  return std::make_pair(ok, message);
+}
+
+}  // namespace FOEDAG
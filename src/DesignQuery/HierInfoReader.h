@@ -0,0 +1,82 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The HierInfo struct is a compact representation of hier_info.json.
+ * Only the fields used by the hierarchy view and design query are kept.
+ */
+struct HierInfo {
+  struct Port {
+    std::string name{};
+    std::string direction{};
+    std::string type{};
+    int lsb{};
+    int msb{};
+  };
+  struct Inst {
+    std::string instName{};
+    std::string module{};
+    std::string file{};
+    int line{};
+  };
+  struct Module {
+    std::string name{};
+    std::string file{};
+    std::string language{};
+    int line{};
+    std::vector<Port> ports{};
+    std::vector<Inst> moduleInsts{};
+  };
+
+  std::vector<std::pair<std::string, std::string>> fileIDs{};
+  std::vector<Module> hierTree{};
+  std::unordered_map<std::string, Module> modules{};
+};
+
+/*!
+ * \brief The HierInfoReader class reads hier_info.json with a SAX parser.
+ * The full json DOM is never materialized, the reader fills HierInfo while
+ * the file is streamed from disk.
+ */
+class HierInfoReader {
+ public:
+  /*!
+   * \return pair of status and error message. On failure \a info is left
+   * empty.
+   */
+  static std::pair<bool, std::string> Read(const std::filesystem::path& path,
+                                           HierInfo& info);
+  static std::pair<bool, std::string> Read(std::istream& stream,
+                                           HierInfo& info);
+};
+
+}  // namespace FOEDAG
@@ -0,0 +1,142 @@
+/*
+Copyright 2021 The Foedag team
+
+GPL License
+
+Copyright (c) 2021 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Compares the json DOM and the SAX loaders for hier_info.json, and the
+// DesignDatabase built over the SAX loader.
+// Usage:
+//   hierinfo_bench generate <file> <modules>
+//   hierinfo_bench dom|sax|database <file>
+// Peak RSS is per process, run each mode in its own process.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "DesignQuery/DesignDatabase.h"
+#include "DesignQuery/HierInfoReader.h"
+#include "nlohmann_json/json.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+static long PeakRssKb() {
+#ifndef _WIN32
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) == 0) return usage.ru_maxrss;
+#endif
+  return 0;
+}
+
+static void Generate(const std::string& file, int modules) {
+  using json = nlohmann::ordered_json;
+  json hier;
+  hier["fileIDs"]["1"] = "top.v";
+  json top;
+  top["file"] = "1";
+  top["language"] = "SystemVerilog";
+  top["line"] = 1;
+  top["topModule"] = "top";
+  for (int i = 0; i < 64; i++) {
+    top["ports"].push_back({{"direction", i % 2 ? "Output" : "Input"},
+                            {"name", "p" + std::to_string(i)},
+                            {"range", {{"lsb", 0}, {"msb", i % 8}}},
+                            {"type", "LOGIC"}});
+  }
+  for (int i = 0; i < modules; i++) {
+    const std::string name = "m" + std::to_string(i);
+    top["moduleInsts"].push_back({{"file", "1"},
+                                  {"instName", "u" + std::to_string(i)},
+                                  {"line", i + 2},
+                                  {"module", name},
+                                  {"parameters", json::array()}});
+    json module;
+    module["file"] = "1";
+    module["language"] = "SystemVerilog";
+    module["line"] = i;
+    module["module"] = name;
+    for (int j = 0; j < 8; j++) {
+      module["ports"].push_back({{"direction", "Input"},
+                                 {"name", "i" + std::to_string(j)},
+                                 {"range", {{"lsb", 0}, {"msb", 31}}},
+                                 {"type", "LOGIC"}});
+      module["moduleInsts"].push_back({{"file", "1"},
+                                       {"instName", "c" + std::to_string(j)},
+                                       {"line", j},
+                                       {"module", "cell"},
+                                       {"parameters", json::array()}});
+    }
+    hier["modules"][name] = module;
+  }
+  hier["hierTree"].push_back(top);
+  std::ofstream{file} << hier.dump(2);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " generate <file> <modules>\n"
+              << "       " << argv[0] << " dom|sax|database <file>\n";
+    return 1;
+  }
+  const std::string mode{argv[1]};
+  const std::string file{argv[2]};
+  if (mode == "generate") {
+    Generate(file, argc > 3 ? std::stoi(argv[3]) : 10000);
+    return 0;
+  }
+
+  const long before = PeakRssKb();
+  const auto start = std::chrono::steady_clock::now();
+  size_t modules{0};
+  if (mode == "dom") {
+    std::ifstream stream{file};
+    auto hier = nlohmann::ordered_json::parse(stream);
+    modules = hier.at("modules").size();
+  } else if (mode == "sax") {
+    FOEDAG::HierInfo info;
+    auto [ok, message] = FOEDAG::HierInfoReader::Read(file, info);
+    if (!ok) {
+      std::cerr << message << std::endl;
+      return 1;
+    }
+    modules = info.modules.size();
+  } else if (mode == "database") {
+    FOEDAG::DesignDatabase database;
+    auto [ok, message] = database.LoadHierInfo(file);
+    if (!ok) {
+      std::cerr << message << std::endl;
+      return 1;
+    }
+    modules = database.Modules().size();
+    std::cout << "database: instances " << database.InstanceCount()
+              << std::endl;
+  } else {
+    std::cerr << "unknown mode " << mode << std::endl;
+    return 1;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  std::cout << mode << ": modules " << modules << ", parse "
+            << elapsed.count() << " ms, peak RSS " << PeakRssKb()
+            << " kB (startup " << before << " kB)" << std::endl;
+  return 0;
+}
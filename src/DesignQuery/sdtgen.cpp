@@ -47,7 +47,7 @@ string node_tab = "\t";
 string subnode_tab = "\t\t";
 string subsubnode_tab = "\t\t\t";
 
-int get_soc_node(nlohmann::json data, SdtSocNode &sdt_soc_node_obj,
+int get_soc_node(nlohmann::json &data, SdtSocNode &sdt_soc_node_obj,
                  int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["soc"].empty())) {
     if (!data["root"]["soc"]["#size-cells"].empty()) {
@@ -1730,7 +1730,7 @@ int get_soc_node(nlohmann::json data, SdtSocNode &sdt_soc_node_obj,
 }
 
 // void get_memory_node(json data, SdtMemoryNode &sdt_memory_node_obj) {
-int get_memory_node(nlohmann::json data, SdtMemoryNode &sdt_memory_node_obj,
+int get_memory_node(nlohmann::json &data, SdtMemoryNode &sdt_memory_node_obj,
                     int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["memory"].empty())) {
     // this tells that the object has been populated
@@ -1960,7 +1960,7 @@ int get_memory_node(nlohmann::json data, SdtMemoryNode &sdt_memory_node_obj,
 
 // void get_cpus_cluster(json data, SdtCpusClusterNode
 // &sdt_cpus_cluster_node_obj) {
-int get_cpus_cluster_node(nlohmann::json data,
+int get_cpus_cluster_node(nlohmann::json &data,
                           SdtCpusClusterNode &sdt_cpus_cluster_node_obj,
                           int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["cpus-cluster"].empty())) {
@@ -2301,7 +2301,7 @@ int get_cpus_cluster_node(nlohmann::json data,
 
 // void get_rootmetadata_node (json data, SdtRootMetaDataNode
 // &sdt_rootmetadata_node_obj) {
-int get_rootmetadata_node(nlohmann::json data,
+int get_rootmetadata_node(nlohmann::json &data,
                           SdtRootMetaDataNode &sdt_rootmetadata_node_obj,
                           int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["sdt_root_metadata"].empty())) {
@@ -2371,7 +2371,7 @@ int get_rootmetadata_node(nlohmann::json data,
 }
 
 // void get_cpus (json data, SdtCpusNode &sdt_cpus_node_obj) {
-int get_cpus_node(nlohmann::json data, SdtCpusNode &sdt_cpus_node_obj,
+int get_cpus_node(nlohmann::json &data, SdtCpusNode &sdt_cpus_node_obj,
                   int verbose) {
   if ((!data["root"].empty()) && (!data["root"]["cpus"].empty())) {
     if (!data["root"]["cpus"]["#address-cells"].empty()) {
@@ -3036,34 +3036,9 @@ string return_string_from_ofstream_file(ofstream &outfile, string file_path) {
   // first we flush the outfile
   outfile.flush();
 
-  int size;
-
-  ifstream inputFile;
-
-  inputFile.open(file_path);
-
-  // calculating size of inputFile
-  inputFile.seekg(0, inputFile.end);
-  size = inputFile.tellg();
-  inputFile.seekg(0, inputFile.beg);
-
-  // allocate memory:
-  char *data_file = new char[size];
-
-  // read data as a block:
-  inputFile.read(data_file, size);
-
-  inputFile.close();
-
-  // printf("Printing the read JSON file file \n");
-
-  // print content:
-  // cout.write (data_file, size);
-
-  string data_file_string = data_file;
-  // string data_file_string = string(data_file);
-
-  return data_file_string;
+  ifstream inputFile(file_path, ios::binary);
+  return string((istreambuf_iterator<char>(inputFile)),
+                istreambuf_iterator<char>());
 }
 
 // passing &output by ref cx we wana change it
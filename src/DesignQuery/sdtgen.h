@@ -726,27 +726,27 @@ class SdtSocNode {
 };
 
 // void get_soc_node(json data, SdtSocNode &sdt_soc_node_obj) {
-int get_soc_node(nlohmann::json data, SdtSocNode &sdt_soc_node_obj,
+int get_soc_node(nlohmann::json &data, SdtSocNode &sdt_soc_node_obj,
                  int verbose = 0);
 
 // void get_memory_node(json data, SdtMemoryNode &sdt_memory_node_obj) {
-int get_memory_node(nlohmann::json data, SdtMemoryNode &sdt_memory_node_obj,
+int get_memory_node(nlohmann::json &data, SdtMemoryNode &sdt_memory_node_obj,
                     int verbose = 0);
 
 // void get_cpus_cluster(json data, SdtCpusClusterNode
 // &sdt_cpus_cluster_node_obj) {
-int get_cpus_cluster_node(nlohmann::json data,
+int get_cpus_cluster_node(nlohmann::json &data,
                           SdtCpusClusterNode &sdt_cpus_cluster_node_obj,
                           int verbose = 0);
 
 // void get_rootmetadata_node (nlohmann::json data, SdtRootMetaDataNode
 // &sdt_rootmetadata_node_obj) {
-int get_rootmetadata_node(nlohmann::json data,
+int get_rootmetadata_node(nlohmann::json &data,
                           SdtRootMetaDataNode &sdt_rootmetadata_node_obj,
                           int verbose = 0);
 
 // void get_cpus (json data, SdtCpusNode &sdt_cpus_node_obj) {
-int get_cpus_node(nlohmann::json data, SdtCpusNode &sdt_cpus_node_obj,
+int get_cpus_node(nlohmann::json &data, SdtCpusNode &sdt_cpus_node_obj,
                   int verbose = 0);
 
 string return_string_from_ofstream_file(ofstream &outfile, string file_path);
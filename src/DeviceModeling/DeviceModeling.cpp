@@ -76,6 +76,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Compiler/TclInterpreterHandler.h"
 #include "Compiler/WorkerThread.h"
 #include "DeviceModeling/DeviceModeling.h"
+#include "DeviceModeling/device_loader.h"
 #include "MainWindow/Session.h"
 #include "Model.h"
 #include "NewProject/ProjectManager/project_manager.h"
@@ -89,6 +90,13 @@ using namespace FOEDAG;
 using Time = std::chrono::high_resolution_clock;
 using ms = std::chrono::milliseconds;
 
+// Returns a command status to Tcl once the lines the command logged are
+// written, so they never trail the output of the next command.
+static int command_status(bool status) {
+  SpeedLog::flush();
+  return (status) ? TCL_OK : TCL_ERROR;
+}
+
 std::filesystem::path DeviceModeling::GetProjDir() const {
   ProjectManager* projManager = m_compiler->ProjManager();
   std::filesystem::path dir(projManager->getProjectPath().toStdString());
@@ -104,7 +112,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     bool status = true;
     std::string ret = "return from test_device_modeling_tcl";
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("test_device_modeling_tcl", test_device_modeling_tcl,
                       this, 0);
@@ -113,7 +121,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
                                   int argc, const char* argv[]) -> int {
     bool status = true;
     Tcl_SetObjResult(interp, Tcl_NewIntObj(argc));
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("example_command_ret_i", example_command_ret_i, this, 0);
 
@@ -127,7 +135,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
                                Tcl_NewStringObj(argv[i], -1));
     }
     Tcl_SetObjResult(interp, resultList);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("example_command_ret_list", example_command_ret_list,
                       this, 0);
@@ -144,7 +152,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("device_name", device_name, this, 0);
 
@@ -160,7 +168,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("device_version", device_version, this, 0);
 
@@ -176,7 +184,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("schema_version", schema_version, this, 0);
 
@@ -192,7 +200,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_enum_type", define_enum_type, this, 0);
 
@@ -208,7 +216,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_block", define_block, this, 0);
 
@@ -224,7 +232,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("undefine_device", undefine_device, this, 0);
 
@@ -240,7 +248,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_ports", define_ports, this, 0);
 
@@ -256,7 +264,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_param_type", define_param_type, this, 0);
 
@@ -272,7 +280,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_param", define_param, this, 0);
 
@@ -288,7 +296,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_attr", define_attr, this, 0);
 
@@ -304,7 +312,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_constraint", define_constraint, this, 0);
 
@@ -320,7 +328,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("create_instance", create_instance, this, 0);
 
@@ -336,7 +344,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_properties", define_properties, this, 0);
 
@@ -354,7 +362,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_property", get_property, this, 0);
 
@@ -371,7 +379,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("add_block_to_chain_type", add_block_to_chain_type, this,
                       0);
@@ -388,7 +396,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("append_instance_to_chain", append_instance_to_chain,
                       this, 0);
@@ -402,7 +410,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("create_chain_instance", create_chain_instance, this, 0);
 
@@ -418,7 +426,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("create_instance_chain", create_instance_chain, this, 0);
 
@@ -434,7 +442,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_chain", define_chain, this, 0);
 
@@ -450,7 +458,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("define_net", define_net, this, 0);
 
@@ -463,7 +471,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("drive_net", drive_net, this, 0);
 
@@ -476,7 +484,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("drive_port", drive_port, this, 0);
 
@@ -500,7 +508,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_attributes", get_attributes, this, 0);
 
@@ -525,7 +533,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_parameters", get_parameters, this, 0);
 
@@ -549,7 +557,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_parameter_types", get_parameter_types, this, 0);
 
@@ -573,7 +581,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_block_names", get_block_names, this, 0);
 
@@ -586,7 +594,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_chain_names", get_instance_chain_names,
                       this, 0);
@@ -600,7 +608,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_chain_by_name", get_instance_chain_by_name,
                       this, 0);
@@ -626,7 +634,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_constraint_names", get_constraint_names, this, 0);
 
@@ -636,7 +644,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     auto c_name = Model::get_modler().get_constraint_by_name(argc, argv);
     // Append each block name to the list.
     Tcl_SetObjResult(interp, Tcl_NewStringObj(c_name.c_str(), -1));
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_constraint_by_name", get_constraint_by_name, this,
                       0);
@@ -650,7 +658,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_block_name", get_instance_block_name, this,
                       0);
@@ -670,7 +678,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_block_type", get_instance_block_type, this,
                       0);
@@ -684,7 +692,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_by_id", get_instance_by_id, this, 0);
 
@@ -697,7 +705,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_id", get_instance_id, this, 0);
 
@@ -710,7 +718,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_id_set", get_instance_id_set, this, 0);
 
@@ -735,7 +743,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_names", get_instance_names, this, 0);
 
@@ -760,7 +768,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_chains_names", get_instance_chains_names,
                       this, 0);
@@ -786,7 +794,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_chain", get_instance_chain, this, 0);
 
@@ -799,7 +807,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_instance_name_set", get_instance_name_set, this, 0);
 
@@ -819,7 +827,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_io_bank", get_io_bank, this, 0);
 
@@ -838,10 +846,54 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_logic_address", get_logic_address, this, 0);
 
+  auto decode_address = [](void* clientData, Tcl_Interp* interp, int argc,
+                           const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      Tcl_Obj* resultList = Tcl_NewListObj(0, NULL);
+      auto fields = Model::get_modler().decode_address(argc, argv);
+      // Instance, block, attribute and bit.
+      for (auto n : fields) {
+        Tcl_ListObjAppendElement(interp, resultList,
+                                 Tcl_NewStringObj(n.c_str(), -1));
+      }
+      Tcl_SetObjResult(interp, resultList);
+      status = true;
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+
+    return command_status(status);
+  };
+  interp->registerCmd("decode_address", decode_address, this, 0);
+
+  auto get_attribute_address = [](void* clientData, Tcl_Interp* interp,
+                                  int argc, const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      auto i_add = Model::get_modler().get_attribute_address(argc, argv);
+      Tcl_SetObjResult(interp, Tcl_NewIntObj(i_add));
+      status = true;
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+
+    return command_status(status);
+  };
+  interp->registerCmd("get_attribute_address", get_attribute_address, this, 0);
+
   auto set_logic_address = [](void* clientData, Tcl_Interp* interp, int argc,
                               const char* argv[]) -> int {
     DeviceModeling* device_modeling = (DeviceModeling*)clientData;
@@ -854,7 +906,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("set_logic_address", set_logic_address, this, 0);
 
@@ -878,7 +930,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_logic_location", get_logic_location, this, 0);
 
@@ -891,7 +943,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_net_sink_set", get_net_sink_set, this, 0);
 
@@ -904,7 +956,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_net_source", get_net_source, this, 0);
 
@@ -917,7 +969,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_parent", get_parent, this, 0);
 
@@ -935,7 +987,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_phy_address", get_phy_address, this, 0);
 
@@ -948,7 +1000,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_port_connections", get_port_connections, this, 0);
 
@@ -961,7 +1013,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_port_connection_sink_set",
                       get_port_connection_sink_set, this, 0);
@@ -975,7 +1027,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_port_connection_source", get_port_connection_source,
                       this, 0);
@@ -1001,7 +1053,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_port_list", get_port_list, this, 0);
 
@@ -1014,7 +1066,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     std::string cmd(argv[0]);
     std::string ret = "__Not Yet Integrated " + cmd;
     compiler->TclInterp()->setResult(ret);
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("link_chain", link_chain, this, 0);
 
@@ -1031,7 +1083,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;  // map_rtl_user_names
+    return command_status(status);  // map_rtl_user_names
   };
   interp->registerCmd("map_rtl_user_names", map_rtl_user_names, this, 0);
 
@@ -1050,7 +1102,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_rtl_name", get_rtl_name, this, 0);
 
@@ -1066,7 +1118,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
     } catch (...) {
       compiler->ErrorMessage("Unknown Exception");
     }
-    return (status) ? TCL_OK : TCL_ERROR;  // map_rtl_user_names
+    return command_status(status);  // map_rtl_user_names
   };
   interp->registerCmd("map_model_user_names", map_model_user_names, this, 0);
 
@@ -1085,7 +1137,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_model_name", get_model_name, this, 0);
 
@@ -1104,7 +1156,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("get_user_name", get_user_name, this, 0);
 
@@ -1121,7 +1173,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("set_io_bank", set_io_bank, this, 0);
 
@@ -1138,7 +1190,7 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("set_logic_location", set_logic_location, this, 0);
 
@@ -1155,9 +1207,76 @@ bool DeviceModeling::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       compiler->ErrorMessage("Unknown Exception");
     }
 
-    return (status) ? TCL_OK : TCL_ERROR;
+    return command_status(status);
   };
   interp->registerCmd("set_phy_address", set_phy_address, this, 0);
 
+  auto save_device_snapshot = [](void* clientData, Tcl_Interp* interp, int argc,
+                                 const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      status = Model::get_modler().save_device_snapshot(argc, argv);
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+
+    return command_status(status);
+  };
+  interp->registerCmd("save_device_snapshot", save_device_snapshot, this, 0);
+
+  auto load_device_snapshot = [](void* clientData, Tcl_Interp* interp, int argc,
+                                 const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      status = Model::get_modler().load_device_snapshot(argc, argv);
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+
+    return command_status(status);
+  };
+  interp->registerCmd("load_device_snapshot", load_device_snapshot, this, 0);
+
+  auto load_device_model = [](void* clientData, Tcl_Interp* interp, int argc,
+                              const char* argv[]) -> int {
+    DeviceModeling* device_modeling = (DeviceModeling*)clientData;
+    Compiler* compiler = device_modeling->GetCompiler();
+    bool status = false;
+    try {
+      if (argc != 2) {
+        throw std::invalid_argument("Usage: load_device_model <file>");
+      }
+      // Declarative commands go straight to the modeler, anything else is
+      // evaluated by Tcl in the caller's scope like "source" would.
+      device_loader loader{
+          Model::get_modler(),
+          [interp](const std::string& command, std::string& error) {
+            if (Tcl_EvalEx(interp, command.c_str(), command.size(), 0) ==
+                TCL_OK) {
+              return true;
+            }
+            error = Tcl_GetStringResult(interp);
+            return false;
+          }};
+      loader.load_file(argv[1]);
+      Tcl_ResetResult(interp);
+      status = true;
+    } catch (const std::exception& ex) {
+      compiler->ErrorMessage(ex.what());
+    } catch (...) {
+      compiler->ErrorMessage("Unknown Exception");
+    }
+    return command_status(status);
+  };
+  interp->registerCmd("load_device_model", load_device_model, this, 0);
+
   return true;
 }
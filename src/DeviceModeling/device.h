@@ -214,6 +214,14 @@ class device : public device_block {
     return "";  // or consider throwing an exception or using std::optional
   }
 
+  /**
+   * @brief Get all the user to RTL name mappings.
+   * @return A const reference to the user to RTL name map.
+   */
+  const std::unordered_map<std::string, std::string> &user_to_rtl_map() const {
+    return user_to_rtl_map_;
+  }
+
  private:
   std::string schema_version_;  ///< The schema version of the device.
   std::string device_name_;     ///< The name of the device.
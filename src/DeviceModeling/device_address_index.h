@@ -0,0 +1,226 @@
+/**
+ * @file device_address_index.h
+ * @brief Address index mapping configuration bits to instance attributes.
+ *
+ * The configuration layout is the one ModelConfig builds its bitfields from:
+ * it is rooted at the model block, blocks with the no_configuration property
+ * are skipped with their children, and the absolute logic address of an
+ * attribute is its offset in the block plus the logic addresses of every
+ * enclosing instance, in 32 bit arithmetic. Physical addresses relocate that
+ * layout: an instance with a physical address places its subtree there,
+ * descendants without one keep their logic offset relative to it.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "device.h"
+
+/**
+ * @brief One attribute of one instance in the address space.
+ */
+struct device_address_entry {
+  std::string instance;  ///< Hierarchical name, or the model name.
+  std::string attribute;
+  const device_block *block = nullptr;
+  uint32_t logic_address = 0;
+  uint32_t size = 0;
+  int64_t phy_address = -1;  ///< -1 when no enclosing physical address.
+};
+
+/**
+ * @class device_address_index
+ * @brief Logarithmic lookups between addresses and instance attributes.
+ *
+ * The address space is cut into disjoint segments, each owned by one
+ * attribute, so a lookup is a single binary search. Where attributes overlap
+ * the one starting last owns the overlap.
+ */
+class device_address_index {
+ public:
+  /**
+   * @brief Index every addressed attribute of a configuration model.
+   * @param dev The device.
+   * @param model The block the layout is rooted at, as given to
+   * model_config set_model.
+   * @throws std::runtime_error If the device has no such block.
+   */
+  device_address_index(device &dev, const std::string &model) : model_(model) {
+    std::shared_ptr<device_block> root = dev.get_block(model);
+    if (!root) {
+      throw std::runtime_error("Could not find model block " + model);
+    }
+    add_block(*root, nullptr, model, 0, -1);
+    logic_.build(entries_, [](const device_address_entry &e) {
+      return static_cast<int64_t>(e.logic_address);
+    });
+    phy_.build(entries_,
+               [](const device_address_entry &e) { return e.phy_address; });
+  }
+
+  /**
+   * @brief Find the attribute holding a logic address.
+   * @param address The absolute logic address.
+   * @param bit Set to the bit of the attribute when found.
+   * @return The entry or nullptr.
+   */
+  const device_address_entry *find_logic(uint32_t address,
+                                         uint32_t *bit = nullptr) const {
+    return logic_.find(entries_, address, bit);
+  }
+
+  /**
+   * @brief Find the attribute holding a physical address.
+   * @param address The physical address.
+   * @param bit Set to the bit of the attribute when found.
+   * @return The entry or nullptr.
+   */
+  const device_address_entry *find_phy(uint32_t address,
+                                       uint32_t *bit = nullptr) const {
+    return phy_.find(entries_, address, bit);
+  }
+
+  /**
+   * @brief Find an attribute of an instance.
+   * @param instance Hierarchical instance name, or the model name.
+   * @param attribute The attribute name.
+   * @return The entry or nullptr.
+   */
+  const device_address_entry *find_attribute(
+      const std::string &instance, const std::string &attribute) const {
+    auto it = by_name_.find(key(instance, attribute));
+    return it == by_name_.end() ? nullptr : &entries_[it->second];
+  }
+
+  const std::vector<device_address_entry> &entries() const { return entries_; }
+
+  const std::string &model() const { return model_; }
+
+ private:
+  class interval_index {
+   public:
+    template <typename Start>
+    void build(const std::vector<device_address_entry> &entries, Start start) {
+      std::vector<size_t> order;
+      std::vector<int64_t> bounds;
+      for (size_t i = 0; i < entries.size(); ++i) {
+        if (!entries[i].size || start(entries[i]) < 0) continue;
+        order.push_back(i);
+        bounds.push_back(start(entries[i]));
+        bounds.push_back(start(entries[i]) + entries[i].size);
+      }
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return start(entries[a]) < start(entries[b]);
+      });
+      std::sort(bounds.begin(), bounds.end());
+      bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+      // Sweep the bounds, the open interval starting last owns the segment
+      using open_interval = std::pair<int64_t, size_t>;  // start, order index
+      std::priority_queue<open_interval> open;
+      size_t next = 0;
+      for (size_t b = 0; b + 1 < bounds.size(); ++b) {
+        for (; next < order.size() && start(entries[order[next]]) == bounds[b];
+             ++next) {
+          open.push({bounds[b], next});
+        }
+        while (!open.empty() &&
+               open.top().first + entries[order[open.top().second]].size <=
+                   bounds[b]) {
+          open.pop();
+        }
+        if (open.empty()) continue;
+        const size_t entry = order[open.top().second];
+        if (!owners_.empty() && owners_.back() == entry &&
+            ends_.back() == bounds[b]) {
+          ends_.back() = bounds[b + 1];
+        } else {
+          starts_.push_back(bounds[b]);
+          ends_.push_back(bounds[b + 1]);
+          owners_.push_back(entry);
+          offsets_.push_back(start(entries[entry]));
+        }
+      }
+    }
+
+    const device_address_entry *find(
+        const std::vector<device_address_entry> &entries, int64_t address,
+        uint32_t *bit) const {
+      size_t i = std::upper_bound(starts_.begin(), starts_.end(), address) -
+                 starts_.begin();
+      if (i == 0 || address >= ends_[i - 1]) return nullptr;
+      --i;
+      if (bit) *bit = static_cast<uint32_t>(address - offsets_[i]);
+      return &entries[owners_[i]];
+    }
+
+   private:
+    std::vector<int64_t> starts_;
+    std::vector<int64_t> ends_;
+    std::vector<size_t> owners_;
+    std::vector<int64_t> offsets_;  // start of the owning attribute
+  };
+
+  static std::string key(const std::string &instance,
+                         const std::string &attribute) {
+    return instance + '\n' + attribute;
+  }
+
+  static bool is_none_config_block(const device_block &block) {
+    const std::string value = block.getProperty("no_configuration");
+    return value == "1" || value == "true" || value == "on";
+  }
+
+  void add_block(device_block &block, device_block_instance *inst,
+                 const std::string &name, uint32_t offset, int64_t phy) {
+    // Not configurable, skipped with its children like ModelConfig does
+    if (is_none_config_block(block)) return;
+    for (auto &attr : block.attributes()) {
+      device_address_entry entry;
+      entry.instance = name;
+      entry.attribute = attr.first.str();
+      entry.block = &block;
+      entry.logic_address =
+          offset + static_cast<uint32_t>(attr.second->get_address());
+      entry.size = static_cast<uint32_t>(attr.second->get_type()->get_size());
+      if (phy >= 0) entry.phy_address = phy + attr.second->get_address();
+      by_name_[key(name, entry.attribute)] = entries_.size();
+      entries_.push_back(std::move(entry));
+    }
+    // The layout comes from the block's own instances like ModelConfig does,
+    // physical addresses are set on the copies held by each instance. An
+    // instance without a logic address (-1) is kept, ModelConfig adds it as
+    // is to the enclosing offset.
+    for (auto &child : block.instances()) {
+      device_block_instance *layout = child.second.get();
+      if (!layout) continue;
+      std::string child_name = child.first.str();
+      device_block_instance *placed =
+          inst ? inst->findInstanceByName(child_name).get() : layout;
+      const uint32_t child_offset =
+          static_cast<uint32_t>(layout->get_logic_address());
+      int64_t child_phy = phy >= 0 ? phy + layout->get_logic_address() : -1;
+      if (placed && placed->get_phy_address() >= 0) {
+        child_phy = placed->get_phy_address();
+      }
+      add_block(*layout->get_block(), placed,
+                inst ? name + "." + child_name : child_name,
+                offset + child_offset, child_phy);
+    }
+  }
+
+  std::string model_;
+  std::vector<device_address_entry> entries_;
+  std::unordered_map<std::string, size_t> by_name_;
+  interval_index logic_;
+  interval_index phy_;
+};
@@ -0,0 +1,341 @@
+/**
+ * @file device_arena.h
+ * @brief Arena allocator and string interner shared by the device model.
+ *
+ * Large device models hold millions of small map nodes and many copies of the
+ * same port, net and attribute names. Names are interned once in a global
+ * pool and referenced through device_name, small allocations are carved from
+ * large chunks and recycled through per size free lists.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class device_string_pool
+ * @brief Global pool of interned names. Interned strings are never released
+ * and keep a stable address for the lifetime of the process. Each entry also
+ * caches the hash of its contents.
+ */
+class device_string_pool {
+ public:
+  using entry = std::pair<const std::string, std::size_t>;
+
+  /**
+   * @brief Return the pooled copy of a string, adding it if needed.
+   * @param str The string to intern.
+   * @return Reference to the unique pooled string.
+   */
+  static const std::string &intern(const std::string &str) {
+    return intern_entry(str).first;
+  }
+
+  /**
+   * @brief Return the pool entry of a string, adding it if needed.
+   * @param str The string to intern.
+   * @return Pooled string paired with the hash of its contents.
+   */
+  static const entry &intern_entry(const std::string &str) {
+    auto &p = pool();
+    std::lock_guard<std::mutex> lock{p.mutex};
+    auto it = p.strings.find(str);
+    if (it == p.strings.end()) {
+      it = p.strings.emplace(str, std::hash<std::string>{}(str)).first;
+    }
+    return *it;
+  }
+
+  /**
+   * @brief Number of distinct strings in the pool.
+   */
+  static std::size_t size() {
+    auto &p = pool();
+    std::lock_guard<std::mutex> lock{p.mutex};
+    return p.strings.size();
+  }
+
+ private:
+  struct state {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::size_t> strings;
+  };
+  static state &pool() {
+    // Intentionally leaked: names must outlive every static device object.
+    static state *s = new state;
+    return *s;
+  }
+};
+
+template <typename T>
+class device_map;
+
+/**
+ * @class device_name
+ * @brief Handle to an interned name, the pooled string and the hash of its
+ * contents. Comparison works on the pooled address. The cached hash keeps the
+ * iteration order of name keyed maps the same on every run.
+ */
+class device_name {
+ public:
+  device_name()
+      : device_name(device_string_pool::intern_entry(std::string{})) {}
+  explicit device_name(const std::string &str)
+      : device_name(device_string_pool::intern_entry(str)) {}
+  explicit device_name(const char *str)
+      : device_name(device_string_pool::intern_entry(std::string{str})) {}
+
+  const std::string &str() const { return *str_; }
+  operator const std::string &() const { return *str_; }
+  const char *c_str() const { return str_->c_str(); }
+  std::size_t size() const { return str_->size(); }
+  bool empty() const { return str_->empty(); }
+
+  bool operator==(const device_name &other) const {
+    // Different pooled names never match, the contents are only compared for
+    // the lookup keys of device_map which are not pooled
+    return str_ == other.str_ ||
+           (hash_ == other.hash_ && *str_ == *other.str_);
+  }
+  bool operator!=(const device_name &other) const { return !(*this == other); }
+  bool operator<(const device_name &other) const { return *str_ < *other.str_; }
+
+ private:
+  template <typename T>
+  friend class device_map;
+  friend struct device_name_hash;
+
+  explicit device_name(const device_string_pool::entry &entry)
+      : str_(&entry.first), hash_(entry.second) {}
+  // Lookup key referencing a caller string, must not outlive it
+  device_name(const std::string *str, std::size_t hash)
+      : str_(str), hash_(hash) {}
+  static device_name lookup(const std::string &str) {
+    return device_name{&str, std::hash<std::string>{}(str)};
+  }
+
+  const std::string *str_;
+  std::size_t hash_;
+};
+
+inline bool operator==(const device_name &lhs, const std::string &rhs) {
+  return lhs.str() == rhs;
+}
+inline bool operator==(const std::string &lhs, const device_name &rhs) {
+  return lhs == rhs.str();
+}
+inline bool operator==(const device_name &lhs, const char *rhs) {
+  return lhs.str() == rhs;
+}
+inline bool operator==(const char *lhs, const device_name &rhs) {
+  return rhs.str() == lhs;
+}
+inline bool operator!=(const device_name &lhs, const std::string &rhs) {
+  return !(lhs == rhs);
+}
+inline bool operator!=(const device_name &lhs, const char *rhs) {
+  return !(lhs == rhs);
+}
+inline std::string operator+(const device_name &lhs, const std::string &rhs) {
+  return lhs.str() + rhs;
+}
+inline std::string operator+(const std::string &lhs, const device_name &rhs) {
+  return lhs + rhs.str();
+}
+inline std::string operator+(const device_name &lhs, const char *rhs) {
+  return lhs.str() + rhs;
+}
+inline std::string operator+(const char *lhs, const device_name &rhs) {
+  return lhs + rhs.str();
+}
+inline std::ostream &operator<<(std::ostream &os, const device_name &name) {
+  return os << name.str();
+}
+
+struct device_name_hash {
+  std::size_t operator()(const device_name &name) const {
+    return name.hash_;
+  }
+};
+
+/**
+ * @class device_arena
+ * @brief Chunked allocator for small device model objects. Requests up to
+ * max_small_size bytes are served from 64 KB chunks and recycled through a
+ * free list per 16 byte size class, bigger ones go to the global heap.
+ * Chunks are kept until the process exits so teardown of a large model only
+ * pushes nodes back onto the free lists.
+ */
+class device_arena {
+ public:
+  static constexpr std::size_t max_small_size = 256;
+
+  static void *allocate(std::size_t bytes) {
+    if (bytes > max_small_size) return ::operator new(bytes);
+    const std::size_t cls = size_class(bytes);
+    auto &a = arena();
+    std::lock_guard<std::mutex> lock{a.mutex};
+    if (free_node *node = a.free_lists[cls]) {
+      a.free_lists[cls] = node->next;
+      return node;
+    }
+    const std::size_t rounded = (cls + 1) * granularity;
+    if (static_cast<std::size_t>(a.end - a.cursor) < rounded) {
+      a.chunks.emplace_back(new char[chunk_size]);
+      a.cursor = a.chunks.back().get();
+      a.end = a.cursor + chunk_size;
+    }
+    void *ptr = a.cursor;
+    a.cursor += rounded;
+    return ptr;
+  }
+
+  static void deallocate(void *ptr, std::size_t bytes) {
+    if (!ptr) return;
+    if (bytes > max_small_size) {
+      ::operator delete(ptr);
+      return;
+    }
+    const std::size_t cls = size_class(bytes);
+    auto &a = arena();
+    std::lock_guard<std::mutex> lock{a.mutex};
+    free_node *node = static_cast<free_node *>(ptr);
+    node->next = a.free_lists[cls];
+    a.free_lists[cls] = node;
+  }
+
+  /**
+   * @brief Bytes reserved from the heap for small objects.
+   */
+  static std::size_t reserved() {
+    auto &a = arena();
+    std::lock_guard<std::mutex> lock{a.mutex};
+    return a.chunks.size() * chunk_size;
+  }
+
+ private:
+  static constexpr std::size_t granularity = alignof(std::max_align_t);
+  static constexpr std::size_t chunk_size = 64 * 1024;
+  static constexpr std::size_t class_count = max_small_size / granularity;
+
+  struct free_node {
+    free_node *next;
+  };
+  struct state {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char *cursor{nullptr};
+    char *end{nullptr};
+    free_node *free_lists[class_count]{};
+  };
+
+  static std::size_t size_class(std::size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / granularity;
+  }
+  static state &arena() {
+    // Intentionally leaked, see device_string_pool::pool().
+    static state *s = new state;
+    return *s;
+  }
+};
+
+/**
+ * @brief Standard allocator backed by device_arena.
+ */
+template <typename T>
+class arena_allocator {
+ public:
+  using value_type = T;
+
+  arena_allocator() = default;
+  template <typename U>
+  arena_allocator(const arena_allocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(device_arena::allocate(n * sizeof(T)));
+  }
+  void deallocate(T *ptr, std::size_t n) {
+    device_arena::deallocate(ptr, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const arena_allocator<U> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const arena_allocator<U> &) const {
+    return false;
+  }
+};
+
+/**
+ * @class device_map
+ * @brief Name keyed map used by device blocks and instances. Lookups by
+ * string neither intern the string nor lock the pool, only operator[]
+ * interns the new keys.
+ */
+template <typename T>
+class device_map
+    : public std::unordered_map<
+          device_name, T, device_name_hash, std::equal_to<device_name>,
+          arena_allocator<std::pair<const device_name, T>>> {
+  using base = std::unordered_map<
+      device_name, T, device_name_hash, std::equal_to<device_name>,
+      arena_allocator<std::pair<const device_name, T>>>;
+
+ public:
+  using typename base::const_iterator;
+  using typename base::iterator;
+  using typename base::size_type;
+
+  using base::base;
+  using base::at;
+  using base::count;
+  using base::erase;
+  using base::find;
+  using base::operator[];
+
+  iterator find(const std::string &key) {
+    return base::find(device_name::lookup(key));
+  }
+  const_iterator find(const std::string &key) const {
+    return base::find(device_name::lookup(key));
+  }
+  size_type count(const std::string &key) const {
+    return base::count(device_name::lookup(key));
+  }
+  size_type erase(const std::string &key) {
+    return base::erase(device_name::lookup(key));
+  }
+  T &at(const std::string &key) { return base::at(device_name::lookup(key)); }
+  const T &at(const std::string &key) const {
+    return base::at(device_name::lookup(key));
+  }
+  T &operator[](const std::string &key) {
+    auto it = find(key);
+    if (it != this->end()) return it->second;
+    return base::operator[](device_name{key});
+  }
+};
+
+/**
+ * @brief make_shared counterpart allocating object and control block from the
+ * device arena.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> make_device_shared(Args &&...args) {
+  return std::allocate_shared<T>(arena_allocator<T>{},
+                                 std::forward<Args>(args)...);
+}
@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "device_arena.h"
 #include "device_port.h"
 #include "rs_expression.h"
 #include "rs_parameter.h"
@@ -129,9 +130,7 @@ class device_block {
    *
    * @return A non-const reference to the map of device ports.
    */
-  std::unordered_map<std::string, std::shared_ptr<device_port>> &ports() {
-    return ports_map_;
-  }
+  device_map<std::shared_ptr<device_port>> &ports() { return ports_map_; }
 
   /**
    * @brief Returns a reference to the map of device ports.
@@ -140,8 +139,7 @@ class device_block {
    *
    * @return A const reference to the map of device ports.
    */
-  const std::unordered_map<std::string, std::shared_ptr<device_port>> &ports()
-      const {
+  const device_map<std::shared_ptr<device_port>> &ports() const {
     return ports_map_;
   }
 
@@ -189,8 +187,7 @@ class device_block {
    *
    * @return A non-const reference to the map of device signals.
    */
-  std::unordered_map<std::string, std::shared_ptr<device_signal>>
-      &device_signals() {
+  device_map<std::shared_ptr<device_signal>> &device_signals() {
     return signals_map_;
   }
 
@@ -201,8 +198,7 @@ class device_block {
    *
    * @return A const reference to the map of device signals.
    */
-  const std::unordered_map<std::string, std::shared_ptr<device_signal>>
-      &device_signals() const {
+  const device_map<std::shared_ptr<device_signal>> &device_signals() const {
     return signals_map_;
   }
 
@@ -249,16 +245,13 @@ class device_block {
    * @brief Get a reference to the nets map.
    * @return A reference to the nets map.
    */
-  std::unordered_map<std::string, std::shared_ptr<device_net>> &nets() {
-    return nets_map_;
-  }
+  device_map<std::shared_ptr<device_net>> &nets() { return nets_map_; }
 
   /**
    * @brief Get a const reference to the nets map.
    * @return A const reference to the nets map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<device_net>> &nets()
-      const {
+  const device_map<std::shared_ptr<device_net>> &nets() const {
     return nets_map_;
   }
 
@@ -266,8 +259,7 @@ class device_block {
    * @brief Get a reference to the double parameters map.
    * @return A reference to the double parameters map.
    */
-  std::unordered_map<std::string, std::shared_ptr<Parameter<double>>>
-      &double_parameters() {
+  device_map<std::shared_ptr<Parameter<double>>> &double_parameters() {
     return double_parameters_map_;
   }
 
@@ -275,7 +267,7 @@ class device_block {
    * @brief Get a const reference to the double parameters map.
    * @return A const reference to the double parameters map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<Parameter<double>>>
+  const device_map<std::shared_ptr<Parameter<double>>>
       &double_parameters() const {
     return double_parameters_map_;
   }
@@ -288,9 +280,8 @@ class device_block {
   void add_double_parameter(const std::string &name,
                             std::shared_ptr<Parameter<double>> param) {
     if (double_parameters_map_.find(name) != double_parameters_map_.end()) {
-      std::string err = "Double parameter " + name +
-                        " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN(
+          "Double parameter {} already exists. It will be overwritten.", name);
     }
     if (was_instanciated_) {
       throw std::runtime_error(
@@ -325,8 +316,7 @@ class device_block {
     if (double_parameters_map_.find(name) != double_parameters_map_.end()) {
       double_parameters_map_.erase(name);
     } else {
-      std::string err = "Double parameter " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Double parameter {} does not exist.", name);
     }
   }
 
@@ -334,8 +324,7 @@ class device_block {
    * @brief Get a reference to the int parameters map.
    * @return A reference to the int parameters map.
    */
-  std::unordered_map<std::string, std::shared_ptr<Parameter<int>>>
-      &int_parameters() {
+  device_map<std::shared_ptr<Parameter<int>>> &int_parameters() {
     return int_parameters_map_;
   }
 
@@ -343,8 +332,7 @@ class device_block {
    * @brief Get a const reference to the int parameters map.
    * @return A const reference to the int parameters map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<Parameter<int>>>
-      &int_parameters() const {
+  const device_map<std::shared_ptr<Parameter<int>>> &int_parameters() const {
     return int_parameters_map_;
   }
 
@@ -356,9 +344,8 @@ class device_block {
   void add_int_parameter(const std::string &name,
                          std::shared_ptr<Parameter<int>> param) {
     if (int_parameters_map_.find(name) != int_parameters_map_.end()) {
-      std::string err =
-          "Int parameter " + name + " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Int parameter {} already exists. It will be overwritten.",
+                    name);
     }
     if (was_instanciated_) {
       throw std::runtime_error(
@@ -392,8 +379,7 @@ class device_block {
     if (int_parameters_map_.find(name) != int_parameters_map_.end()) {
       int_parameters_map_.erase(name);
     } else {
-      std::string err = "Int parameter " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Int parameter {} does not exist.", name);
     }
   }
 
@@ -401,8 +387,7 @@ class device_block {
    * @brief Get a reference to the string parameters map.
    * @return A reference to the string parameters map.
    */
-  std::unordered_map<std::string, std::shared_ptr<Parameter<std::string>>>
-      &string_parameters() {
+  device_map<std::shared_ptr<Parameter<std::string>>> &string_parameters() {
     return string_parameters_map_;
   }
 
@@ -410,7 +395,7 @@ class device_block {
    * @brief Get a const reference to the string parameters map.
    * @return A const reference to the string parameters map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<Parameter<std::string>>>
+  const device_map<std::shared_ptr<Parameter<std::string>>>
       &string_parameters() const {
     return string_parameters_map_;
   }
@@ -423,9 +408,8 @@ class device_block {
   void add_string_parameter(const std::string &name,
                             std::shared_ptr<Parameter<std::string>> param) {
     if (string_parameters_map_.find(name) != string_parameters_map_.end()) {
-      std::string err = "String parameter " + name +
-                        " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN(
+          "String parameter {} already exists. It will be overwritten.", name);
     }
     if (was_instanciated_) {
       throw std::runtime_error(
@@ -460,8 +444,7 @@ class device_block {
     if (string_parameters_map_.find(name) != string_parameters_map_.end()) {
       string_parameters_map_.erase(name);
     } else {
-      std::string err = "String parameter " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("String parameter {} does not exist.", name);
     }
   }
 
@@ -469,8 +452,7 @@ class device_block {
    * @brief Get a reference to the attributes map.
    * @return A reference to the attributes map.
    */
-  std::unordered_map<std::string, std::shared_ptr<Parameter<int>>>
-      &attributes() {
+  device_map<std::shared_ptr<Parameter<int>>> &attributes() {
     return attributes_map_;
   }
 
@@ -478,8 +460,7 @@ class device_block {
    * @brief Get a const reference to the attributes map.
    * @return A const reference to the attributes map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<Parameter<int>>>
-      &attributes() const {
+  const device_map<std::shared_ptr<Parameter<int>>> &attributes() const {
     return attributes_map_;
   }
 
@@ -491,9 +472,8 @@ class device_block {
   void add_attribute(const std::string &name,
                      std::shared_ptr<Parameter<int>> attr) {
     if (attributes_map_.find(name) != attributes_map_.end()) {
-      std::string err =
-          "Attribute " + name + " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Attribute {} already exists. It will be overwritten.",
+                    name);
     }
     if (was_instanciated_) {
       throw std::runtime_error(
@@ -516,8 +496,7 @@ class device_block {
       return attributes_map_[name];
     } else {
       if (!no_warning) {
-        std::string err = "Attribute " + name + " does not exist.";
-        spdlog::warn(err.c_str());
+        SPEEDLOG_WARN("Attribute {} does not exist.", name);
       }
       return nullptr;
     }
@@ -531,8 +510,7 @@ class device_block {
     if (attributes_map_.find(name) != attributes_map_.end()) {
       attributes_map_.erase(name);
     } else {
-      std::string err = "Attribute " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Attribute {} does not exist.", name);
     }
   }
 
@@ -540,8 +518,7 @@ class device_block {
    * @brief Get a reference to the instance map.
    * @return A reference to the instance map.
    */
-  std::unordered_map<std::string, std::shared_ptr<device_block_instance>>
-      &instances() {
+  device_map<std::shared_ptr<device_block_instance>> &instances() {
     return instance_map_;
   }
 
@@ -549,8 +526,7 @@ class device_block {
    * @brief Get a const reference to the instance map.
    * @return A const reference to the instance map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<device_block_instance>>
-      &instances() const {
+  const device_map<std::shared_ptr<device_block_instance>> &instances() const {
     return instance_map_;
   }
 
@@ -567,9 +543,8 @@ class device_block {
           " should be added to an already instanciated block " + block_name_);
     }
     if (instance_map_.find(name) != instance_map_.end()) {
-      std::string err =
-          "Instance " + name + " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Instance {} already exists. It will be overwritten.",
+                    name);
     }
     instance_map_[name] = std::move(instance);
   }
@@ -584,8 +559,7 @@ class device_block {
     if (instance_map_.find(name) != instance_map_.end()) {
       return instance_map_[name];
     } else {
-      std::string err = "Instance " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Instance {} does not exist.", name);
       return nullptr;
     }
   }
@@ -598,8 +572,7 @@ class device_block {
     if (instance_map_.find(name) != instance_map_.end()) {
       instance_map_.erase(name);
     } else {
-      std::string err = "Instance " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Instance {} does not exist.", name);
     }
   }
 
@@ -607,8 +580,7 @@ class device_block {
    * @brief Get a reference to the constraint map.
    * @return A reference to the constraint map.
    */
-  std::unordered_map<std::string, std::shared_ptr<rs_expression<int>>>
-      &constraints() {
+  device_map<std::shared_ptr<rs_expression<int>>> &constraints() {
     return constraint_map_;
   }
 
@@ -616,8 +588,7 @@ class device_block {
    * @brief Get a const reference to the constraint map.
    * @return A const reference to the constraint map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<rs_expression<int>>>
-      &constraints() const {
+  const device_map<std::shared_ptr<rs_expression<int>>> &constraints() const {
     return constraint_map_;
   }
 
@@ -634,9 +605,8 @@ class device_block {
           " should be added to an already instanciated block " + block_name_);
     }
     if (constraint_map_.find(name) != constraint_map_.end()) {
-      std::string err =
-          "Constraint " + name + " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Constraint {} already exists. It will be overwritten.",
+                    name);
     }
     constraint_map_[name] = std::move(constraint);
   }
@@ -651,8 +621,7 @@ class device_block {
     if (constraint_map_.find(name) != constraint_map_.end()) {
       return constraint_map_[name];
     } else {
-      std::string err = "Constraint " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Constraint {} does not exist.", name);
       return nullptr;
     }
   }
@@ -665,8 +634,7 @@ class device_block {
     if (constraint_map_.find(name) != constraint_map_.end()) {
       constraint_map_.erase(name);
     } else {
-      std::string err = "Constraint " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Constraint {} does not exist.", name);
     }
   }
 
@@ -710,20 +678,33 @@ class device_block {
    */
   void remove_enum_type(const std::string &name) { enum_types_.erase(name); }
 
+  /**
+   * @brief Get a reference to the enum types map.
+   * @return A reference to the enum types map.
+   */
+  device_map<std::shared_ptr<ParameterType<int>>> &enum_types() {
+    return enum_types_;
+  }
+
+  /**
+   * @brief Get a const reference to the enum types map.
+   * @return A const reference to the enum types map.
+   */
+  const device_map<std::shared_ptr<ParameterType<int>>> &enum_types() const {
+    return enum_types_;
+  }
+
   /**
    * @brief Get a reference to the block map.
    * @return A reference to the block map.
    */
-  std::unordered_map<std::string, std::shared_ptr<device_block>> &blocks() {
-    return block_map_;
-  }
+  device_map<std::shared_ptr<device_block>> &blocks() { return block_map_; }
 
   /**
    * @brief Get a const reference to the block map.
    * @return A const reference to the block map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<device_block>> &blocks()
-      const {
+  const device_map<std::shared_ptr<device_block>> &blocks() const {
     return block_map_;
   }
 
@@ -734,9 +715,7 @@ class device_block {
    */
   void add_block(const std::string &name, std::shared_ptr<device_block> block) {
     if (block_map_.find(name) != block_map_.end()) {
-      std::string err =
-          "Block " + name + " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Block {} already exists. It will be overwritten.", name);
     }
     block_map_[name] = std::move(block);
   }
@@ -748,9 +727,7 @@ class device_block {
   void add_block(std::shared_ptr<device_block> block) {
     std::string name = block->block_name();
     if (block_map_.find(name) != block_map_.end()) {
-      std::string err =
-          "Block " + name + " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Block {} already exists. It will be overwritten.", name);
     }
     block_map_[name] = std::move(block);
   }
@@ -780,8 +757,7 @@ class device_block {
     if (block_map_.find(name) != block_map_.end()) {
       block_map_.erase(name);
     } else {
-      std::string err = "Block " + name + " does not exist for deletion.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Block {} does not exist for deletion.", name);
     }
   }
 
@@ -789,8 +765,7 @@ class device_block {
    * @brief Get a reference to the double parameter types map.
    * @return A reference to the double parameter types map.
    */
-  std::unordered_map<std::string, std::shared_ptr<ParameterType<double>>>
-      &double_parameter_types() {
+  device_map<std::shared_ptr<ParameterType<double>>> &double_parameter_types() {
     return double_parameter_types_map_;
   }
 
@@ -798,7 +773,7 @@ class device_block {
    * @brief Get a const reference to the double parameter types map.
    * @return A const reference to the double parameter types map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<ParameterType<double>>>
+  const device_map<std::shared_ptr<ParameterType<double>>>
       &double_parameter_types() const {
     return double_parameter_types_map_;
   }
@@ -818,9 +793,9 @@ class device_block {
     }
     if (double_parameter_types_map_.find(name) !=
         double_parameter_types_map_.end()) {
-      std::string err = "Double parameter type " + name +
-                        " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN(
+          "Double parameter type {} already exists. It will be overwritten.",
+          name);
     }
     double_parameter_types_map_[name] = std::move(paramType);
   }
@@ -854,8 +829,7 @@ class device_block {
         double_parameter_types_map_.end()) {
       double_parameter_types_map_.erase(name);
     } else {
-      std::string err = "Double parameter type " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Double parameter type {} does not exist.", name);
     }
   }
 
@@ -863,8 +837,7 @@ class device_block {
    * @brief Get a reference to the int parameter types map.
    * @return A reference to the int parameter types map.
    */
-  std::unordered_map<std::string, std::shared_ptr<ParameterType<int>>>
-      &int_parameter_types() {
+  device_map<std::shared_ptr<ParameterType<int>>> &int_parameter_types() {
     return int_parameter_types_map_;
   }
 
@@ -872,7 +845,7 @@ class device_block {
    * @brief Get a const reference to the int parameter types map.
    * @return A const reference to the int parameter types map.
    */
-  const std::unordered_map<std::string, std::shared_ptr<ParameterType<int>>>
+  const device_map<std::shared_ptr<ParameterType<int>>>
       &int_parameter_types() const {
     return int_parameter_types_map_;
   }
@@ -890,9 +863,9 @@ class device_block {
           " should be added to an already instanciated block " + block_name_);
     }
     if (int_parameter_types_map_.find(name) != int_parameter_types_map_.end()) {
-      std::string err = "Int parameter type " + name +
-                        " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN(
+          "Int parameter type {} already exists. It will be overwritten.",
+          name);
     }
     int_parameter_types_map_[name] = std::move(paramType);
   }
@@ -923,8 +896,7 @@ class device_block {
     if (int_parameter_types_map_.find(name) != int_parameter_types_map_.end()) {
       int_parameter_types_map_.erase(name);
     } else {
-      std::string err = "Int parameter type " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("Int parameter type {} does not exist.", name);
     }
   }
 
@@ -932,7 +904,7 @@ class device_block {
    * @brief Get a reference to the string parameter types map.
    * @return A reference to the string parameter types map.
    */
-  std::unordered_map<std::string, std::shared_ptr<ParameterType<std::string>>>
+  device_map<std::shared_ptr<ParameterType<std::string>>>
       &string_parameter_types() {
     return string_parameter_types_map_;
   }
@@ -941,8 +913,7 @@ class device_block {
    * @brief Get a const reference to the string parameter types map.
    * @return A const reference to the string parameter types map.
    */
-  const std::unordered_map<std::string,
-                           std::shared_ptr<ParameterType<std::string>>>
+  const device_map<std::shared_ptr<ParameterType<std::string>>>
       &string_parameter_types() const {
     return string_parameter_types_map_;
   }
@@ -962,9 +933,9 @@ class device_block {
     }
     if (string_parameter_types_map_.find(name) !=
         string_parameter_types_map_.end()) {
-      std::string err = "String parameter type " + name +
-                        " already exists. It will be overwritten.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN(
+          "String parameter type {} already exists. It will be overwritten.",
+          name);
     }
     string_parameter_types_map_[name] = std::move(paramType);
   }
@@ -998,8 +969,7 @@ class device_block {
         string_parameter_types_map_.end()) {
       string_parameter_types_map_.erase(name);
     } else {
-      std::string err = "String parameter type " + name + " does not exist.";
-      spdlog::warn(err.c_str());
+      SPEEDLOG_WARN("String parameter type {} does not exist.", name);
     }
   }
 
@@ -1115,6 +1085,16 @@ class device_block {
     return block_chains_.find(key) != block_chains_.end();
   }
 
+  /**
+   * @brief Get all the block chains of the block.
+   * @return A const reference to the block chains map.
+   */
+  const std::unordered_map<std::string,
+                           std::vector<std::shared_ptr<device_block>>> &
+  block_chains() const {
+    return block_chains_;
+  }
+
   /**
    * @brief Get the value of a property in the property map.
    *
@@ -1167,6 +1147,14 @@ class device_block {
     return false;  // Property not found
   }
 
+  /**
+   * @brief Get all the properties of the block.
+   * @return A const reference to the property map.
+   */
+  const std::unordered_map<std::string, std::string> &properties() const {
+    return property_map_;
+  }
+
   // Overload of the operator <<
   friend ostream &operator<<(ostream &os, device_block &block) {
     os << "Device block: " << block.block_name() << "\n";
@@ -1329,6 +1317,14 @@ class device_block {
                              " does not exist in model mapping.");
   }
 
+  /**
+   * @brief Get all the model to customer name mappings.
+   * @return A const reference to the model to customer name map.
+   */
+  const std::unordered_map<std::string, std::string> &model_mappings() const {
+    return modelToCustMap_;
+  }
+
   /**
    * @brief Removes a mapping for a given model name.
    *
@@ -1434,55 +1430,47 @@ class device_block {
   std::string block_type_ = "block";
 
   /// Map holding all the ports of the device block.
-  std::unordered_map<std::string, std::shared_ptr<device_port>> ports_map_;
+  device_map<std::shared_ptr<device_port>> ports_map_;
 
   /// Map holding all the signals of the device block.
-  std::unordered_map<std::string, std::shared_ptr<device_signal>> signals_map_;
+  device_map<std::shared_ptr<device_signal>> signals_map_;
 
   /// Map holding all the nets of the device block.
-  std::unordered_map<std::string, std::shared_ptr<device_net>> nets_map_;
+  device_map<std::shared_ptr<device_net>> nets_map_;
 
   /// Map holding all the double parameters of the device block.
-  std::unordered_map<std::string, std::shared_ptr<Parameter<double>>>
-      double_parameters_map_;
+  device_map<std::shared_ptr<Parameter<double>>> double_parameters_map_;
 
   /// Map holding all the integer parameters of the device block.
-  std::unordered_map<std::string, std::shared_ptr<Parameter<int>>>
-      int_parameters_map_;
+  device_map<std::shared_ptr<Parameter<int>>> int_parameters_map_;
 
   /// Map holding all the string parameters of the device block.
-  std::unordered_map<std::string, std::shared_ptr<Parameter<std::string>>>
-      string_parameters_map_;
+  device_map<std::shared_ptr<Parameter<std::string>>> string_parameters_map_;
 
   /// Map holding all the attributes of the device block.
-  std::unordered_map<std::string, std::shared_ptr<Parameter<int>>>
-      attributes_map_;
+  device_map<std::shared_ptr<Parameter<int>>> attributes_map_;
 
   /// Map holding all the instances of the device block.
-  std::unordered_map<std::string, std::shared_ptr<device_block_instance>>
-      instance_map_;
+  device_map<std::shared_ptr<device_block_instance>> instance_map_;
 
   /// Map holding all the constraints of the device block.
-  std::unordered_map<std::string, std::shared_ptr<rs_expression<int>>>
-      constraint_map_;
+  device_map<std::shared_ptr<rs_expression<int>>> constraint_map_;
 
   /// Map holding all the ParameterType<int> instances, representing enum types.
-  std::unordered_map<std::string, std::shared_ptr<ParameterType<int>>>
-      enum_types_;
+  device_map<std::shared_ptr<ParameterType<int>>> enum_types_;
 
   /// Map holding all the block definitions of the device block.
-  std::unordered_map<std::string, std::shared_ptr<device_block>> block_map_;
+  device_map<std::shared_ptr<device_block>> block_map_;
 
   /// Map holding all the double parameter types of the device block.
-  std::unordered_map<std::string, std::shared_ptr<ParameterType<double>>>
+  device_map<std::shared_ptr<ParameterType<double>>>
       double_parameter_types_map_;
 
   /// Map holding all the int parameter types of the device block.
-  std::unordered_map<std::string, std::shared_ptr<ParameterType<int>>>
-      int_parameter_types_map_;
+  device_map<std::shared_ptr<ParameterType<int>>> int_parameter_types_map_;
 
   /// Map holding all the string parameter types of the device block.
-  std::unordered_map<std::string, std::shared_ptr<ParameterType<std::string>>>
+  device_map<std::shared_ptr<ParameterType<std::string>>>
       string_parameter_types_map_;
 
   /// Vector of instance references
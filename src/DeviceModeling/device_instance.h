@@ -54,16 +54,16 @@ class device_block_instance {
     }
     for (const auto &pr : instaciated_block_ptr_->instances()) {
       this->instance_map_[pr.first] =
-          std::make_shared<device_block_instance>(*pr.second);
+          make_device_shared<device_block_instance>(*pr.second);
     }
     for (const auto &pr : instaciated_block_ptr_->ports()) {
-      this->ports_map_[pr.first] = std::make_shared<device_port>(*pr.second);
+      this->ports_map_[pr.first] = make_device_shared<device_port>(*pr.second);
       ports_map_[pr.first]->set_enclosing_instance(this);
     }
     for (const auto &pr : instaciated_block_ptr_->nets()) {
       // create nets without their driver and sinks until full
       // elaboration
-      this->nets_map_[pr.first] = std::make_shared<device_net>(pr.first);
+      this->nets_map_[pr.first] = make_device_shared<device_net>(pr.first);
       if (ports_map_[pr.first])
         ports_map_[pr.first]->set_enclosing_instance(this);
       // std::cout << "Port Net :: " << pr.first << std::endl;
@@ -246,16 +246,15 @@ class device_block_instance {
   std::shared_ptr<device_block> instaciated_block_ptr_ = nullptr;
   std::string instance_name_ = "__default_instance_name__";
   std::string io_bank_ = "__default_io_bank_name__";
-  std::unordered_map<std::string, int> attributes_;
-  std::unordered_map<std::string, int> int_params_;
-  std::unordered_map<std::string, double> double_params_;
-  std::unordered_map<std::string, std::string> string_params_;
+  device_map<int> attributes_;
+  device_map<int> int_params_;
+  device_map<double> double_params_;
+  device_map<std::string> string_params_;
   /// Map holding all the instances of the current instance.
-  std::unordered_map<std::string, std::shared_ptr<device_block_instance>>
-      instance_map_;
-  std::unordered_map<std::string, std::shared_ptr<device_port>> ports_map_;
+  device_map<std::shared_ptr<device_block_instance>> instance_map_;
+  device_map<std::shared_ptr<device_port>> ports_map_;
   /// Map holding all the nets of the device block.
-  std::unordered_map<std::string, std::shared_ptr<device_net>> nets_map_;
+  device_map<std::shared_ptr<device_net>> nets_map_;
 };
 
 // Logging
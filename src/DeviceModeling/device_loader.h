@@ -0,0 +1,327 @@
+/**
+ * @file device_loader.h
+ * @brief Native loader for device model description files.
+ *
+ * Device descriptions are mostly flat lists of declarative commands
+ * (define_block, define_attr, create_instance, set_phy_address, ...). The
+ * loader splits a file into commands with the Tcl word rules, dispatches the
+ * declarative ones straight to the device_modeler and hands everything that
+ * needs the interpreter (variables, command substitution, control flow,
+ * procedures, unknown commands) to a fallback, in file order.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "device_modeler.h"
+
+/**
+ * @class device_loader
+ * @brief Loads device description files without a Tcl round trip per line.
+ */
+class device_loader {
+ public:
+  /**
+   * @brief Evaluates a command the loader can not run natively.
+   * @param command The command text as written in the file.
+   * @param error Set to the error message on failure.
+   * @return True on success.
+   */
+  using fallback_t =
+      std::function<bool(const std::string &command, std::string &error)>;
+
+  struct stats {
+    size_t native = 0;    ///< Commands dispatched to the modeler.
+    size_t fallback = 0;  ///< Commands handed to the fallback.
+  };
+
+  /**
+   * @brief Construct a loader.
+   * @param modeler The modeler receiving the declarative commands.
+   * @param fallback Evaluator for the other commands, usually the Tcl
+   * interpreter. Without it such commands are reported as errors.
+   */
+  explicit device_loader(device_modeler &modeler, fallback_t fallback = nullptr)
+      : modeler_(modeler), fallback_(std::move(fallback)) {}
+
+  /**
+   * @brief Load a device description file.
+   * @param path The file to load.
+   * @throws std::runtime_error If the file can not be read or a command fails,
+   * the message carries the file name and line of the command.
+   */
+  void load_file(const std::string &path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+      throw std::runtime_error("Unable to open device description " + path);
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    load(buffer.str(), path);
+  }
+
+  /**
+   * @brief Load device description commands from memory.
+   * @param text The commands.
+   * @param source Name used in error messages.
+   * @throws std::runtime_error If a command fails.
+   */
+  void load(std::string_view text, const std::string &source = "<string>") {
+    text_ = text;
+    pos_ = 0;
+    line_ = 1;
+    try {
+      while (next_command()) {
+        if (words_.empty()) continue;
+        if (!dynamic_ && run_native()) {
+          ++stats_.native;
+          continue;
+        }
+        run_fallback();
+        ++stats_.fallback;
+      }
+    } catch (const std::exception &e) {
+      throw std::runtime_error(source + ":" + std::to_string(command_line_) +
+                               ": " + e.what());
+    }
+  }
+
+  const stats &get_stats() const { return stats_; }
+
+ private:
+  using command_t = std::function<bool(device_modeler &, int, const char **)>;
+
+  // Commands that only declare or update the model and return no value.
+  static const std::unordered_map<std::string_view, command_t> &commands() {
+    static const std::unordered_map<std::string_view, command_t> table = {
+        {"device_name", &device_modeler::device_name},
+        {"undefine_device", &device_modeler::undefine_device},
+        {"device_version", &device_modeler::device_version},
+        {"schema_version", &device_modeler::schema_version},
+        {"define_enum_type", &device_modeler::define_enum_type},
+        {"define_block", &device_modeler::define_block},
+        {"define_ports", &device_modeler::define_ports},
+        {"define_param_type", &device_modeler::define_param_type},
+        {"define_param", &device_modeler::define_param},
+        {"define_attr",
+         [](device_modeler &m, int argc, const char **argv) {
+           return m.define_attr(argc, argv);
+         }},
+        {"define_constraint", &device_modeler::define_constraint},
+        {"create_instance", &device_modeler::create_instance},
+        {"define_properties", &device_modeler::define_properties},
+        {"define_net", &device_modeler::define_net},
+        {"map_rtl_user_names", &device_modeler::map_rtl_user_names},
+        {"map_model_user_names", &device_modeler::map_model_user_names},
+        {"define_chain", &device_modeler::define_chain},
+        {"add_block_to_chain_type", &device_modeler::add_block_to_chain_type},
+        {"create_instance_chain", &device_modeler::create_instance_chain},
+        {"append_instance_to_chain",
+         &device_modeler::append_instance_to_chain},
+        {"set_io_bank", &device_modeler::set_io_bank},
+        {"set_logic_location", &device_modeler::set_logic_location},
+        {"set_logic_address", &device_modeler::set_logic_address},
+        {"set_phy_address", &device_modeler::set_phy_address}};
+    return table;
+  }
+
+  bool run_native() {
+    auto it = commands().find(words_.front());
+    if (it == commands().end()) return false;
+    argv_.clear();
+    for (const auto &word : words_) argv_.push_back(word.c_str());
+    if (!it->second(modeler_, static_cast<int>(argv_.size()), argv_.data())) {
+      throw std::runtime_error("Command " + words_.front() + " failed");
+    }
+    return true;
+  }
+
+  void run_fallback() {
+    std::string command{text_.substr(command_begin_, pos_ - command_begin_)};
+    if (!fallback_) {
+      throw std::runtime_error("Command \"" + words_.front() +
+                               "\" needs the Tcl interpreter");
+    }
+    std::string error;
+    if (!fallback_(command, error)) {
+      throw std::runtime_error(error.empty() ? "Command " + words_.front() +
+                                                   " failed"
+                                             : error);
+    }
+  }
+
+  bool at_end() const { return pos_ >= text_.size(); }
+  char peek() const { return text_[pos_]; }
+  bool is_blank(char c) const { return c == ' ' || c == '\t' || c == '\r'; }
+  bool is_continuation() const {
+    return peek() == '\\' && pos_ + 1 < text_.size() &&
+           text_[pos_ + 1] == '\n';
+  }
+  void advance() {
+    if (text_[pos_++] == '\n') ++line_;
+  }
+
+  void skip_blanks() {
+    while (!at_end()) {
+      if (is_blank(peek())) {
+        ++pos_;
+      } else if (is_continuation()) {
+        pos_ += 2;
+        ++line_;
+      } else {
+        break;
+      }
+    }
+  }
+
+  // Splits the next command into words. Returns false at the end of the text.
+  bool next_command() {
+    words_.clear();
+    dynamic_ = false;
+    // Skip separators and comments between commands.
+    while (true) {
+      skip_blanks();
+      if (at_end()) return false;
+      if (peek() == '\n' || peek() == ';') {
+        advance();
+      } else if (peek() == '#') {
+        while (!at_end() && peek() != '\n') {
+          if (is_continuation()) advance();
+          advance();
+        }
+      } else {
+        break;
+      }
+    }
+    command_begin_ = pos_;
+    command_line_ = line_;
+    while (true) {
+      skip_blanks();
+      if (at_end() || peek() == '\n' || peek() == ';') break;
+      words_.emplace_back();
+      read_word(words_.back());
+    }
+    return true;
+  }
+
+  void read_word(std::string &word) {
+    if (peek() == '{') {
+      read_braced(word);
+    } else if (peek() == '"') {
+      advance();
+      while (!at_end() && peek() != '"') read_char(word);
+      if (at_end()) throw_unterminated("quote");
+      advance();
+    } else {
+      while (!at_end() && !is_blank(peek()) && peek() != '\n' &&
+             peek() != ';') {
+        read_char(word);
+      }
+      return;
+    }
+    // Tcl rejects extra characters after a closing brace or quote and {*}
+    // expands its word, both are left to the interpreter.
+    if (!at_end() && !is_blank(peek()) && peek() != '\n' && peek() != ';') {
+      dynamic_ = true;
+      while (!at_end() && !is_blank(peek()) && peek() != '\n' &&
+             peek() != ';') {
+        read_char(word);
+      }
+    }
+  }
+
+  // Braced words are taken literally, only backslash-newline is replaced.
+  void read_braced(std::string &word) {
+    size_t depth = 1;
+    advance();
+    while (!at_end()) {
+      char c = peek();
+      if (c == '\\' && pos_ + 1 < text_.size()) {
+        if (text_[pos_ + 1] == '\n') {
+          word += ' ';
+          pos_ += 2;
+          ++line_;
+          skip_blanks();
+          continue;
+        }
+        word += c;
+        advance();
+        word += peek();
+        advance();
+        continue;
+      }
+      if (c == '{') {
+        ++depth;
+      } else if (c == '}' && --depth == 0) {
+        advance();
+        return;
+      }
+      word += c;
+      advance();
+    }
+    throw_unterminated("brace");
+  }
+
+  // Characters of bare and quoted words. Substitutions are skipped over so
+  // the command boundaries stay right, the command goes to the fallback.
+  void read_char(std::string &word) {
+    char c = peek();
+    if (c == '$' || c == '\\') {
+      dynamic_ = true;
+      word += c;
+      advance();
+      if (!at_end()) {
+        word += peek();
+        advance();
+      }
+      return;
+    }
+    if (c == '[') {
+      dynamic_ = true;
+      size_t depth = 0;
+      while (!at_end()) {
+        c = peek();
+        word += c;
+        advance();
+        if (c == '\\' && !at_end()) {
+          word += peek();
+          advance();
+        } else if (c == '[') {
+          ++depth;
+        } else if (c == ']' && --depth == 0) {
+          return;
+        }
+      }
+      throw_unterminated("bracket");
+    }
+    word += c;
+    advance();
+  }
+
+  [[noreturn]] void throw_unterminated(const char *what) const {
+    throw std::runtime_error(std::string{"missing close-"} + what);
+  }
+
+  device_modeler &modeler_;
+  fallback_t fallback_;
+  stats stats_;
+  std::string_view text_;
+  size_t pos_ = 0;
+  size_t line_ = 1;
+  size_t command_begin_ = 0;
+  size_t command_line_ = 1;
+  bool dynamic_ = false;
+  std::vector<std::string> words_;
+  std::vector<const char *> argv_;
+};
@@ -24,6 +24,8 @@
 #include "Configuration/CFGCommon/CFGCommon.h"
 #include "Utils/StringUtils.h"
 #include "device.h"
+#include "device_address_index.h"
+#include "device_snapshot.h"
 #include "speedlog.h"
 
 /**
@@ -96,6 +98,7 @@ class device_modeler {
       throw std::invalid_argument(s.c_str());
     }
     std::string name = argv[1];
+    address_index_.reset();
     current_device_ = get_device(name);
     if (!current_device_) {
       current_device_ = std::make_shared<device>(name);
@@ -121,6 +124,7 @@ class device_modeler {
       throw std::invalid_argument(s.c_str());
     }
     std::string name = argv[1];
+    address_index_.reset();
     if (devices_.find(name) != devices_.end()) {
       devices_.erase(name);
     }
@@ -164,8 +168,54 @@ class device_modeler {
     current_device_->set_schema_version(argv[1]);
     return true;
   }
+  /**
+   * @brief Save a device as a binary snapshot.
+   *
+   * Example command: save_device_snapshot -file gemini.snapshot -device GEMINI
+   *
+   * @param argc The number of arguments.
+   * @param argv The arguments array. -file is required, -device defaults to
+   * the current device.
+   * @return A boolean indicating whether the operation was successful.
+   * @throws std::runtime_error if the device does not exist or the file can not
+   * be written.
+   */
+  bool save_device_snapshot(int argc, const char **argv) {
+    std::string file = get_argument_value("-file", argc, argv, true);
+    std::string name = get_argument_value("-device", argc, argv);
+    std::shared_ptr<device> dev =
+        name.empty() ? current_device_ : get_device(name);
+    if (!dev) {
+      throw std::runtime_error("No device found: " + name);
+    }
+    device_snapshot::save(*dev, file);
+    return true;
+  }
+
+  /**
+   * @brief Load a device from a binary snapshot and make it current.
+   *
+   * A device with the same name is replaced.
+   *
+   * Example command: load_device_snapshot -file gemini.snapshot
+   *
+   * @param argc The number of arguments.
+   * @param argv The arguments array.
+   * @return A boolean indicating whether the operation was successful.
+   * @throws std::runtime_error if the file is not a valid snapshot.
+   */
+  bool load_device_snapshot(int argc, const char **argv) {
+    std::string file = get_argument_value("-file", argc, argv, true);
+    auto dev = device_snapshot::load(file);
+    devices_[dev->device_name()] = dev;
+    current_device_ = dev;
+    address_index_.reset();
+    return true;
+  }
+
   void reset_current_device() {
     current_device_ = nullptr;  // method to reset the state
+    address_index_.reset();
   }
   std::shared_ptr<device> get_current_device() { return current_device_; }
   std::vector<std::string> split_string_by_space(
@@ -202,8 +252,8 @@ class device_modeler {
       std::string blockName = ss.str();
       auto block = std::make_shared<device_block>(blockName);
       for (int k = 0; k <= in_cnt; k++) {
-        block->add_port(std::make_shared<device_port>(ports[k].second,
-                                                      ports[k].first == "in"));
+        block->add_port(make_device_shared<device_port>(
+            ports[k].second, ports[k].first == "in"));
       }
       current_device_->add_block(block);
       const int argc = 11;
@@ -350,9 +400,8 @@ class device_modeler {
     try {
       block->get_enum_type(enumName);
       if (!force) {
-        std::string err = "Enum type " + enumName +
-                          " already exists. Use -force to override.";
-        spdlog::warn(err.c_str());
+        SPEEDLOG_WARN("Enum type {} already exists. Use -force to override.",
+                      enumName);
         return false;
       }
       block->add_enum_type(enumName, newEnum);
@@ -395,7 +444,8 @@ class device_modeler {
     auto block = std::make_shared<device_block>(blockName);
 
     for (auto &p : ports) {
-      block->add_port(std::make_shared<device_port>(p.second, p.first == "in"));
+      block->add_port(
+          make_device_shared<device_port>(p.second, p.first == "in"));
     }
 
     current_device_->add_block(block);
@@ -461,7 +511,8 @@ class device_modeler {
     }
     // Add new ports to the fetched block.
     for (auto &p : ports) {
-      block->add_port(std::make_shared<device_port>(p.second, p.first == "in"));
+      block->add_port(
+          make_device_shared<device_port>(p.second, p.first == "in"));
     }
 
     return true;
@@ -504,8 +555,8 @@ class device_modeler {
 
     // Add new ports to the fetched block.
     for (auto &p : ports) {
-      block->add_port(std::make_shared<device_port>(p.second, p.first == "in",
-                                                    nullptr, block.get()));
+      block->add_port(make_device_shared<device_port>(
+          p.second, p.first == "in", nullptr, block.get()));
       // std::cout << "Done creating port " << p.second << std::endl;
     }
     for (auto &p : ports) {
@@ -707,7 +758,7 @@ class device_modeler {
     }
     if (type_name == "int") {
       auto tp = current_device_->get_int_parameter_type("int");
-      auto par_t = std::make_shared<Parameter<int>>(par_name, 0, tp);
+      auto par_t = make_device_shared<Parameter<int>>(par_name, 0, tp);
       if (!width.empty()) {
         unsigned size = (unsigned)(convert_string_to_integer(width));
         par_t->set_size(size);
@@ -721,17 +772,18 @@ class device_modeler {
     } else if (type_name == "double") {
       auto tp = current_device_->get_double_parameter_type("double");
       block->add_double_parameter(
-          par_name, std::make_shared<Parameter<double>>(par_name, 0, tp));
+          par_name, make_device_shared<Parameter<double>>(par_name, 0, tp));
       return true;
     } else if (type_name == "string") {
       auto tp = current_device_->get_string_parameter_type("string");
       block->add_string_parameter(
-          par_name, std::make_shared<Parameter<std::string>>(par_name, "", tp));
+          par_name,
+          make_device_shared<Parameter<std::string>>(par_name, "", tp));
       return true;
     }
     auto tpint = block->get_int_parameter_type(type_name);
     if (tpint.get()) {
-      auto par_t = std::make_shared<Parameter<int>>(par_name, 0, tpint);
+      auto par_t = make_device_shared<Parameter<int>>(par_name, 0, tpint);
       if (!addr.empty()) {
         unsigned addr_num = convert_string_to_integer(addr);
         par_t->set_address(addr_num);
@@ -741,15 +793,16 @@ class device_modeler {
     }
     auto tpdouble = block->get_double_parameter_type(type_name);
     if (tpdouble.get()) {
-      block->add_double_parameter(par_name, std::make_shared<Parameter<double>>(
-                                                par_name, 0.0, tpdouble));
+      block->add_double_parameter(
+          par_name,
+          make_device_shared<Parameter<double>>(par_name, 0.0, tpdouble));
       return true;
     }
     auto tpstring = block->get_string_parameter_type(type_name);
     if (tpstring.get()) {
       block->add_string_parameter(
           par_name,
-          std::make_shared<Parameter<std::string>>(par_name, "", tpstring));
+          make_device_shared<Parameter<std::string>>(par_name, "", tpstring));
       return true;
     }
     // error out if something is invalid
@@ -876,12 +929,13 @@ class device_modeler {
       type->set_upper_bound(upper);
     }
     block->add_enum_type(enum_name, type);
-    auto attr = std::make_shared<Parameter<int>>(attr_name, 0, type);
+    auto attr = make_device_shared<Parameter<int>>(attr_name, 0, type);
     if (!addr.empty()) {
       int address = convert_string_to_integer(addr);
       attr->set_address(address);
     }
     block->add_attribute(attr_name, attr);
+    address_index_.reset();
     return true;
   }
 
@@ -930,7 +984,7 @@ class device_modeler {
     }
     std::string nm;
     if ("" == contraint_name) {
-      auto constraint_map = block->constraints();
+      const auto &constraint_map = block->constraints();
       unsigned idx = constraint_map.size();
       nm = block->block_name() + "_constraint_" + std::to_string(idx);
       while (constraint_map.find(nm) != end(constraint_map)) {
@@ -1047,11 +1101,12 @@ class device_modeler {
       logic_location_z_i = convert_string_to_integer(logic_location_z);
     }
     parent_block->instance_vector().push_back(
-        std::make_shared<device_block_instance>(
+        make_device_shared<device_block_instance>(
             block, parent_block->instance_vector().size(), logic_location_x_i,
             logic_location_y_i, logic_address_i, name, io_bank,
             logic_location_z_i));
     parent_block->add_instance(name, parent_block->instance_vector().back());
+    address_index_.reset();
     return true;
   }
   /**
@@ -1286,7 +1341,7 @@ class device_modeler {
                                ", could not find block " + block_name);
     }
     auto v = split_string_by_space(load_names);
-    block->add_net(std::make_shared<device_net>(net_name));
+    block->add_net(make_device_shared<device_net>(net_name));
     auto net_ptr = block->get_net(net_name);
     if (!driver_name.empty()) {
       std::vector<std::string> xmr_refs =
@@ -2404,6 +2459,7 @@ class device_modeler {
     // instance.
     int addr_i = convert_string_to_integer(phy_address);
     inst->set_phy_address(addr_i);
+    address_index_.reset();
 
     return true;
   }
@@ -2537,10 +2593,88 @@ class device_modeler {
     // instance.
     int addr_i = convert_string_to_integer(logic_address);
     inst->set_logic_address(addr_i);
+    address_index_.reset();
 
     return true;
   }
 
+  /**
+   * @brief Decodes a configuration address of the current device.
+   *
+   * Example command: decode_address -address 0x1a4 -phy
+   *
+   * @param argc The number of command-line arguments.
+   * @param argv An array of command-line arguments:
+   * - -address <address>: The logic address, or the physical one with -phy.
+   * - -model <block>: (Optional) The configuration model, the device name by
+   * default.
+   * - -phy: (Optional) Decode a physical address.
+   * @return The hierarchical instance name, block name, attribute name and bit
+   * holding the address.
+   * @throws std::runtime_error if there is no current device or no attribute
+   * holds the address.
+   */
+  std::vector<std::string> decode_address(int argc, const char **argv) {
+    std::string address = get_argument_value("-address", argc, argv, true);
+    std::string model = get_argument_value("-model", argc, argv);
+    bool phy = argument_exists("-phy", argc, argv);
+    uint32_t addr_i = (uint32_t)(convert_string_to_integer(address));
+    uint32_t bit = 0;
+    device_address_index &index = address_index(model);
+    const device_address_entry *entry = phy ? index.find_phy(addr_i, &bit)
+                                            : index.find_logic(addr_i, &bit);
+    if (!entry) {
+      throw std::runtime_error("No attribute at address " + address);
+    }
+    return {entry->instance, entry->block->block_name(), entry->attribute,
+            std::to_string(bit)};
+  }
+
+  /**
+   * @brief Retrieves the configuration address of an instance attribute.
+   *
+   * Example command: get_attribute_address -inst tile0.leaf0 -attr MODE -bit 1
+   *
+   * @param argc The number of command-line arguments.
+   * @param argv An array of command-line arguments:
+   * - -inst <name>: Hierarchical instance name in the model, the model name
+   * for the attributes of the model block.
+   * - -attr <name>: The attribute name.
+   * - -model <block>: (Optional) The configuration model, the device name by
+   * default.
+   * - -bit <bit>: (Optional) Bit of the attribute, 0 by default.
+   * - -phy: (Optional) Return the physical address.
+   * @return The address of the bit.
+   * @throws std::runtime_error if the attribute, the bit or the physical
+   * address does not exist.
+   */
+  int get_attribute_address(int argc, const char **argv) {
+    std::string instance_name = get_argument_value("-inst", argc, argv, true);
+    std::string attr_name = get_argument_value("-attr", argc, argv, true);
+    std::string bit = get_argument_value("-bit", argc, argv);
+    std::string model = get_argument_value("-model", argc, argv);
+    bool phy = argument_exists("-phy", argc, argv);
+    const device_address_entry *entry =
+        address_index(model).find_attribute(instance_name, attr_name);
+    if (!entry) {
+      throw std::runtime_error("Could not find attribute " + attr_name +
+                               " of instance " + instance_name);
+    }
+    int bit_i = bit.empty() ? 0 : convert_string_to_integer(bit);
+    if (bit_i < 0 || (uint32_t)(bit_i) >= entry->size) {
+      throw std::runtime_error("Bit " + bit +
+                               " is out of range for attribute " + attr_name);
+    }
+    if (!phy) {
+      return (int)(entry->logic_address) + bit_i;
+    }
+    if (entry->phy_address < 0) {
+      throw std::runtime_error("No physical address for instance " +
+                               instance_name);
+    }
+    return (int)(entry->phy_address) + bit_i;
+  }
+
   /**
    * @brief Defines a new block chain in a specified device.
    *
@@ -2941,8 +3075,29 @@ class device_modeler {
     return value;
   }
 
+  /**
+   * @brief Address index of a model of the current device, built on first use
+   * and reset by the commands changing the layout.
+   * @param model The model block, the device name when empty like for
+   * model_config set_model.
+   */
+  device_address_index &address_index(const std::string &model) {
+    if (!current_device_) {
+      throw std::runtime_error("No current device");
+    }
+    const std::string &name =
+        model.empty() ? current_device_->device_name() : model;
+    if (!address_index_ || address_index_->model() != name) {
+      address_index_.reset();
+      address_index_ =
+          std::make_unique<device_address_index>(*current_device_, name);
+    }
+    return *address_index_;
+  }
+
   std::shared_ptr<device> current_device_ =
       nullptr;  ///< The current device being worked on.
+  std::unique_ptr<device_address_index> address_index_;
   /**
    * @brief Private constructor for the singleton device_modeler.
    */
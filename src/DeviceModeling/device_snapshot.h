@@ -0,0 +1,1145 @@
+/**
+ * @file device_snapshot.h
+ * @brief Versioned binary snapshot of an elaborated device model.
+ *
+ * A snapshot flattens a device into fixed size record tables (blocks, ports,
+ * types, parameters, attributes, constraints, nets, instances, properties,
+ * mappings and chains) that refer to one shared string table by index. The
+ * file is mapped read only, validated from its header and restored without
+ * going through the Tcl device description or the expression evaluator.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "device.h"
+
+/**
+ * @class device_snapshot
+ * @brief Read only view over a device snapshot file.
+ *
+ * Opening a snapshot maps the file and checks its header, the cost does not
+ * depend on the size of the device. restore() then rebuilds the device
+ * objects directly from the record tables.
+ */
+class device_snapshot {
+ public:
+  /// Bumped whenever the layout of a record changes.
+  static constexpr uint32_t format_version = 1;
+  /// Index value used for absent strings, owners and references.
+  static constexpr uint32_t none = 0xFFFFFFFFu;
+
+  enum section : uint32_t {
+    strings_section,
+    string_data_section,
+    device_section,
+    block_section,
+    port_section,
+    int_type_section,
+    enum_value_section,
+    double_type_section,
+    string_type_section,
+    param_section,
+    constraint_section,
+    net_section,
+    net_link_section,
+    instance_section,
+    entry_section,
+    section_count
+  };
+
+  enum type_kind : uint32_t { param_type, enum_type, anonymous_type };
+  enum param_kind : uint32_t {
+    int_param,
+    double_param,
+    string_param,
+    attribute_param
+  };
+  enum entry_kind : uint32_t {
+    property_entry,
+    model_mapping_entry,
+    rtl_mapping_entry,
+    instance_chain_entry,
+    block_chain_entry,
+    instantiated_block_entry
+  };
+  enum flags : uint32_t {
+    has_lower = 1,
+    has_upper = 2,
+    has_default = 4,
+    has_size = 8,
+    has_address = 16,
+    is_evaluated = 32,
+    port_input = 64,
+    port_has_block = 128,
+    port_is_signal = 256
+  };
+
+  struct string_ref {
+    uint32_t offset;
+    uint32_t size;
+  };
+  struct device_record {
+    uint32_t name;
+    uint32_t schema_version;
+    uint32_t device_version;
+    uint32_t reserved;
+  };
+  /// Block 0 is the device itself, alias points to the first occurrence of a
+  /// block registered under several names.
+  struct block_record {
+    uint32_t owner;
+    uint32_t key;
+    uint32_t name;
+    uint32_t alias;
+  };
+  struct port_record {
+    uint32_t owner;
+    uint32_t name;
+    uint32_t flags;
+    uint32_t signal_size;
+  };
+  struct int_type_record {
+    uint32_t owner;
+    uint32_t name;
+    uint32_t kind;
+    uint32_t flags;
+    int32_t lower;
+    int32_t upper;
+    int32_t default_value;
+    uint32_t size;
+    uint32_t enum_first;
+    uint32_t enum_count;
+  };
+  struct enum_value_record {
+    uint32_t name;
+    uint32_t value;
+  };
+  struct double_type_record {
+    uint32_t owner;
+    uint32_t name;
+    uint32_t kind;
+    uint32_t flags;
+    double lower;
+    double upper;
+    double default_value;
+  };
+  struct string_type_record {
+    uint32_t owner;
+    uint32_t name;
+    uint32_t kind;
+    uint32_t flags;
+    uint32_t default_value;
+    uint32_t reserved;
+  };
+  /// type indexes the int, double or string type table depending on kind.
+  struct param_record {
+    uint32_t owner;
+    uint32_t key;
+    uint32_t name;
+    uint32_t kind;
+    uint32_t type;
+    uint32_t flags;
+    uint32_t address;
+    uint32_t size;
+    int32_t int_value;
+    uint32_t string_value;
+    double double_value;
+  };
+  struct constraint_record {
+    uint32_t owner;
+    uint32_t name;
+    uint32_t expression;
+    uint32_t flags;
+    int32_t value;
+    uint32_t reserved;
+  };
+  struct net_record {
+    uint32_t owner;
+    uint32_t name;
+  };
+  /// Driver (kind 0) or load (kind 1) of a net, optionally through the net of
+  /// an instance of the same block.
+  struct net_link_record {
+    uint32_t owner;
+    uint32_t net;
+    uint32_t kind;
+    uint32_t instance;
+    uint32_t target;
+    uint32_t reserved;
+  };
+  struct instance_record {
+    uint32_t owner;
+    uint32_t name;
+    uint32_t block;
+    uint32_t io_bank;
+    int32_t id;
+    int32_t logic_location_x;
+    int32_t logic_location_y;
+    int32_t logic_location_z;
+    int32_t logic_address;
+    int32_t phy_address;
+  };
+  /// Key/value entries, for block chains value is a block index.
+  struct entry_record {
+    uint32_t owner;
+    uint32_t kind;
+    uint32_t key;
+    uint32_t value;
+  };
+
+  struct section_ref {
+    uint64_t offset;
+    uint64_t count;
+  };
+  struct header {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint64_t file_size;
+    section_ref sections[section_count];
+  };
+
+  /**
+   * @brief Map a snapshot file and validate its header and section table.
+   * @param path The snapshot file.
+   * @throws std::runtime_error If the file can not be mapped, is not a
+   * snapshot, was written by another format version or is truncated.
+   */
+  explicit device_snapshot(const std::string &path) : path_(path) {
+    map();
+    try {
+      validate();
+    } catch (...) {
+      unmap();
+      throw;
+    }
+  }
+  ~device_snapshot() { unmap(); }
+
+  device_snapshot(const device_snapshot &) = delete;
+  device_snapshot &operator=(const device_snapshot &) = delete;
+
+  /**
+   * @brief Write a device as a snapshot file.
+   * @param dev The device to save.
+   * @param path The snapshot file, overwritten if it exists.
+   * @return Number of net links that could not be stored, a warning is
+   * logged when it is not zero.
+   * @throws std::runtime_error If the file can not be written.
+   */
+  static size_t save(device &dev, const std::string &path) {
+    snapshot_writer writer{dev};
+    writer.write(path);
+    const size_t dropped = writer.dropped_links();
+    if (dropped != 0) {
+      SPEEDLOG_WARN(
+          "Device snapshot {} is incomplete, {} net links crossing the block "
+          "hierarchy were not stored",
+          path, dropped);
+    }
+    return dropped;
+  }
+
+  /**
+   * @brief Map a snapshot file and rebuild its device.
+   * @param path The snapshot file.
+   * @return The restored device.
+   */
+  static std::shared_ptr<device> load(const std::string &path) {
+    return device_snapshot{path}.restore();
+  }
+
+  /**
+   * @brief Records of a section, pointing into the mapped file.
+   */
+  template <typename T>
+  struct table {
+    const T *data;
+    size_t count;
+    const T *begin() const { return data; }
+    const T *end() const { return data + count; }
+    size_t size() const { return count; }
+    const T &operator[](size_t idx) const {
+      if (idx >= count) {
+        throw std::runtime_error("Corrupted device snapshot, index " +
+                                 std::to_string(idx) + " out of range");
+      }
+      return data[idx];
+    }
+  };
+
+  template <typename T>
+  table<T> records(section sec) const {
+    const section_ref &ref = get_header().sections[sec];
+    return {reinterpret_cast<const T *>(data_ + ref.offset),
+            static_cast<size_t>(ref.count)};
+  }
+
+  /**
+   * @brief String of the string table, empty for none.
+   */
+  std::string_view string(uint32_t idx) const {
+    if (idx == none) return {};
+    const string_ref &ref = records<string_ref>(strings_section)[idx];
+    return {data_ + get_header().sections[string_data_section].offset +
+                ref.offset,
+            ref.size};
+  }
+
+  /// Name of the device, read without restoring it.
+  std::string device_name() const {
+    return str(records<device_record>(device_section)[0].name);
+  }
+
+  size_t block_count() const {
+    return records<block_record>(block_section).size();
+  }
+
+  size_t instance_count() const {
+    return records<instance_record>(instance_section).size();
+  }
+
+  /**
+   * @brief Rebuild the device described by the snapshot.
+   * @return The restored device.
+   * @throws std::runtime_error If a record refers to a missing entry.
+   */
+  std::shared_ptr<device> restore() const {
+    const auto &dev_rec = records<device_record>(device_section)[0];
+    auto dev = std::make_shared<device>(str(dev_rec.name));
+    dev->set_schema_version(str(dev_rec.schema_version));
+    dev->set_device_version(str(dev_rec.device_version));
+
+    std::vector<std::shared_ptr<device_block>> blocks;
+    auto blocks_table = records<block_record>(block_section);
+    blocks.reserve(blocks_table.size());
+    for (const auto &rec : blocks_table) {
+      if (blocks.empty()) {
+        blocks.push_back(dev);
+      } else if (rec.alias != none) {
+        blocks.push_back(at(blocks, rec.alias));
+        at(blocks, rec.owner)->blocks()[str(rec.key)] = blocks.back();
+      } else {
+        blocks.push_back(std::make_shared<device_block>(str(rec.name)));
+        at(blocks, rec.owner)->blocks()[str(rec.key)] = blocks.back();
+      }
+    }
+
+    auto int_types = restore_int_types(blocks);
+    auto double_types = restore_double_types(blocks);
+    auto string_types = restore_string_types(blocks);
+
+    for (const auto &rec : records<port_record>(port_section)) {
+      auto &block = at(blocks, rec.owner);
+      auto port = make_device_shared<device_port>(
+          str(rec.name), rec.flags & port_input, nullptr,
+          (rec.flags & port_has_block) ? block.get() : nullptr,
+          rec.signal_size);
+      block->add_port(port);
+      if (rec.flags & port_is_signal) {
+        block->add_signal(str(rec.name),
+                          std::shared_ptr<device_signal>(port->get_signal()));
+      }
+    }
+
+    for (const auto &rec : records<param_record>(param_section)) {
+      auto &block = at(blocks, rec.owner);
+      std::string name = str(rec.name);
+      if (rec.kind == double_param) {
+        auto par = make_device_shared<Parameter<double>>(
+            name, rec.double_value, at(double_types, rec.type));
+        block->add_double_parameter(str(rec.key), par);
+      } else if (rec.kind == string_param) {
+        auto par = make_device_shared<Parameter<std::string>>(
+            name, rec.string_value != none ? str(rec.string_value) : "",
+            at(string_types, rec.type));
+        block->add_string_parameter(str(rec.key), par);
+      } else {
+        auto par = make_device_shared<Parameter<int>>(
+            name, rec.int_value, at(int_types, rec.type));
+        if (rec.flags & has_size) par->set_size(rec.size);
+        if (rec.flags & has_address) par->set_address(rec.address);
+        if (rec.kind == attribute_param) {
+          block->add_attribute(str(rec.key), par);
+        } else {
+          block->add_int_parameter(str(rec.key), par);
+        }
+      }
+    }
+
+    for (const auto &rec : records<constraint_record>(constraint_section)) {
+      auto expr = std::make_shared<rs_expression<int>>(str(rec.expression));
+      if (rec.flags & is_evaluated) expr->set_value(rec.value);
+      at(blocks, rec.owner)->add_constraint(str(rec.name), expr);
+    }
+
+    for (const auto &rec : records<net_record>(net_section)) {
+      auto &block = at(blocks, rec.owner);
+      // Nets of single bit ports were already created with their port.
+      std::string name = str(rec.name);
+      if (!block->get_net(name)) {
+        block->add_net(make_device_shared<device_net>(name));
+      }
+    }
+
+    for (const auto &rec : records<entry_record>(entry_section)) {
+      restore_entry(*dev, blocks, rec);
+    }
+
+    restore_instances(blocks);
+
+    for (const auto &rec : records<net_link_record>(net_link_section)) {
+      auto &block = at(blocks, rec.owner);
+      auto net = block->get_net(str(rec.net));
+      std::shared_ptr<device_net> target;
+      if (rec.instance == none) {
+        target = block->get_net(str(rec.target));
+      } else if (auto inst = block->get_instance(str(rec.instance))) {
+        target = inst->get_net(str(rec.target));
+      }
+      // The writer only stores links it can resolve by name.
+      if (!net || !target) {
+        throw std::runtime_error("Corrupted device snapshot, net " +
+                                 str(rec.net) + " of block " +
+                                 block->block_name() + " has a missing link");
+      }
+      if (rec.kind == 0) {
+        net->set_source(target);
+      } else {
+        net->add_sink(target);
+      }
+    }
+    return dev;
+  }
+
+ private:
+  static constexpr char magic_[8] = {'F', 'D', 'M', 'S', 'N', 'A', 'P', '\0'};
+  static constexpr uint32_t endian_marker_ = 0x01020304u;
+
+  static constexpr size_t record_size(section sec) {
+    switch (sec) {
+      case strings_section:
+        return sizeof(string_ref);
+      case string_data_section:
+        return 1;
+      case device_section:
+        return sizeof(device_record);
+      case block_section:
+        return sizeof(block_record);
+      case port_section:
+        return sizeof(port_record);
+      case int_type_section:
+        return sizeof(int_type_record);
+      case enum_value_section:
+        return sizeof(enum_value_record);
+      case double_type_section:
+        return sizeof(double_type_record);
+      case string_type_section:
+        return sizeof(string_type_record);
+      case param_section:
+        return sizeof(param_record);
+      case constraint_section:
+        return sizeof(constraint_record);
+      case net_section:
+        return sizeof(net_record);
+      case net_link_section:
+        return sizeof(net_link_record);
+      case instance_section:
+        return sizeof(instance_record);
+      case entry_section:
+        return sizeof(entry_record);
+      default:
+        return 0;
+    }
+  }
+
+  template <typename T>
+  static const T &at(const std::vector<T> &vec, uint32_t idx) {
+    if (idx >= vec.size()) {
+      throw std::runtime_error("Corrupted device snapshot, index " +
+                               std::to_string(idx) + " out of range");
+    }
+    return vec[idx];
+  }
+
+  std::string str(uint32_t idx) const { return std::string{string(idx)}; }
+
+  const header &get_header() const {
+    return *reinterpret_cast<const header *>(data_);
+  }
+
+  void map() {
+#if defined(_WIN32)
+    file_ = CreateFileA(path_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error("Unable to open device snapshot " + path_);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+      CloseHandle(file_);
+      throw std::runtime_error("Unable to map device snapshot " + path_);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    mapping_ =
+        CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_) {
+      data_ = static_cast<const char *>(
+          MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!data_) {
+      if (mapping_) CloseHandle(mapping_);
+      CloseHandle(file_);
+      throw std::runtime_error("Unable to map device snapshot " + path_);
+    }
+#else
+    int fd = open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Unable to open device snapshot " + path_);
+    }
+    struct stat st;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      size_ = static_cast<size_t>(st.st_size);
+      addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+      throw std::runtime_error("Unable to map device snapshot " + path_);
+    }
+    data_ = static_cast<const char *>(addr);
+#endif
+  }
+
+  void unmap() {
+    if (!data_) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    munmap(const_cast<char *>(data_), size_);
+#endif
+    data_ = nullptr;
+  }
+
+  void validate() const {
+    if (size_ < sizeof(header) ||
+        std::memcmp(get_header().magic, magic_, sizeof(magic_)) != 0) {
+      throw std::runtime_error(path_ + " is not a device snapshot");
+    }
+    const header &hdr = get_header();
+    if (hdr.endian != endian_marker_) {
+      throw std::runtime_error("Device snapshot " + path_ +
+                               " was written on a machine with a different "
+                               "byte order");
+    }
+    if (hdr.version != format_version) {
+      throw std::runtime_error(
+          "Device snapshot " + path_ + " has format version " +
+          std::to_string(hdr.version) + ", expected " +
+          std::to_string(format_version));
+    }
+    if (hdr.file_size != size_) {
+      throw std::runtime_error("Device snapshot " + path_ + " is truncated");
+    }
+    for (uint32_t sec = 0; sec < section_count; ++sec) {
+      const section_ref &ref = hdr.sections[sec];
+      uint64_t bytes = ref.count * record_size(static_cast<section>(sec));
+      if (ref.offset % 8 != 0 || ref.offset > size_ ||
+          ref.count > size_ || bytes > size_ - ref.offset) {
+        throw std::runtime_error("Device snapshot " + path_ +
+                                 " has a corrupted section table");
+      }
+    }
+    if (hdr.sections[device_section].count != 1 ||
+        hdr.sections[block_section].count == 0) {
+      throw std::runtime_error("Device snapshot " + path_ +
+                               " does not contain a device");
+    }
+    uint64_t data_size = hdr.sections[string_data_section].count;
+    for (const auto &ref : records<string_ref>(strings_section)) {
+      if (uint64_t{ref.offset} + ref.size > data_size) {
+        throw std::runtime_error("Device snapshot " + path_ +
+                                 " has a corrupted string table");
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<ParameterType<int>>> restore_int_types(
+      const std::vector<std::shared_ptr<device_block>> &blocks) const {
+    std::vector<std::shared_ptr<ParameterType<int>>> types;
+    auto enum_values = records<enum_value_record>(enum_value_section);
+    for (const auto &rec : records<int_type_record>(int_type_section)) {
+      auto type = std::make_shared<ParameterType<int>>();
+      // The default is restored before the size and bounds it was already
+      // checked against when the model was built.
+      if (rec.flags & has_default) type->set_default_value(rec.default_value);
+      if (rec.flags & has_size) type->set_size(rec.size);
+      for (uint32_t i = 0; i < rec.enum_count; ++i) {
+        const auto &val = enum_values[rec.enum_first + i];
+        type->set_enum_value(str(val.name), val.value);
+      }
+      if (rec.flags & has_lower) type->set_lower_bound(rec.lower);
+      if (rec.flags & has_upper) type->set_upper_bound(rec.upper);
+      if (rec.kind == param_type) {
+        at(blocks, rec.owner)->int_parameter_types()[str(rec.name)] = type;
+      } else if (rec.kind == enum_type) {
+        at(blocks, rec.owner)->enum_types()[str(rec.name)] = type;
+      }
+      types.push_back(std::move(type));
+    }
+    return types;
+  }
+
+  std::vector<std::shared_ptr<ParameterType<double>>> restore_double_types(
+      const std::vector<std::shared_ptr<device_block>> &blocks) const {
+    std::vector<std::shared_ptr<ParameterType<double>>> types;
+    for (const auto &rec : records<double_type_record>(double_type_section)) {
+      auto type = std::make_shared<ParameterType<double>>();
+      if (rec.flags & has_default) type->set_default_value(rec.default_value);
+      if (rec.flags & has_lower) type->set_lower_bound(rec.lower);
+      if (rec.flags & has_upper) type->set_upper_bound(rec.upper);
+      if (rec.kind == param_type) {
+        at(blocks, rec.owner)->double_parameter_types()[str(rec.name)] = type;
+      }
+      types.push_back(std::move(type));
+    }
+    return types;
+  }
+
+  std::vector<std::shared_ptr<ParameterType<std::string>>>
+  restore_string_types(
+      const std::vector<std::shared_ptr<device_block>> &blocks) const {
+    std::vector<std::shared_ptr<ParameterType<std::string>>> types;
+    for (const auto &rec : records<string_type_record>(string_type_section)) {
+      auto type = std::make_shared<ParameterType<std::string>>();
+      if (rec.flags & has_default) {
+        type->set_default_value(str(rec.default_value));
+      }
+      if (rec.kind == param_type) {
+        at(blocks, rec.owner)->string_parameter_types()[str(rec.name)] = type;
+      }
+      types.push_back(std::move(type));
+    }
+    return types;
+  }
+
+  void restore_entry(device &dev,
+                     const std::vector<std::shared_ptr<device_block>> &blocks,
+                     const entry_record &rec) const {
+    auto &block = at(blocks, rec.owner);
+    std::string key = str(rec.key);
+    switch (rec.kind) {
+      case property_entry:
+        block->setProperty(key, str(rec.value));
+        break;
+      case model_mapping_entry:
+        block->addMapping(key, str(rec.value));
+        break;
+      case rtl_mapping_entry:
+        dev.setUserToRtlMapping(key, str(rec.value));
+        break;
+      case instance_chain_entry:
+        if (rec.value == none) {
+          block->get_chains()[key];
+        } else {
+          block->append_instance_to_chain(key, str(rec.value));
+        }
+        break;
+      case block_chain_entry:
+        if (rec.value == none) {
+          block->createBlockChain(key);
+        } else {
+          block->addBlockToChain(key, at(blocks, rec.value));
+        }
+        break;
+      case instantiated_block_entry:
+        dev.add_instantiated_block(key);
+        break;
+      default:
+        throw std::runtime_error("Corrupted device snapshot, unknown entry");
+    }
+  }
+
+  // Instantiating a block copies its own instances, so the instances of a
+  // block are restored before any instance of that block is created.
+  void restore_instances(
+      const std::vector<std::shared_ptr<device_block>> &blocks) const {
+    auto instances = records<instance_record>(instance_section);
+    std::vector<std::vector<uint32_t>> by_owner(blocks.size());
+    for (uint32_t i = 0; i < instances.size(); ++i) {
+      at(by_owner, instances[i].owner);
+      by_owner[instances[i].owner].push_back(i);
+    }
+    enum { pending, active, done };
+    std::vector<int> state(blocks.size(), pending);
+    std::function<void(uint32_t)> visit = [&](uint32_t owner) {
+      if (state[owner] == done) return;
+      if (state[owner] == active) {
+        throw std::runtime_error("Corrupted device snapshot, block " +
+                                 blocks[owner]->block_name() +
+                                 " instantiates itself");
+      }
+      state[owner] = active;
+      for (uint32_t i : by_owner[owner]) {
+        at(blocks, instances[i].block);
+        visit(instances[i].block);
+      }
+      auto &block = blocks[owner];
+      for (uint32_t i : by_owner[owner]) {
+        const auto &rec = instances[i];
+        auto inst = make_device_shared<device_block_instance>(
+            blocks[rec.block], rec.id, rec.logic_location_x,
+            rec.logic_location_y, rec.logic_address, str(rec.name),
+            str(rec.io_bank), rec.logic_location_z);
+        inst->set_phy_address(rec.phy_address);
+        block->instance_vector().push_back(inst);
+        block->add_instance(str(rec.name), inst);
+      }
+      state[owner] = done;
+    };
+    for (uint32_t owner = 0; owner < blocks.size(); ++owner) visit(owner);
+  }
+
+  /**
+   * @class snapshot_writer
+   * @brief Flattens a device into the snapshot record tables.
+   */
+  class snapshot_writer {
+   public:
+    explicit snapshot_writer(device &dev) {
+      device_record rec{intern(dev.device_name()), intern(dev.schema_version()),
+                        intern(dev.device_version()), 0};
+      devices_.push_back(rec);
+      collect_blocks(dev);
+      for (uint32_t idx = 0; idx < block_list_.size(); ++idx) {
+        collect_types(idx, *block_list_[idx]);
+      }
+      for (uint32_t idx = 0; idx < block_list_.size(); ++idx) {
+        collect_block(idx, *block_list_[idx]);
+      }
+      for (const auto &pr : dev.user_to_rtl_map()) {
+        entries_.push_back(
+            {0, rtl_mapping_entry, intern(pr.first), intern(pr.second)});
+      }
+      for (const auto &name : dev.get_instantiated_blocks()) {
+        entries_.push_back({0, instantiated_block_entry, intern(name), none});
+      }
+    }
+
+    size_t dropped_links() const { return dropped_links_; }
+
+    void write(const std::string &path) {
+      header hdr{};
+      std::memcpy(hdr.magic, magic_, sizeof(magic_));
+      hdr.version = format_version;
+      hdr.endian = endian_marker_;
+      std::vector<std::pair<const char *, size_t>> chunks(section_count);
+      chunks[strings_section] = bytes(strings_);
+      chunks[string_data_section] = {string_data_.data(), string_data_.size()};
+      chunks[device_section] = bytes(devices_);
+      chunks[block_section] = bytes(blocks_);
+      chunks[port_section] = bytes(ports_);
+      chunks[int_type_section] = bytes(int_types_);
+      chunks[enum_value_section] = bytes(enum_values_);
+      chunks[double_type_section] = bytes(double_types_);
+      chunks[string_type_section] = bytes(string_types_);
+      chunks[param_section] = bytes(params_);
+      chunks[constraint_section] = bytes(constraints_);
+      chunks[net_section] = bytes(nets_);
+      chunks[net_link_section] = bytes(net_links_);
+      chunks[instance_section] = bytes(instances_);
+      chunks[entry_section] = bytes(entries_);
+      uint64_t offset = align(sizeof(header));
+      for (uint32_t sec = 0; sec < section_count; ++sec) {
+        hdr.sections[sec].offset = offset;
+        hdr.sections[sec].count =
+            chunks[sec].second / record_size(static_cast<section>(sec));
+        offset = align(offset + chunks[sec].second);
+      }
+      hdr.file_size = offset;
+
+      std::ofstream out{path, std::ios::binary | std::ios::trunc};
+      if (!out) {
+        throw std::runtime_error("Unable to write device snapshot " + path);
+      }
+      static const char padding[8] = {};
+      uint64_t written = sizeof(header);
+      out.write(reinterpret_cast<const char *>(&hdr), sizeof(header));
+      for (uint32_t sec = 0; sec < section_count; ++sec) {
+        out.write(padding, hdr.sections[sec].offset - written);
+        out.write(chunks[sec].first, chunks[sec].second);
+        written = hdr.sections[sec].offset + chunks[sec].second;
+      }
+      out.write(padding, hdr.file_size - written);
+      if (!out.flush()) {
+        throw std::runtime_error("Unable to write device snapshot " + path);
+      }
+    }
+
+   private:
+    template <typename T>
+    static std::pair<const char *, size_t> bytes(const std::vector<T> &vec) {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Snapshot records must be trivially copyable");
+      return {reinterpret_cast<const char *>(vec.data()),
+              vec.size() * sizeof(T)};
+    }
+    static uint64_t align(uint64_t offset) { return (offset + 7) & ~7ull; }
+
+    uint32_t intern(const std::string &str) {
+      auto it = string_index_.find(str);
+      if (it != string_index_.end()) return it->second;
+      uint32_t idx = static_cast<uint32_t>(strings_.size());
+      strings_.push_back({static_cast<uint32_t>(string_data_.size()),
+                          static_cast<uint32_t>(str.size())});
+      string_data_ += str;
+      string_index_.emplace(str, idx);
+      return idx;
+    }
+
+    void collect_blocks(device &dev) {
+      block_index_[&dev] = 0;
+      block_list_.push_back(&dev);
+      blocks_.push_back(
+          {none, intern(dev.device_name()), intern(dev.block_name()), none});
+      for (uint32_t idx = 0; idx < block_list_.size(); ++idx) {
+        for (const auto &pr : block_list_[idx]->blocks()) {
+          device_block *child = pr.second.get();
+          if (!child) continue;
+          auto it = block_index_.find(child);
+          if (it != block_index_.end()) {
+            blocks_.push_back({idx, intern(pr.first),
+                               intern(child->block_name()), it->second});
+            continue;
+          }
+          uint32_t child_idx = static_cast<uint32_t>(blocks_.size());
+          block_index_[child] = child_idx;
+          block_list_.push_back(child);
+          blocks_.push_back(
+              {idx, intern(pr.first), intern(child->block_name()), none});
+        }
+      }
+    }
+
+    uint32_t add_int_type(uint32_t owner, uint32_t name, uint32_t kind,
+                          ParameterType<int> &type) {
+      int_type_record rec{owner, name, kind, 0, 0, 0, 0, 0, 0, 0};
+      if (type.has_lower_bound()) {
+        rec.flags |= has_lower;
+        rec.lower = type.get_lower_bound();
+      }
+      if (type.has_upper_bound()) {
+        rec.flags |= has_upper;
+        rec.upper = type.get_upper_bound();
+      }
+      if (type.has_default_value()) {
+        rec.flags |= has_default;
+        rec.default_value = type.get_default_value();
+      }
+      if (type.has_size()) {
+        rec.flags |= has_size;
+        rec.size = static_cast<uint32_t>(type.get_size());
+      }
+      rec.enum_first = static_cast<uint32_t>(enum_values_.size());
+      for (const auto &pr : type.get_enum_values()) {
+        enum_values_.push_back({intern(pr.first), pr.second});
+      }
+      rec.enum_count =
+          static_cast<uint32_t>(enum_values_.size()) - rec.enum_first;
+      uint32_t idx = static_cast<uint32_t>(int_types_.size());
+      int_types_.push_back(rec);
+      int_type_index_.emplace(&type, idx);
+      return idx;
+    }
+
+    uint32_t add_double_type(uint32_t owner, uint32_t name, uint32_t kind,
+                             ParameterType<double> &type) {
+      double_type_record rec{owner, name, kind, 0, 0.0, 0.0, 0.0};
+      if (type.has_lower_bound()) {
+        rec.flags |= has_lower;
+        rec.lower = type.get_lower_bound();
+      }
+      if (type.has_upper_bound()) {
+        rec.flags |= has_upper;
+        rec.upper = type.get_upper_bound();
+      }
+      if (type.has_default_value()) {
+        rec.flags |= has_default;
+        rec.default_value = type.get_default_value();
+      }
+      uint32_t idx = static_cast<uint32_t>(double_types_.size());
+      double_types_.push_back(rec);
+      double_type_index_.emplace(&type, idx);
+      return idx;
+    }
+
+    uint32_t add_string_type(uint32_t owner, uint32_t name, uint32_t kind,
+                             ParameterType<std::string> &type) {
+      string_type_record rec{owner, name, kind, 0, none, 0};
+      if (type.has_default_value()) {
+        rec.flags |= has_default;
+        rec.default_value = intern(type.get_default_value());
+      }
+      uint32_t idx = static_cast<uint32_t>(string_types_.size());
+      string_types_.push_back(rec);
+      string_type_index_.emplace(&type, idx);
+      return idx;
+    }
+
+    void collect_types(uint32_t idx, device_block &block) {
+      for (const auto &pr : block.int_parameter_types()) {
+        add_int_type(idx, intern(pr.first), param_type, *pr.second);
+      }
+      for (const auto &pr : block.enum_types()) {
+        add_int_type(idx, intern(pr.first), enum_type, *pr.second);
+      }
+      for (const auto &pr : block.double_parameter_types()) {
+        add_double_type(idx, intern(pr.first), param_type, *pr.second);
+      }
+      for (const auto &pr : block.string_parameter_types()) {
+        add_string_type(idx, intern(pr.first), param_type, *pr.second);
+      }
+    }
+
+    // Types shared by several parameters keep a single record, types that are
+    // not registered in any block are stored as anonymous types.
+    template <typename T, typename Index, typename Add>
+    uint32_t type_of(uint32_t owner, const Parameter<T> &par, Index &index,
+                     Add add) {
+      auto type = par.get_type();
+      auto it = index.find(type.get());
+      if (it != index.end()) return it->second;
+      return (this->*add)(owner, none, anonymous_type, *type);
+    }
+
+    template <typename T>
+    param_record param_of(uint32_t owner, const std::string &key,
+                          uint32_t kind, const Parameter<T> &par) {
+      param_record rec{owner, intern(key), intern(par.get_name()), kind, 0, 0,
+                       0,     0,           0,     none,          0.0};
+      if constexpr (std::is_same<T, int>::value) {
+        rec.type = type_of(owner, par, int_type_index_,
+                           &snapshot_writer::add_int_type);
+        rec.int_value = par.get_value();
+        if (par.has_address()) {
+          rec.flags |= has_address;
+          rec.address = static_cast<uint32_t>(par.get_address());
+        }
+        if (par.has_size()) {
+          rec.flags |= has_size;
+          rec.size = static_cast<uint32_t>(par.get_size());
+        }
+      } else if constexpr (std::is_same<T, double>::value) {
+        rec.type = type_of(owner, par, double_type_index_,
+                           &snapshot_writer::add_double_type);
+        rec.double_value = par.get_value();
+      } else {
+        rec.type = type_of(owner, par, string_type_index_,
+                           &snapshot_writer::add_string_type);
+        if (!par.get_value().empty()) {
+          rec.string_value = intern(par.get_value());
+        }
+      }
+      return rec;
+    }
+
+    uint32_t block_of(device_block *block) {
+      auto it = block_index_.find(block);
+      if (it == block_index_.end()) {
+        throw std::runtime_error(
+            "Block " + (block ? block->block_name() : std::string{"<null>"}) +
+            " is not registered in the device, it can not be saved");
+      }
+      return it->second;
+    }
+
+    void collect_block(uint32_t idx, device_block &block) {
+      for (const auto &pr : block.ports()) {
+        auto &port = *pr.second;
+        port_record rec{idx, intern(pr.first), 0, 1};
+        if (port.is_input()) rec.flags |= port_input;
+        if (port.get_block()) rec.flags |= port_has_block;
+        if (auto *signal = port.get_signal()) {
+          rec.signal_size = signal->get_size();
+          auto sig = block.get_signal(pr.first);
+          if (sig && sig.get() == signal) rec.flags |= port_is_signal;
+        }
+        ports_.push_back(rec);
+      }
+      for (const auto &pr : block.int_parameters()) {
+        params_.push_back(param_of(idx, pr.first, int_param, *pr.second));
+      }
+      for (const auto &pr : block.double_parameters()) {
+        params_.push_back(param_of(idx, pr.first, double_param, *pr.second));
+      }
+      for (const auto &pr : block.string_parameters()) {
+        params_.push_back(param_of(idx, pr.first, string_param, *pr.second));
+      }
+      for (const auto &pr : block.attributes()) {
+        params_.push_back(
+            param_of(idx, pr.first, attribute_param, *pr.second));
+      }
+      for (const auto &pr : block.constraints()) {
+        constraint_record rec{idx, intern(pr.first),
+                              intern(pr.second->get_expression_string()), 0, 0,
+                              0};
+        try {
+          rec.value = pr.second->get_value();
+          rec.flags |= is_evaluated;
+        } catch (const std::runtime_error &) {
+        }
+        constraints_.push_back(rec);
+      }
+      for (const auto &pr : block.nets()) {
+        nets_.push_back({idx, intern(pr.first)});
+      }
+      for (const auto &inst : block.instance_vector()) {
+        instances_.push_back(
+            {idx, intern(inst->get_instance_name()),
+             block_of(inst->get_block().get()), intern(inst->get_io_bank()),
+             inst->get_instance_id(), inst->get_logic_location_x(),
+             inst->get_logic_location_y(), inst->get_logic_location_z(),
+             inst->get_logic_address(), inst->get_phy_address()});
+      }
+      collect_net_links(idx, block);
+      for (const auto &pr : block.properties()) {
+        entries_.push_back(
+            {idx, property_entry, intern(pr.first), intern(pr.second)});
+      }
+      for (const auto &pr : block.model_mappings()) {
+        entries_.push_back(
+            {idx, model_mapping_entry, intern(pr.first), intern(pr.second)});
+      }
+      for (const auto &pr : block.get_chains()) {
+        uint32_t key = intern(pr.first);
+        entries_.push_back({idx, instance_chain_entry, key, none});
+        for (const auto &name : pr.second) {
+          entries_.push_back({idx, instance_chain_entry, key, intern(name)});
+        }
+      }
+      for (const auto &pr : block.block_chains()) {
+        uint32_t key = intern(pr.first);
+        entries_.push_back({idx, block_chain_entry, key, none});
+        for (const auto &member : pr.second) {
+          entries_.push_back(
+              {idx, block_chain_entry, key, block_of(member.get())});
+        }
+      }
+    }
+
+    // Drivers and loads are stored by name, either a net of the block or the
+    // net of one of its instances. Other references can not be rebuilt from
+    // names, they are dropped and counted.
+    void collect_net_links(uint32_t idx, device_block &block) {
+      std::unordered_map<const device_net *, std::pair<uint32_t, uint32_t>>
+          instance_nets;
+      bool instance_nets_ready = false;
+      auto resolve = [&](const std::shared_ptr<device_net> &net,
+                         std::pair<uint32_t, uint32_t> &ref) {
+        std::string name = net->get_net_name();
+        if (block.get_net(name) == net) {
+          ref = {none, intern(name)};
+          return true;
+        }
+        if (!instance_nets_ready) {
+          for (const auto &pr : block.instances()) {
+            const std::string &inst_name = pr.first;
+            for (const auto &npr : block.nets()) {
+              if (auto inst_net = pr.second->get_net(npr.first)) {
+                instance_nets.emplace(inst_net.get(),
+                                      std::make_pair(intern(inst_name),
+                                                     intern(npr.first)));
+              }
+            }
+          }
+          instance_nets_ready = true;
+        }
+        auto it = instance_nets.find(net.get());
+        if (it == instance_nets.end()) return false;
+        ref = it->second;
+        return true;
+      };
+      for (const auto &pr : block.nets()) {
+        uint32_t net = intern(pr.first);
+        std::pair<uint32_t, uint32_t> ref;
+        if (auto source = pr.second->get_source()) {
+          if (resolve(source, ref)) {
+            net_links_.push_back({idx, net, 0, ref.first, ref.second, 0});
+          } else {
+            ++dropped_links_;
+          }
+        }
+        for (const auto &sink : pr.second->get_sink_set()) {
+          if (resolve(sink, ref)) {
+            net_links_.push_back({idx, net, 1, ref.first, ref.second, 0});
+          } else {
+            ++dropped_links_;
+          }
+        }
+      }
+    }
+
+    std::vector<string_ref> strings_;
+    std::string string_data_;
+    std::unordered_map<std::string, uint32_t> string_index_;
+    std::vector<device_record> devices_;
+    std::vector<block_record> blocks_;
+    std::vector<port_record> ports_;
+    std::vector<int_type_record> int_types_;
+    std::vector<enum_value_record> enum_values_;
+    std::vector<double_type_record> double_types_;
+    std::vector<string_type_record> string_types_;
+    std::vector<param_record> params_;
+    std::vector<constraint_record> constraints_;
+    std::vector<net_record> nets_;
+    std::vector<net_link_record> net_links_;
+    std::vector<instance_record> instances_;
+    std::vector<entry_record> entries_;
+    size_t dropped_links_ = 0;
+    std::unordered_map<const device_block *, uint32_t> block_index_;
+    std::vector<device_block *> block_list_;
+    std::unordered_map<const void *, uint32_t> int_type_index_;
+    std::unordered_map<const void *, uint32_t> double_type_index_;
+    std::unordered_map<const void *, uint32_t> string_type_index_;
+  };
+
+  std::string path_;
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+#if defined(_WIN32)
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#endif
+};
@@ -242,6 +242,14 @@ class ParameterType {
     return (enum_values_.find(key) != end(enum_values_));
   }
 
+  /**
+   * @brief Get all the enum values of the parameter.
+   * @return A const reference to the map of enum names to values.
+   */
+  const std::unordered_map<std::string, unsigned int> &get_enum_values() const {
+    return enum_values_;
+  }
+
   /**
    * @brief Set the default value.
    * @param value The value to set as the default value.
@@ -1,8 +1,15 @@
 /**
  * @file speedlog.h
  * @author Manadher Kharroubi (manadher@gmail.com)
- * @brief
- * @version 0.1
+ * @brief Leveled logger of the device modeler.
+ *
+ * Formatting happens on the calling thread, writing on a background thread so
+ * a log statement never blocks on the console. The SPEEDLOG_* macros check
+ * the level before evaluating their arguments: levels below
+ * SPEEDLOG_ACTIVE_LEVEL are compiled out and levels below the runtime level
+ * cost a comparison.
+ *
+ * @version 0.2
  * @date 2023-05-18
  *
  * @copyright Copyright (c) 2023
@@ -12,29 +19,77 @@
 #ifndef SPEEDLOG_H
 #define SPEEDLOG_H
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <utility>
 
 #ifndef spdlog
 #define spdlog SpeedLog
 #endif
 
-enum LogLevel { LOG_INFO, LOG_WARN, LOG_ERROR };
+enum LogLevel { LOG_INFO, LOG_WARN, LOG_ERROR, LOG_OFF };
+
+/// Lowest level compiled in, define it to LOG_OFF to remove all logging.
+#ifndef SPEEDLOG_ACTIVE_LEVEL
+#define SPEEDLOG_ACTIVE_LEVEL LOG_INFO
+#endif
+
+#define SPEEDLOG_LOG(level, ...)                                           \
+  do {                                                                     \
+    if ((level) >= SPEEDLOG_ACTIVE_LEVEL && SpeedLog::should_log(level)) { \
+      SpeedLog::log(level, __VA_ARGS__);                                   \
+    }                                                                      \
+  } while (0)
+#define SPEEDLOG_INFO(...) SPEEDLOG_LOG(LOG_INFO, __VA_ARGS__)
+#define SPEEDLOG_WARN(...) SPEEDLOG_LOG(LOG_WARN, __VA_ARGS__)
+#define SPEEDLOG_ERROR(...) SPEEDLOG_LOG(LOG_ERROR, __VA_ARGS__)
 
 class SpeedLog {
  public:
+  /// Receives formatted lines on the background thread.
+  using sink_t = std::function<void(LogLevel, const std::string&)>;
+
   static void setLogLevel(LogLevel level) { speed_logLevel = level; }
+  static bool should_log(LogLevel level) {
+    return level >= SPEEDLOG_ACTIVE_LEVEL && level >= speed_logLevel &&
+           level < LOG_OFF;
+  }
+
+  /**
+   * @brief Replace the destination of the log lines, std::cout by default.
+   * Pending lines are written to the previous sink first.
+   */
+  static void setSink(sink_t sink) {
+    flush();
+    std::lock_guard<std::mutex> lock{writer().mutex};
+    writer().sink = std::move(sink);
+  }
 
+  /**
+   * @brief Wait until every queued line has been written.
+   */
+  static void flush() { writer().flush(); }
+
+  /**
+   * @brief Format and queue a line. "{}" in the format is replaced by the
+   * next argument, remaining arguments are appended separated by spaces.
+   */
   template <typename... Args>
   static void log(LogLevel level, const std::string& format, Args&&... args) {
-    if (level >= speed_logLevel) {
-      std::stringstream ss;
-      std::string formatCopy = format;  // Make a copy for modification
-      logInternal(ss, level, formatCopy, std::forward<Args>(args)...);
-      std::cout << ss.str();
-    }
+    if (!should_log(level)) return;
+    std::ostringstream ss;
+    size_t pos = 0;
+    (formatArg(ss, format, pos, args), ...);
+    if (pos < format.size()) ss << format.substr(pos);
+    ss << '\n';
+    writer().push(level, ss.str());
   }
 
   template <typename... Args>
@@ -55,46 +110,105 @@ class SpeedLog {
  private:
   static LogLevel speed_logLevel;
 
-  template <typename T, typename... Args>
-  static void logValue(std::stringstream& ss, LogLevel level,
-                       std::string& format, const T& value,
-                       const Args&... args) {
-    //   while (!format.empty()) {
-    //       if (format[0] == '{' && format[1] == '}') {
-    //           ss << value;
-    //           format = format.substr(2);
-    //           logValueHelper(ss, level, format, args...);
-    //           return;
-    //       }
-    //       ss << format[0];
-    //       format = format.substr(1);
-    //   }
-    ss << format << " ";
-    ((ss << args << " "), ...);  // Using the fold expression and comma operator
-    ss << std::endl;
+  template <typename T>
+  static void formatArg(std::ostringstream& ss, const std::string& format,
+                        size_t& pos, const T& value) {
+    size_t next = format.find("{}", pos);
+    if (next == std::string::npos) {
+      if (pos < format.size()) {
+        ss << format.substr(pos);
+        pos = format.size();
+      }
+      ss << ' ' << value;
+      return;
+    }
+    ss << format.substr(pos, next - pos) << value;
+    pos = next + 2;
   }
 
-  //   template <typename T>
-  //   static void logValueHelper(std::stringstream& ss, LogLevel level,
-  //   std::string& format, const T& value) {
-  //       ss << value;
-  //       logValue(ss, level, format);
-  //   }
+  // Writes queued lines on its own thread. At exit the thread is drained and
+  // joined, lines logged afterwards are written by the caller.
+  struct background_writer {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable drained;
+    std::deque<std::pair<LogLevel, std::string>> queue;
+    sink_t sink;
+    bool busy = false;
+    bool stop = false;
+    std::thread thread;
 
-  //   template <typename T, typename... Args>
-  //   static void logValueHelper(std::stringstream& ss, LogLevel level,
-  //   std::string& format, const T& value, const Args&... args) {
-  //       ss << value;
-  //       logValue(ss, level, format, args...);
-  //   }
+    background_writer() : thread([this] { run(); }) {}
 
-  template <typename... Args>
-  static void logInternal(std::stringstream& ss, LogLevel level,
-                          std::string& format, const Args&... args) {
-    ss << format << " ";
-    ((ss << args << " "), ...);  // Using the fold expression and comma operator
-    ss << std::endl;
-    //  logValue(ss, level, format, args...);
+    void shutdown() {
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        stop = true;
+      }
+      ready.notify_one();
+      if (thread.joinable()) thread.join();
+    }
+
+    void push(LogLevel level, std::string line) {
+      std::unique_lock<std::mutex> lock{mutex};
+      if (stop) {
+        sink_t out = sink;
+        lock.unlock();
+        if (out) {
+          out(level, line);
+        } else {
+          std::cout << line << std::flush;
+        }
+        return;
+      }
+      queue.emplace_back(level, std::move(line));
+      lock.unlock();
+      ready.notify_one();
+    }
+
+    void flush() {
+      std::unique_lock<std::mutex> lock{mutex};
+      drained.wait(lock, [this] { return queue.empty() && !busy; });
+    }
+
+    void run() {
+      std::unique_lock<std::mutex> lock{mutex};
+      while (true) {
+        ready.wait(lock, [this] { return stop || !queue.empty(); });
+        if (queue.empty()) break;
+        std::deque<std::pair<LogLevel, std::string>> lines;
+        lines.swap(queue);
+        sink_t out = sink;
+        busy = true;
+        lock.unlock();
+        std::string batch;
+        for (auto& line : lines) {
+          if (out) {
+            out(line.first, line.second);
+          } else {
+            batch += line.second;
+          }
+        }
+        if (!batch.empty()) std::cout << batch << std::flush;
+        lock.lock();
+        busy = false;
+        if (queue.empty()) drained.notify_all();
+      }
+    }
+  };
+
+  // Shuts the writer down when static objects are destroyed.
+  struct writer_guard {
+    background_writer& w;
+    ~writer_guard() { w.shutdown(); }
+  };
+
+  // Never destroyed, statics destroyed after the guard, like the device
+  // modeler, can still log from their destructors.
+  static background_writer& writer() {
+    static background_writer* w = new background_writer;
+    static writer_guard guard{*w};
+    return *w;
   }
 };
 
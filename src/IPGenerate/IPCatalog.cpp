@@ -25,7 +25,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <sys/types.h>
 
 #include <QDebug>
-#include <QFile>
 #include <QProcess>
 #include <chrono>
 #include <ctime>
@@ -37,6 +36,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Compiler/WorkerThread.h"
 #include "MainWindow/Session.h"
 #include "Utils/FileUtils.h"
+#include "Utils/JsonCache.h"
 #include "Utils/StringUtils.h"
 #include "nlohmann_json/json.hpp"
 using json = nlohmann::ordered_json;
@@ -122,12 +122,9 @@ std::filesystem::path IPCatalog::getPythonPath() {
 
 IPDetails FOEDAG::readIpDetails(const std::filesystem::path& path) {
   IPDetails details;
-  QFile file{QString::fromStdString(path.string())};
-  if (!file.open(QFile::ReadOnly)) return details;
-  QString content = file.readAll();
   json object;
   try {
-    object = json::parse(content.toStdString());
+    if (!JsonCache::Load(path, object)) return details;
   } catch (std::exception& e) {
     return details;
   }
@@ -27,6 +27,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Foedag.h"
 #include "Main/WidgetFactory.h"
 #include "NewProject/ProjectManager/config.h"
+#include "Utils/FileUtils.h"
+#include "Utils/JsonCache.h"
 #include "Utils/QtUtils.h"
 
 using namespace FOEDAG;
@@ -148,6 +150,26 @@ QString Settings::getUserSettingsPath(int settingType) {
 }
 
 bool Settings::loadJsonFile(json* jsonObject, const QString& filePath) {
+  // Files on disk go through the binary sidecar cache, Qt resources are parsed
+  // directly
+  const std::filesystem::path path{filePath.toStdString()};
+  if (!filePath.startsWith(":") && FileUtils::FileExists(path)) {
+    SETTINGS_DBG_PRINT("Settings: Loading " + path.string() + "\n");
+    try {
+      json loaded;
+      if (JsonCache::Load(path, loaded)) {
+        jsonObject->update(loaded, true);
+        return true;
+      }
+    } catch (json::parse_error& e) {
+      // output exception information
+      std::cerr << "Json Error: " << e.what() << '\n'
+                << "filePath: " << filePath.toStdString() << "\n"
+                << "byte position of error: " << e.byte << std::endl;
+      return false;
+    }
+  }
+
   QFile jsonFile{filePath};
   if (jsonFile.exists() &&
       jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -0,0 +1,327 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "MessagesModel.h"
+
+#include <QAbstractTextDocumentLayout>
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QTextDocument>
+#include <algorithm>
+
+namespace FOEDAG {
+
+MessagesModel::MessagesModel(const QVector<MessageItemParser *> &parsers,
+                             QObject *parent)
+    : QAbstractItemModel{parent},
+      m_parsers{parsers},
+      m_infoIcon{":/img/info.png"},
+      m_errorIcon{":/images/error.png"},
+      m_warningIcon{":/img/warn.png"} {}
+
+void MessagesModel::addTask(const QString &title, const QString &logFile,
+                            bool fileExists,
+                            const ITaskReportManager::Messages &messages) {
+  const int row = static_cast<int>(m_tasks.size());
+  const int id = static_cast<int>(m_nodes.size());
+  const bool filtered = !m_filter.isEmpty();
+  if (filtered)
+    beginResetModel();
+  else
+    beginInsertRows(QModelIndex{}, row, row);
+  m_tasks.push_back(Task{title, logFile, fileExists, messages, id, {}});
+  m_nodes.push_back(Node{nullptr, -1, row, row, -1,
+                         static_cast<int>(messages.size())});
+  m_parsed.push_back(false);
+  if (filtered) {
+    applyFilter();
+    endResetModel();
+  } else {
+    endInsertRows();
+  }
+}
+
+void MessagesModel::setFilter(const QString &filter) {
+  if (filter == m_filter) return;
+  beginResetModel();
+  m_filter = filter;
+  applyFilter();
+  endResetModel();
+}
+
+void MessagesModel::applyFilter() {
+  for (auto &task : m_tasks) {
+    task.filtered.clear();
+    if (m_nodes[task.node].childCount == 0) continue;
+    if (m_nodes[task.node].firstChild == -1) {
+      if (m_filter.isEmpty()) continue;
+      // The filter needs every message of the task, nodes are cheap
+      fetchChildren(task.node);
+    }
+    const Node &node = m_nodes[task.node];
+    for (int i = 0; i < node.childCount; i++) {
+      const int child = node.firstChild + i;
+      if (m_filter.isEmpty()) {
+        m_nodes[child].row = i;
+      } else if (matches(*m_nodes[child].message)) {
+        m_nodes[child].row = static_cast<int>(task.filtered.size());
+        task.filtered.push_back(child);
+      }
+    }
+  }
+}
+
+QString MessagesModel::filter() const { return m_filter; }
+
+QVariant MessagesModel::data(const QModelIndex &index, int role) const {
+  const int id = nodeId(index);
+  if (id == -1) return {};
+  const Node &node = m_nodes[id];
+  const Task &task = m_tasks[node.task];
+  if (!node.message) return taskData(task, role);
+
+  const TaskMessage &message = *node.message;
+  switch (role) {
+    case Qt::DisplayRole:
+      return message.m_message;
+    case Qt::DecorationRole:
+      switch (message.m_severity) {
+        case MessageSeverity::INFO_MESSAGE:
+          return m_infoIcon;
+        case MessageSeverity::ERROR_MESSAGE:
+          return m_errorIcon;
+        case MessageSeverity::WARNING_MESSAGE:
+          return m_warningIcon;
+        default:
+          return {};
+      }
+    case FilePathRole:
+      return task.logFile;
+    case LineNumberRole:
+      return message.m_lineNr;
+    case HtmlRole:
+      if (auto info = link(id)) {
+        const QString fileName = info->fileName.toHtmlEscaped();
+        return message.m_message.toHtmlEscaped().replace(fileName,
+                                                         createLink(fileName));
+      }
+      return {};
+    case LineNumSrcFileRole:
+      if (auto info = link(id)) return info->line;
+      return {};
+    case LevelRole:
+      if (auto info = link(id)) return info->level;
+      return {};
+    default:
+      return {};
+  }
+}
+
+QVariant MessagesModel::headerData(int section, Qt::Orientation orientation,
+                                   int role) const {
+  if (section == 0 && orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    return tr("Task Messages");
+  return {};
+}
+
+QModelIndex MessagesModel::index(int row, int column,
+                                 const QModelIndex &parent) const {
+  if (row < 0 || column != 0 || row >= rowCount(parent)) return {};
+  const int parentId = nodeId(parent);
+  if (parentId == -1) return createIndex(row, column, m_tasks[row].node);
+  const Node &node = m_nodes[parentId];
+  const Task &task = m_tasks[node.task];
+  const bool filtered = !node.message && !m_filter.isEmpty();
+  const int id = filtered ? task.filtered[row] : node.firstChild + row;
+  return createIndex(row, column, id);
+}
+
+QModelIndex MessagesModel::parent(const QModelIndex &index) const {
+  const int id = nodeId(index);
+  if (id == -1) return {};
+  const int parentId = m_nodes[id].parent;
+  if (parentId == -1) return {};
+  return createIndex(m_nodes[parentId].row, 0, parentId);
+}
+
+int MessagesModel::rowCount(const QModelIndex &parent) const {
+  if (parent.column() > 0) return 0;
+  const int id = nodeId(parent);
+  if (id == -1) return static_cast<int>(m_tasks.size());
+  const Node &node = m_nodes[id];
+  if (!node.message && !m_filter.isEmpty()) {
+    return static_cast<int>(m_tasks[node.task].filtered.size());
+  }
+  return node.firstChild == -1 ? 0 : node.childCount;
+}
+
+int MessagesModel::columnCount(const QModelIndex &parent) const {
+  Q_UNUSED(parent);
+  return 1;
+}
+
+bool MessagesModel::hasChildren(const QModelIndex &parent) const {
+  const int id = nodeId(parent);
+  if (id == -1) return !m_tasks.empty();
+  const Node &node = m_nodes[id];
+  if (!node.message && !m_filter.isEmpty()) {
+    return !m_tasks[node.task].filtered.empty();
+  }
+  return node.childCount > 0;
+}
+
+bool MessagesModel::canFetchMore(const QModelIndex &parent) const {
+  const int id = nodeId(parent);
+  if (id == -1) return false;
+  return m_nodes[id].firstChild == -1 && m_nodes[id].childCount > 0;
+}
+
+void MessagesModel::fetchMore(const QModelIndex &parent) {
+  if (!canFetchMore(parent)) return;
+  const int id = nodeId(parent);
+  beginInsertRows(parent, 0, m_nodes[id].childCount - 1);
+  fetchChildren(id);
+  endInsertRows();
+}
+
+QString MessagesModel::createLink(const QString &str) {
+  return QString{"<a href=\"%1\">%1</a>"}.arg(str);
+}
+
+int MessagesModel::nodeId(const QModelIndex &index) const {
+  return index.isValid() ? static_cast<int>(index.internalId()) : -1;
+}
+
+void MessagesModel::fetchChildren(int id) {
+  const int first = static_cast<int>(m_nodes.size());
+  const int task = m_nodes[id].task;
+  const auto &messages = m_nodes[id].message
+                             ? m_nodes[id].message->m_childMessages
+                             : m_tasks[task].messages;
+  int row{0};
+  for (auto it = messages.cbegin(); it != messages.cend(); it++) {
+    const int childCount = static_cast<int>(it.value().m_childMessages.size());
+    m_nodes.push_back(Node{&it.value(), id, row++, task, -1, childCount});
+  }
+  m_nodes[id].firstChild = first;
+  m_parsed.resize(m_nodes.size(), false);
+}
+
+bool MessagesModel::matches(const TaskMessage &message) const {
+  if (message.m_message.contains(m_filter, Qt::CaseInsensitive)) return true;
+  for (const auto &child : message.m_childMessages)
+    if (matches(child)) return true;
+  return false;
+}
+
+const FileInfo *MessagesModel::link(int id) const {
+  if (!m_parsed[id]) {
+    m_parsed[id] = true;
+    for (const auto &parser : m_parsers) {
+      auto [found, info] = parser->parse(m_nodes[id].message->m_message);
+      if (found) {
+        m_links.emplace(id, info);
+        break;
+      }
+    }
+  }
+  auto it = m_links.find(id);
+  return it != m_links.end() ? &it->second : nullptr;
+}
+
+QVariant MessagesModel::taskData(const Task &task, int role) const {
+  const QString logFile =
+      task.fileExists ? task.logFile : tr("log file not found");
+  switch (role) {
+    case Qt::DisplayRole:
+      return QString{"%1 (%2)"}.arg(task.title, logFile);
+    case HtmlRole:
+      if (!task.fileExists) return {};
+      return QString{"%1 (%2)"}.arg(task.title.toHtmlEscaped(),
+                                    createLink(logFile.toHtmlEscaped()));
+    default:
+      return {};
+  }
+}
+
+// Lays out the rich text of the item, returns the top left of the text
+static QPointF layoutHtml(QTextDocument &doc, QStyleOptionViewItem &option,
+                          const QModelIndex &index) {
+  const QWidget *widget = option.widget;
+  QStyle *style = widget ? widget->style() : QApplication::style();
+  const QRect rect =
+      style->subElementRect(QStyle::SE_ItemViewItemText, &option, widget);
+  doc.setDocumentMargin(0);
+  doc.setDefaultFont(option.font);
+  doc.setHtml(index.data(MessagesModel::HtmlRole).toString());
+  const qreal top = (rect.height() - doc.size().height()) / 2;
+  return QPointF{rect.left() + 1.0, rect.top() + std::max(0.0, top)};
+}
+
+MessagesItemDelegate::MessagesItemDelegate(const LinkActivated &linkActivated,
+                                           QObject *parent)
+    : QStyledItemDelegate{parent}, m_linkActivated{linkActivated} {}
+
+void MessagesItemDelegate::paint(QPainter *painter,
+                                 const QStyleOptionViewItem &option,
+                                 const QModelIndex &index) const {
+  if (!index.data(MessagesModel::HtmlRole).isValid())
+    return QStyledItemDelegate::paint(painter, option, index);
+
+  QStyleOptionViewItem opt{option};
+  initStyleOption(&opt, index);
+  opt.text.clear();
+  const QWidget *widget = opt.widget;
+  QStyle *style = widget ? widget->style() : QApplication::style();
+  style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+  QTextDocument doc;
+  const QPointF topLeft = layoutHtml(doc, opt, index);
+  painter->save();
+  painter->translate(topLeft);
+  doc.drawContents(painter);
+  painter->restore();
+}
+
+bool MessagesItemDelegate::editorEvent(QEvent *event,
+                                       QAbstractItemModel *model,
+                                       const QStyleOptionViewItem &option,
+                                       const QModelIndex &index) {
+  if (event->type() == QEvent::MouseButtonRelease &&
+      index.data(MessagesModel::HtmlRole).isValid()) {
+    auto mouseEvent = static_cast<QMouseEvent *>(event);
+    if (mouseEvent->button() == Qt::LeftButton) {
+      QStyleOptionViewItem opt{option};
+      initStyleOption(&opt, index);
+      QTextDocument doc;
+      const QPointF topLeft = layoutHtml(doc, opt, index);
+      const QString anchor =
+          doc.documentLayout()->anchorAt(mouseEvent->position() - topLeft);
+      if (!anchor.isEmpty() && m_linkActivated) {
+        m_linkActivated(index, anchor);
+        return true;
+      }
+    }
+  }
+  return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,144 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QIcon>
+#include <QStyledItemDelegate>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "Compiler/Reports/ITaskReportManager.h"
+#include "MessageItemParser.h"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The MessagesModel class. Tree of the task messages. The messages are
+ * kept in the report managers maps, a node is only created for the messages
+ * of an expanded item.
+ */
+class MessagesModel final : public QAbstractItemModel {
+  Q_OBJECT
+
+ public:
+  enum Roles {
+    FilePathRole = Qt::UserRole + 1,
+    LineNumberRole,
+    LineNumSrcFileRole,
+    LevelRole,
+    // Display text with the file links, only set for the items with links
+    HtmlRole,
+  };
+
+  explicit MessagesModel(const QVector<MessageItemParser *> &parsers,
+                         QObject *parent = nullptr);
+
+  /*!
+   * \brief addTask. Add a top level item for a task. \param messages is
+   * shared, not copied, and only read when the task is expanded.
+   */
+  void addTask(const QString &title, const QString &logFile, bool fileExists,
+               const ITaskReportManager::Messages &messages);
+
+  /*!
+   * \brief setFilter. Show only the messages containing \param filter, or
+   * having a child message containing it. Empty filter shows all.
+   */
+  void setFilter(const QString &filter);
+  QString filter() const;
+
+  QVariant data(const QModelIndex &index, int role) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+  QModelIndex index(int row, int column,
+                    const QModelIndex &parent = QModelIndex()) const override;
+  QModelIndex parent(const QModelIndex &index) const override;
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
+
+  static QString createLink(const QString &str);
+
+ private:
+  struct Node {
+    const TaskMessage *message;  // nullptr for the task items
+    int parent;                  // -1 for the task items
+    int row;                     // row under the parent, follows the filter
+    int task;
+    int firstChild;  // children are contiguous, -1 until fetched
+    int childCount;
+  };
+  struct Task {
+    QString title;
+    QString logFile;
+    bool fileExists;
+    ITaskReportManager::Messages messages;
+    int node;
+    std::vector<int> filtered;  // visible children when filtering
+  };
+
+  int nodeId(const QModelIndex &index) const;
+  void fetchChildren(int id);
+  void applyFilter();
+  bool matches(const TaskMessage &message) const;
+  const FileInfo *link(int id) const;
+  QVariant taskData(const Task &task, int role) const;
+
+  const QVector<MessageItemParser *> m_parsers;
+  std::vector<Node> m_nodes;
+  std::vector<Task> m_tasks;
+  QString m_filter;
+  // Parsed lazily, when the item is shown
+  mutable std::unordered_map<int, FileInfo> m_links;
+  mutable std::vector<bool> m_parsed;
+  const QIcon m_infoIcon;
+  const QIcon m_errorIcon;
+  const QIcon m_warningIcon;
+};
+
+/*!
+ * \brief The MessagesItemDelegate class. Paints MessagesModel::HtmlRole as
+ * rich text and reports the clicked links.
+ */
+class MessagesItemDelegate final : public QStyledItemDelegate {
+ public:
+  using LinkActivated =
+      std::function<void(const QModelIndex &, const QString &)>;
+  MessagesItemDelegate(const LinkActivated &linkActivated,
+                       QObject *parent = nullptr);
+
+  void paint(QPainter *painter, const QStyleOptionViewItem &option,
+             const QModelIndex &index) const override;
+
+ protected:
+  bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                   const QStyleOptionViewItem &option,
+                   const QModelIndex &index) override;
+
+ private:
+  LinkActivated m_linkActivated;
+};
+
+}  // namespace FOEDAG
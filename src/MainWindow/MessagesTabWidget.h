@@ -20,14 +20,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <QModelIndex>
 #include <QWidget>
 #include <filesystem>
 
-class QTreeWidgetItem;
-
 namespace FOEDAG {
 class TaskManager;
-struct TaskMessage;
 class MessageItemParser;
 
 class MessagesTabWidget final : public QWidget {
@@ -39,17 +37,12 @@ class MessagesTabWidget final : public QWidget {
 
  private slots:
   // Reacts on double click on one of tree items.
-  void onMessageClicked(const QTreeWidgetItem *item, int col);
+  void onMessageClicked(const QModelIndex &index);
 
  private:
-  QTreeWidgetItem *createTaskMessageItem(const TaskMessage &msg,
-                                         const QString &filePath);
-  QTreeWidgetItem *createItem(const QString &message);
-  static QString createLink(const QString &str);
   static QStringList loadSuppressList(const std::filesystem::path &dataPath);
 
   const TaskManager &m_taskManager;
-  QVector<QTreeWidgetItem *> m_convertToLabel;
   const QVector<MessageItemParser *> m_parsers;
 };
 
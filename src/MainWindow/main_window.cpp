@@ -1946,6 +1946,8 @@ void MainWindow::compressProject() {
   auto cmdStack = GlobalSession->CmdStack();
   auto logs = {cmdStack->CmdLogger(), cmdStack->OutLogger(),
                cmdStack->PerfLogger()};
+  // The loggers write from a background thread, archive complete logs
+  Logger::flushAll();
   for (auto logger : logs) {
     cProject.appendPathForArchive(std::filesystem::current_path() /
                                   logger->fileName());
@@ -52,42 +52,35 @@ void ProgrammerGuiIntegration::Devices(const Cable &cable,
   emit autoDetect();
 }
 
-void ProgrammerGuiIntegration::Progress(const std::string &progress) {
-  emit this->progress({m_current.first, m_current.second, m_type}, progress);
+void ProgrammerGuiIntegration::Progress(const Cable &cable,
+                                        const Device &device,
+                                        const std::string &progress) {
+  emit this->progress({cable, device, type(cable, device)}, progress);
 }
 
 void ProgrammerGuiIntegration::ProgramFpga(const Cable &cable,
                                            const Device &device,
                                            const std::string &file) {
-  m_current = std::make_pair(cable, device);
-  m_type = Type::Fpga;
   m_files[device].bitstream = file;
-  m_stop = false;
-  emit programStarted({cable, device, m_type});
+  started(cable, device, Type::Fpga);
 }
 
 void ProgrammerGuiIntegration::ProgramOtp(const Cable &cable,
                                           const Device &device,
                                           const std::string &file) {
-  m_current = std::make_pair(cable, device);
-  m_type = Type::Otp;
   m_files[device].bitstream = file;
-  m_stop = false;
-  emit programStarted({cable, device, m_type});
+  started(cable, device, Type::Otp);
 }
 
 void ProgrammerGuiIntegration::Flash(const Cable &cable, const Device &device,
                                      const std::string &file) {
-  m_current = std::make_pair(cable, device);
-  m_type = Type::Flash;
   m_files[device].flashBitstream = file;
-  m_stop = false;
-  emit programStarted({cable, device, m_type});
+  started(cable, device, Type::Flash);
 }
 
 void ProgrammerGuiIntegration::Status(const Cable &cable, const Device &device,
                                       int status) {
-  emit this->status({cable, device, m_type}, status);
+  emit this->status({cable, device, type(cable, device)}, status);
 }
 
 std::atomic_bool &ProgrammerGuiIntegration::Stop() { return m_stop; }
@@ -103,4 +96,16 @@ std::string ProgrammerGuiIntegration::File(const ProgrammerDevice &dev,
 
 void ProgrammerGuiIntegration::StopLastProcess() { m_stop = true; }
 
+void ProgrammerGuiIntegration::started(const Cable &cable,
+                                       const Device &device, Type type) {
+  m_types[{cable.name, device.index}] = type;
+  emit programStarted({cable, device, type});
+}
+
+Type ProgrammerGuiIntegration::type(const Cable &cable,
+                                    const Device &device) const {
+  auto it = m_types.find({cable.name, device.index});
+  return it != m_types.end() ? it->second : Type{};
+}
+
 }  // namespace FOEDAG
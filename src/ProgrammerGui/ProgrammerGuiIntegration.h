@@ -42,7 +42,8 @@ class ProgrammerGuiIntegration : public QObject, public ProgrammerGuiInterface {
       &devices() const;
   void Cables(const std::vector<Cable> &cables) override;
   void Devices(const Cable &cable, const std::vector<Device> &devices) override;
-  void Progress(const std::string &progress) override;
+  void Progress(const Cable &cable, const Device &device,
+                const std::string &progress) override;
   void ProgramFpga(const Cable &cable, const Device &device,
                    const std::string &file) override;
   void ProgramOtp(const Cable &cable, const Device &device,
@@ -62,11 +63,14 @@ class ProgrammerGuiIntegration : public QObject, public ProgrammerGuiInterface {
   void status(const DeviceEntity &, int status);
 
  private:
+  void started(const Cable &cable, const Device &device, Type type);
+  Type type(const Cable &cable, const Device &device) const;
+
   sequential_map<ProgrammerCable, std::vector<ProgrammerDevice>> m_devices;
-  std::pair<ProgrammerCable, ProgrammerDevice> m_current;
   std::map<ProgrammerDevice, DeviceBitstream> m_files;
-  Type m_type{};
-  std::atomic_bool m_stop;
+  // Running type of each device, several devices can be programmed at once
+  std::map<std::pair<std::string, uint32_t>, Type> m_types;
+  std::atomic_bool m_stop{false};
 };
 
 }  // namespace FOEDAG
@@ -299,7 +299,6 @@ void ProgrammerMain::startPressed() {
 
 void ProgrammerMain::stopPressed() {
   ui->actionStop->setEnabled(false);
-  m_stop = true;
   m_guiIntegration->StopLastProcess();
   GlobalSession->GetCompiler()->ErrorMessage("Interrupted by user");
 }
@@ -630,7 +629,6 @@ bool ProgrammerMain::VerifyDevices() {
 
 void ProgrammerMain::start() {
   m_programmingDone = false;
-  m_stop = false;
   m_status = None;
   QVector<DeviceInfo *> runningDevices;
   for (auto d : std::as_const(m_deviceSettings)) {
@@ -639,29 +637,33 @@ void ProgrammerMain::start() {
   }
 
   cleanupStatusAndProgress();
-  while (!runningDevices.isEmpty()) {
-    if (m_stop) break;
-    auto dev = runningDevices.first();
-    bool result{false};
+  // One batch runs the cables concurrently, each job updates its own row
+  QStringList options{};
+  QStringList files{};
+  bool otp{false};
+  for (auto dev : std::as_const(runningDevices)) {
+    QString type{};
+    QString operations{"program"};
     if (!dev->isFlash) {  // device
       if (dev->options.operations.contains(Configure)) {
-        result =
-            EvalCommand(QString{"programmer fpga_config -c %1 -d %2 %3"}.arg(
-                dev->cable.name(), QString::number(dev->dev.index()),
-                dev->options.file));
+        type = "fpga_config";
       } else if (dev->options.operations.contains(ProgramOtp)) {
-        result = EvalCommand(QString{"programmer otp -c %1 -d %2 -y %3"}.arg(
-            dev->cable.name(), QString::number(dev->dev.index()),
-            dev->options.file));
+        type = "otp";
+        otp = true;
       }
     } else {  // flash
-      auto operations = dev->options.operations.join(",").toLower();
-      result = EvalCommand(QString{"programmer flash -c %1 -d %2 -o %3 %4"}.arg(
-          dev->cable.name(), QString::number(dev->dev.index()), operations,
-          dev->options.file));
+      type = "flash";
+      operations = dev->options.operations.join(",").toLower();
     }
-    runningDevices.removeFirst();
-    if (!result) break;
+    if (type.isEmpty()) continue;
+    options.append(QString{"-c %1 -d %2 -t %3 -o %4"}.arg(
+        dev->cable.name(), QString::number(dev->dev.index()), type,
+        operations));
+    files.append(dev->options.file);
+  }
+  if (!files.isEmpty()) {
+    EvalCommand(QString{"programmer batch %1%2 %3"}.arg(
+        options.join(" "), otp ? " -y" : "", files.join(" ")));
   }
   m_programmingDone = true;
   QtUtils::AppendToEventQueue([this]() {
@@ -672,7 +674,8 @@ void ProgrammerMain::start() {
 void ProgrammerMain::setStatus(DeviceInfo *deviceInfo, Status status) {
   auto item = m_items.key(deviceInfo);
   if (item) {
-    m_status = status;
+    // devices finish in any order, a failure colors the summary until the end
+    if (m_status != Failed) m_status = status;
     item->setText(STATUS_COL, ToString(status));
     item->setForeground(STATUS_COL, QBrush{StatusColor(status)});
     ui->treeWidget->itemWidget(item, PROGRESS_COL)
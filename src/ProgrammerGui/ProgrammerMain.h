@@ -115,7 +115,6 @@ class ProgrammerMain : public QMainWindow, public TopLevelInterface {
   QAction *m_progressAction{nullptr};
   QVector<DeviceInfo *> m_deviceSettings;
   QTreeWidgetItem *m_currentItem{nullptr};
-  bool m_stop{false};
   SummaryProgressBar m_mainProgress;
   QMap<QTreeWidgetItem *, DeviceInfo *> m_items;
   QSettings m_settings;
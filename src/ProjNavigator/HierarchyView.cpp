@@ -23,9 +23,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QMenu>
 #include <QTreeWidget>
+#include <sstream>
 
+#include "Utils/FileUtils.h"
 #include "Utils/StringUtils.h"
 
 static int FileRole = Qt::UserRole + 1;
@@ -60,21 +63,27 @@ void HierarchyView::update() {
   clean();
   bool fileParsed{false};
 
+  // hier_info.json is streamed, the json DOM is never built
   QString jFile = QString::fromStdString(m_portsFile.string());
-  QFile jsonFile{jFile};
-  if (jsonFile.exists() &&
-      jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    // Read/parse json from file and update the passed jsonObject w/ new vals
-    QString jsonStr = jsonFile.readAll();
-    json jsonObject;
-    try {
-      jsonObject.update(json::parse(jsonStr.toStdString()), true);
-      parseJson(jsonObject);
-      fileParsed = true;
-    } catch (std::exception &e) {
-      qWarning() << "Failed to parse " << jFile << ". Error: " << e.what();
+  HierInfo info;
+  std::pair<bool, std::string> status{false, {}};
+  if (!jFile.startsWith(":") && FileUtils::FileExists(m_portsFile)) {
+    status = HierInfoReader::Read(m_portsFile, info);
+  } else {
+    QFile jsonFile{jFile};
+    if (jsonFile.exists() &&
+        jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      std::istringstream stream{jsonFile.readAll().toStdString()};
+      status = HierInfoReader::Read(stream, info);
     }
   }
+  if (status.first) {
+    parseHierInfo(info);
+    fileParsed = true;
+  } else if (!status.second.empty()) {
+    qWarning() << "Failed to parse " << jFile
+               << ". Error: " << status.second.c_str();
+  }
 
   if (fileParsed) {
     for (auto &module : m_topVector) {
@@ -155,13 +164,12 @@ QTreeWidgetItem *HierarchyView::addItem(QTreeWidgetItem *parent,
   return it;
 }
 
-void HierarchyView::parseJson(json &jsonObject) {
-  auto files = jsonObject.at("fileIDs");
+void HierarchyView::parseHierInfo(const HierInfo &info) {
   m_files.insert(0, QString::fromStdString(std::string("")));
-  for (auto it = files.begin(); it != files.end(); it++) {
-    const auto &[value, ok] = StringUtils::to_number<int>(it.key());
+  for (const auto &[id, name] : info.fileIDs) {
+    const auto &[value, ok] = StringUtils::to_number<int>(id);
     if (ok) {
-      auto file = std::filesystem::path{it.value().get<std::string>()};
+      auto file = std::filesystem::path{name};
       if (file.is_relative()) {
         file = m_portsFile.parent_path() / file;
         file = file.lexically_normal();
@@ -170,58 +178,50 @@ void HierarchyView::parseJson(json &jsonObject) {
     }
   }
 
-  auto parseModuleInst = [this](json &moduleInst, Module *module) {
-    for (auto it = moduleInst.begin(); it != moduleInst.end(); it++) {
+  auto parseModuleInst = [](const std::vector<HierInfo::Inst> &moduleInst,
+                            Module *module, const QMap<int, QString> &files) {
+    for (const auto &inst : moduleInst) {
       Module *mod = new Module;
-      mod->name = QString::fromStdString(it->at("module").get<std::string>());
-      mod->instLine = QString::number(it->at("line").get<int>());
-      const auto &[num, ok] =
-          StringUtils::to_number<int>(it->at("file").get<std::string>());
-      if (ok) mod->instFile = m_files.value(num);
-      mod->instName =
-          QString::fromStdString(it->at("instName").get<std::string>());
+      mod->name = QString::fromStdString(inst.module);
+      mod->instLine = QString::number(inst.line);
+      const auto &[num, ok] = StringUtils::to_number<int>(inst.file);
+      if (ok) mod->instFile = files.value(num);
+      mod->instName = QString::fromStdString(inst.instName);
       module->moduleInst.append(mod);
     }
   };
 
-  auto parseModule = [this, parseModuleInst](json &moduleInst, Module *module) {
-    module->line = QString::number(moduleInst.at("line").get<int>());
-    const auto &[num, ok] =
-        StringUtils::to_number<int>(moduleInst.at("file").get<std::string>());
+  auto parseModule = [this, parseModuleInst](const HierInfo::Module &in,
+                                             Module *module) {
+    module->line = QString::number(in.line);
+    const auto &[num, ok] = StringUtils::to_number<int>(in.file);
     if (ok) module->file = m_files.value(num);
-    if (moduleInst.contains("moduleInsts")) {
-      auto moduleInsts = moduleInst.at("moduleInsts");
-      parseModuleInst(moduleInsts, module);
-    }
+    parseModuleInst(in.moduleInsts, module, m_files);
   };
 
   // top module parsing
   QString topModuleFile;
-  auto hierTree = jsonObject.at("hierTree");
-  for (auto it = hierTree.begin(); it != hierTree.end(); it++) {
-    auto topModule = it->at("topModule");
+  for (const auto &topModule : info.hierTree) {
     const auto &[topModuleFileId, ok] =
-        StringUtils::to_number<int>(it->at("file"));
+        StringUtils::to_number<int>(topModule.file);
     if (ok) topModuleFile = m_files.value(topModuleFileId, {});
     Module m_top;
-    m_top.name = QString::fromStdString(topModule.get<std::string>());
-    parseModule(*it, &m_top);
+    m_top.name = QString::fromStdString(topModule.name);
+    parseModule(topModule, &m_top);
 
     // all modules parsing
-    auto modules = jsonObject.at("modules");
     QVector<Module *> allModules;
-    for (auto m = modules.begin(); m != modules.end(); m++) {
+    QHash<QString, Module *> modulesByName;
+    for (const auto &[name, module] : info.modules) {
       Module *newMod = new Module;
       allModules.append(newMod);
-      newMod->name = QString::fromStdString(m.key());
-      auto in = m.value();
-      parseModule(in, newMod);
+      newMod->name = QString::fromStdString(name);
+      parseModule(module, newMod);
+      modulesByName.insert(newMod->name, newMod);
     }
 
-    auto getInst = [allModules](const QString &name) -> Module * {
-      for (auto m : allModules)
-        if (m->name == name) return m;
-      return nullptr;
+    auto getInst = [&modulesByName](const QString &name) -> Module * {
+      return modulesByName.value(name, nullptr);
     };
 
     // update all modules instances
@@ -26,8 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QVector>
 #include <filesystem>
 
-#include "nlohmann_json/json.hpp"
-using json = nlohmann::ordered_json;
+#include "DesignQuery/HierInfoReader.h"
 
 class QTreeWidget;
 class QTreeWidgetItem;
@@ -65,7 +64,7 @@ class HierarchyView : public QObject {
 
  private:
   QTreeWidgetItem *addItem(QTreeWidgetItem *parent, Module *module);
-  void parseJson(json &jsonObject);
+  void parseHierInfo(const HierInfo &info);
   void emitOpenFile(QTreeWidgetItem *item, int column);
   void emitOpenInstFile(QTreeWidgetItem *item, int column);
 
@@ -0,0 +1,142 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Utils/JsonCache.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace FOEDAG {
+
+// Sidecar layout: magic, source size, source hash, CBOR payload
+static constexpr char SidecarMagic[8] = {'F', 'J', 'C', 'B',
+                                         'O', 'R', '0', '1'};
+static constexpr size_t SidecarHeaderSize =
+    sizeof(SidecarMagic) + 2 * sizeof(uint64_t);
+
+std::filesystem::path JsonCache::SidecarPath(
+    const std::filesystem::path& path) {
+  std::filesystem::path sidecar{path};
+  sidecar += ".cbor";
+  return sidecar;
+}
+
+std::filesystem::path JsonCache::TempPath(const std::filesystem::path& path) {
+  // Unique per process and per call: the GUI and a batch run may refresh the
+  // same sidecar at once
+  static std::atomic<uint32_t> counter{0};
+  std::random_device random;
+  std::ostringstream suffix;
+  suffix << "." << getpid() << "." << std::hex << random() << counter++
+         << ".tmp";
+  std::filesystem::path tmp{path};
+  tmp += suffix.str();
+  return tmp;
+}
+
+uint64_t JsonCache::Hash(const std::string& content) {
+  // FNV-1a, good enough to detect a modified source
+  uint64_t hash{14695981039346656037ULL};
+  for (unsigned char c : content) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+template <typename Json>
+bool JsonCache::LoadImpl(const std::filesystem::path& path, Json& json) {
+  std::ifstream stream{path, std::ios::binary};
+  if (!stream.good()) return false;
+  const std::string content{std::istreambuf_iterator<char>{stream},
+                            std::istreambuf_iterator<char>{}};
+  stream.close();
+  const uint64_t size = content.size();
+  const uint64_t hash = Hash(content);
+
+  const std::filesystem::path sidecar = SidecarPath(path);
+  std::ifstream cached{sidecar, std::ios::binary};
+  if (cached.good()) {
+    const std::vector<uint8_t> data{std::istreambuf_iterator<char>{cached},
+                                    std::istreambuf_iterator<char>{}};
+    uint64_t cachedSize{0};
+    uint64_t cachedHash{0};
+    if (data.size() > SidecarHeaderSize &&
+        std::memcmp(data.data(), SidecarMagic, sizeof(SidecarMagic)) == 0) {
+      std::memcpy(&cachedSize, data.data() + sizeof(SidecarMagic),
+                  sizeof(uint64_t));
+      std::memcpy(&cachedHash,
+                  data.data() + sizeof(SidecarMagic) + sizeof(uint64_t),
+                  sizeof(uint64_t));
+      if (cachedSize == size && cachedHash == hash) {
+        try {
+          json = Json::from_cbor(data.begin() + SidecarHeaderSize, data.end());
+          return true;
+        } catch (nlohmann::json::exception&) {
+          // corrupted sidecar, fall back to the source
+        }
+      }
+    }
+  }
+
+  json = Json::parse(content);
+
+  // Refresh the sidecar, write to a temporary file first so concurrent
+  // readers never see a partially written cache.
+  const std::filesystem::path tmp = TempPath(sidecar);
+  std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+  std::error_code ec;
+  if (!out.good()) {
+    std::filesystem::remove(tmp, ec);
+  } else {
+    const std::vector<uint8_t> cbor = Json::to_cbor(json);
+    out.write(SidecarMagic, sizeof(SidecarMagic));
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    out.write(reinterpret_cast<const char*>(cbor.data()), cbor.size());
+    out.close();
+    if (out.good()) std::filesystem::rename(tmp, sidecar, ec);
+    if (!out.good() || ec) std::filesystem::remove(tmp, ec);
+  }
+  return true;
+}
+
+bool JsonCache::Load(const std::filesystem::path& path, nlohmann::json& json) {
+  return LoadImpl(path, json);
+}
+
+bool JsonCache::Load(const std::filesystem::path& path,
+                     nlohmann::ordered_json& json) {
+  return LoadImpl(path, json);
+}
+
+}  // namespace FOEDAG
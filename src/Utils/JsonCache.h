@@ -0,0 +1,62 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "nlohmann_json/json.hpp"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The JsonCache class loads json files through a binary (CBOR) sidecar
+ * file stored next to the source as <file>.cbor. The sidecar is keyed on the
+ * size and the content hash of the source and is rebuilt whenever either of
+ * them changes. If the sidecar can't be written (e.g. read-only install
+ * directory) the textual json is parsed as usual.
+ */
+class JsonCache final {
+ public:
+  /*!
+   * \brief Load parse \a path into \a json. Throws nlohmann::json::exception
+   * in the same way json::parse does when the source is malformed.
+   * \return false if the file can't be read.
+   */
+  static bool Load(const std::filesystem::path& path, nlohmann::json& json);
+  static bool Load(const std::filesystem::path& path,
+                   nlohmann::ordered_json& json);
+
+  static std::filesystem::path SidecarPath(const std::filesystem::path& path);
+  static uint64_t Hash(const std::string& content);
+  /*!
+   * \brief Unique temporary file next to \a path, named
+   * <path>.<pid>.<random>.tmp
+   */
+  static std::filesystem::path TempPath(const std::filesystem::path& path);
+
+ private:
+  template <typename Json>
+  static bool LoadImpl(const std::filesystem::path& path, Json& json);
+};
+
+}  // namespace FOEDAG
@@ -21,6 +21,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Configuration/CFGCommon/CFGCommon.h"
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 #include "compiler_tcl_infra_common.h"
 #include "gtest/gtest.h"
 
@@ -304,6 +309,168 @@ TEST(CFGCommon, test_number_to_unit_string) {
   EXPECT_EQ(CFG_convert_number_to_unit_string(123456789), "123456789");
 }
 
+TEST(CFGCommon, test_compare_files) {
+  // Larger than a chunk, the difference is in the last one
+  std::vector<uint8_t> data(CFG_FILE_CHUNK_SIZE * 2 + 10);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = uint8_t(i * 7);
+  }
+  CFG_write_binary_file("cfg_compare_1.bin", &data[0], data.size());
+  CFG_write_binary_file("cfg_compare_2.bin", &data[0], data.size());
+  EXPECT_TRUE(CFG_compare_two_binary_files("cfg_compare_1.bin",
+                                           "cfg_compare_2.bin"));
+  data.back()++;
+  CFG_write_binary_file("cfg_compare_2.bin", &data[0], data.size());
+  EXPECT_FALSE(CFG_compare_two_binary_files("cfg_compare_1.bin",
+                                            "cfg_compare_2.bin"));
+  CFG_write_binary_file("cfg_compare_2.bin", &data[0], data.size() - 1);
+  EXPECT_FALSE(CFG_compare_two_binary_files("cfg_compare_1.bin",
+                                            "cfg_compare_2.bin"));
+  size_t chunks = 0;
+  size_t size = 0;
+  CFG_read_binary_file_chunks("cfg_compare_1.bin",
+                              [&](const uint8_t* chunk, size_t chunk_size) {
+                                chunks++;
+                                size += chunk_size;
+                                return true;
+                              });
+  EXPECT_EQ(chunks, 3);
+  EXPECT_EQ(size, data.size());
+
+  std::ofstream("cfg_compare_1.txt") << "line 1\nline 2\nline 3\n";
+  std::ofstream("cfg_compare_2.txt") << "line 1\nline 2\nline 3\n";
+  EXPECT_TRUE(CFG_compare_two_text_files("cfg_compare_1.txt",
+                                         "cfg_compare_2.txt"));
+  std::ofstream("cfg_compare_2.txt") << "line 1\nline 2\n";
+  EXPECT_FALSE(CFG_compare_two_text_files("cfg_compare_1.txt",
+                                          "cfg_compare_2.txt"));
+  std::ofstream("cfg_compare_2.txt") << "line 1\nline 0\nline 3\n";
+  EXPECT_FALSE(CFG_compare_two_text_files("cfg_compare_1.txt",
+                                          "cfg_compare_2.txt"));
+  std::vector<std::string> lines;
+  CFG_read_text_file_lines(
+      "cfg_compare_1.txt",
+      [&lines](const std::string& line) {
+        lines.push_back(line);
+        return lines.size() < 2;
+      },
+      false);
+  EXPECT_EQ(lines, std::vector<std::string>({"line 1", "line 2"}));
+  for (auto file : {"cfg_compare_1.bin", "cfg_compare_2.bin",
+                    "cfg_compare_1.txt", "cfg_compare_2.txt"}) {
+    std::remove(file);
+  }
+}
+
+#ifndef _WIN32
+TEST(CFGCommon, test_execute_cmd) {
+  std::atomic<bool> stop = false;
+  std::string output = "";
+  std::vector<std::string> lines;
+  int status = CFG_execute_cmd_with_callback(
+      "echo out; echo err 1>&2; exit 3", output, nullptr, std::regex{}, stop,
+      nullptr, [&](const std::string& line) { lines.push_back(line); });
+  EXPECT_EQ(status, 3);
+  // stderr is passed to the callback but not stored
+  EXPECT_EQ(output, "out\n");
+  std::sort(lines.begin(), lines.end());
+  EXPECT_EQ(lines, std::vector<std::string>({"err\n", "out\n"}));
+}
+
+TEST(CFGCommon, test_execute_cmd_output_limit) {
+  std::atomic<bool> stop = false;
+  std::string output = "";
+  std::ostringstream stream;
+  int status = CFG_execute_cmd("seq 1 10000", output, &stream, stop, 12);
+  EXPECT_EQ(status, 0);
+  EXPECT_EQ(output, "\n9999\n10000\n");
+  EXPECT_EQ(stream.str().size(), 48894);
+}
+
+TEST(CFGCommon, test_execute_cmd_stop) {
+  std::atomic<bool> stop = false;
+  std::string output = "";
+  std::thread stopper([&stop]() {
+    CFG_sleep_ms(200);
+    stop = true;
+  });
+  auto start = std::chrono::steady_clock::now();
+  int status = CFG_execute_cmd("echo started; sleep 10", output, nullptr, stop);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  stopper.join();
+  EXPECT_EQ(status, -1);
+  EXPECT_EQ(output, "started\n");
+  EXPECT_LT(elapsed, std::chrono::seconds(5));
+}
+
+TEST(CFGCommon, test_execute_cmd_stop_children) {
+  std::atomic<bool> stop = false;
+  std::string output = "";
+  std::thread stopper([&stop]() {
+    CFG_sleep_ms(200);
+    stop = true;
+  });
+  // The shell waits for a background child, which must be stopped as well
+  int status =
+      CFG_execute_cmd("sleep 30 & echo $!; wait", output, nullptr, stop);
+  stopper.join();
+  EXPECT_EQ(status, -1);
+  std::string child = output.substr(0, output.find('\n'));
+  ASSERT_FALSE(child.empty());
+  CFG_sleep_ms(100);
+  stop = false;
+  std::string state = "";
+  CFG_execute_cmd("ps -o stat= -p " + child, state, nullptr, stop);
+  // Gone, or a zombie waiting to be reaped by init
+  size_t first = state.find_first_not_of(" \n");
+  EXPECT_TRUE(first == std::string::npos || state[first] == 'Z') << state;
+}
+
+TEST(CFGCommon, test_execute_cmd_stop_ignoring_term) {
+  std::atomic<bool> stop = false;
+  std::string output = "";
+  std::thread stopper([&stop]() {
+    CFG_sleep_ms(200);
+    stop = true;
+  });
+  // SIGTERM is ignored by the shell and by sleep, SIGKILL follows
+  auto start = std::chrono::steady_clock::now();
+  int status = CFG_execute_cmd("trap '' TERM; echo started; sleep 30", output,
+                               nullptr, stop);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  stopper.join();
+  EXPECT_EQ(status, -1);
+  EXPECT_EQ(output, "started\n");
+  EXPECT_LT(elapsed, std::chrono::seconds(10));
+}
+
+#ifdef __linux__
+TEST(CFGCommon, test_execute_cmd_pipes_not_inherited) {
+  std::atomic<bool> stop = false;
+  auto count_pipes = [&stop]() {
+    std::string fds = "";
+    CFG_execute_cmd("ls -l /proc/self/fd", fds, nullptr, stop);
+    size_t count = 0;
+    for (size_t pos = fds.find("pipe:"); pos != std::string::npos;
+         pos = fds.find("pipe:", pos + 1)) {
+      count++;
+    }
+    return count;
+  };
+  size_t alone = count_pipes();
+  // The pipes of a command running on another thread stay out of this one
+  std::thread other([&stop]() {
+    std::string output = "";
+    CFG_execute_cmd("sleep 1", output, nullptr, stop);
+  });
+  CFG_sleep_ms(200);
+  size_t concurrent = count_pipes();
+  other.join();
+  EXPECT_EQ(concurrent, alone);
+}
+#endif
+#endif
+
 TEST(CFGCommon, test_python) {
   std::map<std::string, CFG_Python_OBJ> pobjs = CFG_Python(
       {"a=1", "b=3", "c=a+b", "d='%d'%(c*b)"}, {"a", "b", "c", "d", "e", "f"});
@@ -22,6 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Configuration/Programmer/Programmer.h"
 #include <fstream> // for std::ofstream
+#include <filesystem>
+#include <map>
+#include <set>
+#include <thread>
 
 #include "Configuration/CFGCommon/CFGCommon.h"
 #include "Configuration/Programmer/Programmer_helper.h"
@@ -249,6 +253,20 @@ TEST_F(ProgrammerAPI_ProgramFlashAndFpga, ProgramOtpCableNotFoundTest) {
   EXPECT_EQ(expected, actual);
 }
 
+TEST_F(ProgrammerAPI_ProgramFlashAndFpga, ProgramDevicesCableNotFoundTest) {
+  std::vector<ProgrammingJob> jobs(2);
+  jobs[0].cable.name = "cable_a";
+  jobs[1].cable.name = "cable_b";
+  jobs[1].type = ProgramType::Flash;
+  std::vector<size_t> finished;
+  int actual = ProgramDevices(jobs, stop, nullptr,
+                              [&](size_t job, int) { finished.push_back(job); });
+  EXPECT_EQ(actual, ProgrammerErrorCode::CableNotFound);
+  EXPECT_EQ(jobs[0].status, ProgrammerErrorCode::CableNotFound);
+  EXPECT_EQ(jobs[1].status, ProgrammerErrorCode::CableNotFound);
+  EXPECT_EQ(finished.size(), 2);
+}
+
 TEST(InitLibraryTest, EmptyPath) {
   std::string emptyPath = "";
   int result = InitLibrary(emptyPath);
@@ -271,6 +289,112 @@ TEST(InitLibraryTest, ValidPath) {
   std::remove(validPath.c_str());
 }
 
+// Runs the jobs through OpenocdAdapter with a stand-in openocd script that
+// configures the FPGA in three steps of 200ms
+class ProgrammingJobsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::ofstream script(openocd);
+    script << "#!/bin/sh\n"
+           << "for p in 25.00 50.00 75.00; do\n"
+           << "  echo \"Progress $p% (1/4 bytes)\"\n"
+           << "  sleep 0.2\n"
+           << "done\n"
+           << "echo \"[RS] Configured FPGA fabric successfully\"\n";
+    script.close();
+    std::filesystem::permissions(openocd, std::filesystem::perms::owner_all);
+    std::ofstream{bitfile};
+  }
+
+  void TearDown() override {
+    std::remove(openocd.c_str());
+    std::remove(bitfile.c_str());
+  }
+
+  void AddJob(const std::string& cable, uint32_t index) {
+    ProgrammingJob job;
+    job.cable.name = cable;
+    job.device.index = index;
+    job.device.cable = job.cable;
+    job.bitfile = bitfile;
+    jobs.push_back(job);
+  }
+
+  int Run(std::atomic<bool>& stop) {
+    ProgrammingJobCallbacks callbacks;
+    callbacks.started = [this](size_t job) {
+      callbackThreads.insert(std::this_thread::get_id());
+      events.push_back("start " + std::to_string(job));
+    };
+    callbacks.progress = [this](size_t job, const std::string& progress) {
+      callbackThreads.insert(std::this_thread::get_id());
+      progresses[job].push_back(progress);
+      if (stopAtProgress) *stopAtProgress = true;
+    };
+    callbacks.finished = [this](size_t job, int) {
+      callbackThreads.insert(std::this_thread::get_id());
+      events.push_back("finish " + std::to_string(job));
+    };
+    return RunProgrammingJobs(
+        jobs, stop,
+        [this](size_t job, std::atomic<bool>& stop,
+               std::function<void(std::string)> progress) {
+          OpenocdAdapter adapter{openocd};
+          ProgrammerTool programmer{&adapter};
+          return programmer.program_fpga(jobs[job].device, jobs[job].bitfile,
+                                         stop, nullptr, nullptr, progress);
+        },
+        callbacks);
+  }
+
+  size_t EventIndex(const std::string& event) const {
+    return std::find(events.begin(), events.end(), event) - events.begin();
+  }
+
+  const std::string openocd =
+      std::filesystem::absolute("standin_openocd").string();
+  const std::string bitfile = "standin_bitfile.bit";
+  std::vector<ProgrammingJob> jobs;
+  std::vector<std::string> events;
+  std::map<size_t, std::vector<std::string>> progresses;
+  std::set<std::thread::id> callbackThreads;
+  std::atomic<bool>* stopAtProgress = nullptr;
+};
+
+TEST_F(ProgrammingJobsTest, CablesRunConcurrently) {
+  AddJob("cable_a", 1);
+  AddJob("cable_a", 2);
+  AddJob("cable_b", 1);
+  std::atomic<bool> stop{false};
+  EXPECT_EQ(Run(stop), ProgrammerErrorCode::NoError);
+  std::vector<std::string> expected{"25.00", "50.00", "75.00", "100.00"};
+  for (size_t i = 0; i < jobs.size(); i++) {
+    EXPECT_EQ(jobs[i].status, ProgrammerErrorCode::NoError);
+    EXPECT_EQ(progresses[i], expected);
+  }
+  ASSERT_EQ(events.size(), 6);
+  // the devices of one cable share the chain, the cables do not wait
+  EXPECT_LT(EventIndex("finish 0"), EventIndex("start 1"));
+  EXPECT_LT(EventIndex("start 2"), EventIndex("finish 0"));
+  EXPECT_EQ(callbackThreads,
+            std::set<std::thread::id>{std::this_thread::get_id()});
+}
+
+TEST_F(ProgrammingJobsTest, StopSkipsPendingJobs) {
+  AddJob("cable_a", 1);
+  AddJob("cable_a", 2);
+  std::atomic<bool> stop{false};
+  stopAtProgress = &stop;
+  EXPECT_NE(Run(stop), ProgrammerErrorCode::NoError);
+  EXPECT_EQ(jobs[1].status, ProgrammerErrorCode::GeneralCmdError);
+  EXPECT_EQ(EventIndex("start 1"), events.size());
+  EXPECT_TRUE(progresses[1].empty());
+
+  events.clear();
+  EXPECT_EQ(Run(stop), ProgrammerErrorCode::GeneralCmdError);
+  EXPECT_TRUE(events.empty());
+}
+
 #endif // __linux__
 
 TEST(ProgrammerHelper, printCableListTest)
@@ -524,6 +648,7 @@ TEST_F(ProgrammerToolTest, QueryFpgaStatusSuccess) {
   EXPECT_EQ(cfgStatus.cfgDone, true);
   EXPECT_EQ(cfgStatus.cfgError, false);
 }
+
 // Mocking the JtagAdapter class for testing HardwareManager
 class MockJtagAdapter : public JtagAdapter {
  public:
@@ -548,6 +673,13 @@ TEST_F(HardwareManagerTest, GetCablesTest) {
   EXPECT_EQ(cables.size(), 0);
 }
 
+TEST_F(HardwareManagerTest, GetCablesSharedAcrossInstancesTest) {
+  std::vector<Cable> cables = hardwareManager.get_cables();
+  HardwareManager other(&mockAdapter);
+  EXPECT_EQ(other.get_cables().size(), cables.size());
+  EXPECT_EQ(hardwareManager.get_cables().size(), cables.size());
+}
+
 TEST_F(HardwareManagerTest, IsCableExistsTest) {
   Cable cable;
   bool exists = hardwareManager.is_cable_exists(1);
@@ -19,11 +19,15 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "Command/CommandStack.h"
+#include "Command/Logger.h"
 #include "Tcl/TclInterpreter.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -42,5 +46,65 @@ TEST(Command, TestPush) {
   EXPECT_EQ(ok, true);
 }
 
+static std::string readFile(const std::string& path) {
+  std::ifstream file{path};
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+TEST(Command, LoggerFlush) {
+  const std::string path{"logger_flush_test.log"};
+  Logger logger{path};
+  logger.log("first");
+  logger << "second";
+  logger.appendLog(" line\n");
+  logger.flush();
+  EXPECT_EQ(readFile(path), "first\nsecond line\n");
+  logger.close();
+  std::remove(path.c_str());
+}
+
+TEST(Command, LoggerClose) {
+  const std::string path{"logger_close_test.log"};
+  std::string expected;
+  {
+    Logger logger{path};
+    for (int i = 0; i < 10000; i++) {
+      const std::string line = "line " + std::to_string(i);
+      logger.log(line);
+      expected += line + "\n";
+    }
+  }
+  EXPECT_EQ(readFile(path), expected);
+
+  Logger logger{path};
+  logger.close();
+  logger.log("dropped");
+  logger.open();
+  logger.log("appended");
+  logger.close();
+  EXPECT_EQ(readFile(path), "appended\n");
+  std::remove(path.c_str());
+}
+
+TEST(Command, LoggerFlushOnCrash) {
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  const std::string path{"logger_crash_test.log"};
+  EXPECT_DEATH(
+      {
+        Logger logger{path};
+        for (int i = 0; i < 10000; i++) logger.log("line " + std::to_string(i));
+        std::abort();
+      },
+      "");
+  // The text the background thread was writing may be there twice
+  const std::string content = readFile(path);
+  const std::string last{"line 9999\n"};
+  ASSERT_GE(content.size(), last.size());
+  EXPECT_EQ(content.substr(content.size() - last.size()), last);
+  std::remove(path.c_str());
+}
+
 }  // namespace
 }  // namespace FOEDAG
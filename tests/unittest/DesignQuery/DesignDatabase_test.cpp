@@ -0,0 +1,182 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DesignQuery/DesignDatabase.h"
+
+#include "Utils/FileUtils.h"
+#include "Utils/JsonCache.h"
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+namespace fs = std::filesystem;
+
+static const char* HierInfoJson = R"({
+  "fileIDs": {"1": "top.v"},
+  "hierTree": [
+    {
+      "file": "1", "language": "SystemVerilog", "line": 1,
+      "topModule": "top",
+      "ports": [
+        {"direction": "Input", "name": "clk",
+         "range": {"lsb": 0, "msb": 0}, "type": "LOGIC"},
+        {"direction": "Input", "name": "din",
+         "range": {"lsb": 0, "msb": 7}, "type": "LOGIC"},
+        {"direction": "Output", "name": "dout",
+         "range": {"lsb": 0, "msb": 3}, "type": "LOGIC"},
+        {"direction": "Inout", "name": "io",
+         "range": {"lsb": 0, "msb": 0}, "type": "LOGIC"}
+      ],
+      "moduleInsts": [
+        {"file": "1", "instName": "u1", "line": 5, "module": "sub",
+         "parameters": []}
+      ]
+    }
+  ],
+  "modules": {
+    "sub": {"file": "1", "language": "SystemVerilog", "line": 10,
+            "module": "sub",
+            "moduleInsts": [
+              {"file": "1", "instName": "leaf", "line": 12,
+               "module": "cell", "parameters": []}
+            ]},
+    "cell": {"file": "1", "language": "SystemVerilog", "line": 20,
+             "module": "cell"}
+  }
+})";
+
+TEST(DesignDatabase, LoadHierInfoIndices) {
+  fs::path file{"design_database_hier_info.json"};
+  FileUtils::WriteToFile(file, HierInfoJson);
+  DesignDatabase database;
+  auto [ok, message] = database.LoadHierInfo(file);
+  ASSERT_TRUE(ok) << message;
+
+  const int both{DesignDatabase::Input | DesignDatabase::Output};
+  EXPECT_EQ(database.Ports(both),
+            (std::vector<std::string>{"clk", "din", "dout"}));
+  EXPECT_EQ(database.Ports(DesignDatabase::Output),
+            (std::vector<std::string>{"dout"}));
+  EXPECT_EQ(database.Buses(both).size(), 2);
+
+  EXPECT_TRUE(database.HasPort("clk", both));
+  EXPECT_FALSE(database.HasPort("io", both));
+  EXPECT_FALSE(database.HasPort("clk", DesignDatabase::Output));
+  EXPECT_TRUE(database.HasBusBit("din", 7, both));
+  EXPECT_FALSE(database.HasBusBit("din", 8, both));
+  EXPECT_FALSE(database.HasBusBit("clk", 0, both));
+
+  ASSERT_NE(database.Module("top"), nullptr);
+  EXPECT_TRUE(database.Module("top")->top);
+  EXPECT_EQ(database.Module("sub")->line, 10);
+  ASSERT_TRUE(database.Instance("top.u1.leaf"));
+  EXPECT_EQ(database.Instance("top.u1.leaf")->module, "cell");
+  EXPECT_EQ(database.Instance("top.u1.leaf")->parent, "top.u1");
+  EXPECT_EQ(database.Instance("top.u1")->module, "sub");
+  EXPECT_EQ(database.Instance("top.u1")->parent, "top");
+  EXPECT_FALSE(database.Instance("top"));
+  EXPECT_FALSE(database.Instance("top.u2"));
+  EXPECT_FALSE(database.Instance("sub.leaf"));
+  EXPECT_EQ(database.InstanceCount(), 2);
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(DesignDatabase, DottedInstanceNames) {
+  fs::path file{"design_database_dotted.json"};
+  FileUtils::WriteToFile(file, R"({
+  "hierTree": [
+    {"file": "1", "line": 1, "topModule": "top", "ports": [],
+     "moduleInsts": [
+       {"file": "1", "instName": "gen[0].u", "line": 2, "module": "sub"},
+       {"file": "1", "instName": "gen[1].u", "line": 3, "module": "sub"}
+     ]}
+  ],
+  "modules": {
+    "sub": {"file": "1", "line": 10, "module": "sub",
+            "moduleInsts": [
+              {"file": "1", "instName": "c", "line": 11, "module": "cell"}
+            ]}
+  }
+})");
+  DesignDatabase database;
+  ASSERT_TRUE(database.LoadHierInfo(file).first);
+  ASSERT_TRUE(database.Instance("top.gen[1].u"));
+  EXPECT_EQ(database.Instance("top.gen[1].u")->line, 3);
+  ASSERT_TRUE(database.Instance("top.gen[0].u.c"));
+  EXPECT_EQ(database.Instance("top.gen[0].u.c")->parent, "top.gen[0].u");
+  EXPECT_FALSE(database.Instance("top.gen[2].u"));
+  EXPECT_EQ(database.InstanceCount(), 4);
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(DesignDatabase, ReloadOnFileChange) {
+  fs::path file{"design_database_reload.json"};
+  FileUtils::WriteToFile(file, HierInfoJson);
+  DesignDatabase database;
+  ASSERT_TRUE(database.LoadHierInfo(file).first);
+  EXPECT_NE(database.Port("clk"), nullptr);
+
+  FileUtils::WriteToFile(file, R"({"hierTree": []})");
+  ASSERT_TRUE(database.LoadHierInfo(file).first);
+  EXPECT_EQ(database.Port("clk"), nullptr);
+  EXPECT_TRUE(database.Modules().empty());
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(DesignDatabase, MissingAndCorruptedFile) {
+  DesignDatabase database;
+  EXPECT_FALSE(database.LoadHierInfo("design_database_missing.json").first);
+
+  fs::path file{"design_database_corrupted.json"};
+  FileUtils::WriteToFile(file, "{ \"hierTree\": [");
+  EXPECT_FALSE(database.LoadHierInfo(file).first);
+  EXPECT_FALSE(database.HierInfoLoaded());
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(DesignDatabase, CyclicHierarchy) {
+  fs::path file{"design_database_cyclic.json"};
+  FileUtils::WriteToFile(file, R"({
+  "hierTree": [
+    {"file": "1", "line": 1, "topModule": "top", "ports": [],
+     "moduleInsts": [
+       {"file": "1", "instName": "u", "line": 2, "module": "sub"}
+     ]}
+  ],
+  "modules": {
+    "sub": {"file": "1", "line": 10, "module": "sub",
+            "moduleInsts": [
+              {"file": "1", "instName": "self", "line": 11, "module": "sub"}
+            ]}
+  }
+})");
+  DesignDatabase database;
+  auto [ok, message] = database.LoadHierInfo(file);
+  EXPECT_FALSE(ok);
+  EXPECT_EQ(message, "Cyclic hierarchy, module sub instantiates sub");
+  EXPECT_FALSE(database.HierInfoLoaded());
+  EXPECT_EQ(database.Module("sub"), nullptr);
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
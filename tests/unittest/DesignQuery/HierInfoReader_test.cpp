@@ -0,0 +1,71 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DesignQuery/HierInfoReader.h"
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+TEST(HierInfoReader, ReadIndexedFields) {
+  std::istringstream stream{R"({
+    "fileIDs": {"1": "top.v", "2": "sub.v"},
+    "hierTree": [
+      {"file": "1", "line": 1, "topModule": "top",
+       "ports": [{"direction": "Input", "name": "din",
+                  "range": {"lsb": 0, "msb": 7}, "type": "LOGIC"}],
+       "moduleInsts": [{"file": "1", "instName": "u1", "line": 5,
+                        "module": "sub", "parameters": [{"a": [1, 2]}]}]}
+    ],
+    "modules": {"sub": {"file": "2", "line": 3, "module": "sub"}}
+  })"};
+  HierInfo info;
+  auto [ok, message] = HierInfoReader::Read(stream, info);
+  ASSERT_TRUE(ok) << message;
+  ASSERT_EQ(info.fileIDs.size(), 2);
+  EXPECT_EQ(info.fileIDs[1].first, "2");
+  EXPECT_EQ(info.fileIDs[1].second, "sub.v");
+  ASSERT_EQ(info.hierTree.size(), 1);
+  const auto& top = info.hierTree.front();
+  EXPECT_EQ(top.name, "top");
+  ASSERT_EQ(top.ports.size(), 1);
+  EXPECT_EQ(top.ports.front().msb, 7);
+  ASSERT_EQ(top.moduleInsts.size(), 1);
+  EXPECT_EQ(top.moduleInsts.front().instName, "u1");
+  EXPECT_EQ(top.moduleInsts.front().line, 5);
+  ASSERT_EQ(info.modules.count("sub"), 1);
+  EXPECT_EQ(info.modules.at("sub").file, "2");
+}
+
+TEST(HierInfoReader, ReadErrors) {
+  HierInfo info;
+  std::istringstream corrupted{R"({"hierTree": [{"file": "1",,}]})"};
+  EXPECT_FALSE(HierInfoReader::Read(corrupted, info).first);
+  EXPECT_TRUE(info.hierTree.empty());
+
+  std::istringstream noTree{R"({"fileIDs": {}})"};
+  EXPECT_FALSE(HierInfoReader::Read(noTree, info).first);
+
+  EXPECT_FALSE(
+      HierInfoReader::Read("hier_info_reader_missing.json", info).first);
+}
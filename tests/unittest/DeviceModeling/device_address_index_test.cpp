@@ -0,0 +1,207 @@
+#include "DeviceModeling/device_address_index.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "DeviceModeling/Model.h"
+
+namespace {
+
+template <typename Cmd>
+auto run(Cmd cmd, std::vector<const char *> argv) {
+  return (Model::get_modler().*cmd)(static_cast<int>(argv.size()),
+                                    argv.data());
+}
+
+void build_address_device() {
+  auto &m = Model::get_modler();
+  run(&device_modeler::device_name, {"device_name", "ADDRESS_DEVICE"});
+  run(&device_modeler::define_block, {"define_block", "-name", "LEAF"});
+  std::vector<const char *> en = {"define_attr", "-block", "LEAF", "-name",
+                                  "EN",          "-addr",  "0",    "-width",
+                                  "1"};
+  m.define_attr(static_cast<int>(en.size()), en.data());
+  std::vector<const char *> mode = {"define_attr", "-block", "LEAF", "-name",
+                                    "MODE",        "-addr",  "4",    "-width",
+                                    "2"};
+  m.define_attr(static_cast<int>(mode.size()), mode.data());
+  run(&device_modeler::define_block, {"define_block", "-name", "TILE"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "LEAF", "-parent", "TILE", "-name",
+       "leaf0", "-logic_address", "16"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "LEAF", "-parent", "TILE", "-name",
+       "leaf1", "-logic_address", "32"});
+  run(&device_modeler::define_block, {"define_block", "-name", "WRAP"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "LEAF", "-parent", "WRAP", "-name",
+       "inner"});
+  run(&device_modeler::define_block, {"define_block", "-name", "GROUP"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "WRAP", "-parent", "GROUP", "-name",
+       "wrap", "-logic_address", "8"});
+  run(&device_modeler::define_block, {"define_block", "-name", "ANALOG"});
+  std::vector<const char *> trim = {"define_attr", "-block", "ANALOG",
+                                    "-name",       "TRIM",   "-addr",
+                                    "0",           "-width", "4"};
+  m.define_attr(static_cast<int>(trim.size()), trim.data());
+  run(&device_modeler::define_properties,
+      {"define_properties", "-block", "ANALOG", "-no_configuration", "1"});
+  // The model block, named after the device like for model_config set_model
+  run(&device_modeler::define_block,
+      {"define_block", "-name", "ADDRESS_DEVICE"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "TILE", "-parent", "ADDRESS_DEVICE",
+       "-name", "tile0", "-logic_address", "0x100"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "TILE", "-parent", "ADDRESS_DEVICE",
+       "-name", "tile1", "-logic_address", "0x200"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "ANALOG", "-parent", "ADDRESS_DEVICE",
+       "-name", "analog0", "-logic_address", "0x300"});
+  // Instances outside the model are not indexed
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "TILE", "-name", "outside",
+       "-logic_address", "0x400"});
+}
+
+void undefine_address_device() {
+  const char *argv[] = {"undefine_device", "ADDRESS_DEVICE"};
+  Model::get_modler().undefine_device(2, argv);
+  Model::get_modler().reset_current_device();
+}
+
+}  // namespace
+
+// Attributes are laid out like ModelConfig and decoded back to the bit
+TEST(DeviceAddressIndexTest, LogicAddresses) {
+  build_address_device();
+  auto dev = Model::get_modler().get_current_device();
+  EXPECT_THROW((device_address_index{*dev, "MISSING"}), std::runtime_error);
+  device_address_index index{*dev, "ADDRESS_DEVICE"};
+  EXPECT_EQ(index.entries().size(), 8);
+  EXPECT_EQ(index.find_attribute("analog0", "TRIM"), nullptr);
+  EXPECT_EQ(index.find_attribute("outside.leaf0", "EN"), nullptr);
+
+  auto mode = index.find_attribute("tile0.leaf0", "MODE");
+  ASSERT_NE(mode, nullptr);
+  EXPECT_EQ(mode->logic_address, 0x100 + 16 + 4);
+  EXPECT_EQ(mode->size, 2);
+  EXPECT_EQ(mode->block->block_name(), "LEAF");
+
+  uint32_t bit = 0;
+  EXPECT_EQ(index.find_logic(0x100 + 16 + 5, &bit), mode);
+  EXPECT_EQ(bit, 1);
+  EXPECT_EQ(index.find_logic(0x200 + 32, &bit),
+            index.find_attribute("tile1.leaf1", "EN"));
+  EXPECT_EQ(bit, 0);
+  EXPECT_EQ(index.find_logic(0x100 + 16 + 1), nullptr);
+  EXPECT_EQ(index.find_logic(0x100 + 16 + 6), nullptr);
+  EXPECT_EQ(index.find_logic(0x300), nullptr);
+  EXPECT_EQ(index.find_logic(0), nullptr);
+
+  EXPECT_EQ(run(&device_modeler::decode_address,
+                {"decode_address", "-address", "0x115"}),
+            (std::vector<std::string>{"tile0.leaf0", "LEAF", "MODE", "1"}));
+  EXPECT_EQ(run(&device_modeler::get_attribute_address,
+                {"get_attribute_address", "-inst", "tile1.leaf0", "-attr",
+                 "MODE", "-bit", "1"}),
+            0x200 + 16 + 5);
+  EXPECT_THROW(run(&device_modeler::get_attribute_address,
+                   {"get_attribute_address", "-inst", "tile1.leaf0", "-attr",
+                    "MODE", "-bit", "2"}),
+               std::runtime_error);
+  EXPECT_THROW(run(&device_modeler::decode_address,
+                   {"decode_address", "-address", "3"}),
+               std::runtime_error);
+
+  // Another model of the same device
+  EXPECT_EQ(run(&device_modeler::get_attribute_address,
+                {"get_attribute_address", "-model", "TILE", "-inst",
+                 "leaf1", "-attr", "EN"}),
+            32);
+  // Without a logic address the instance lands at its parent offset minus one
+  EXPECT_EQ(run(&device_modeler::get_attribute_address,
+                {"get_attribute_address", "-model", "GROUP", "-inst",
+                 "wrap.inner", "-attr", "MODE"}),
+            8 - 1 + 4);
+
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "TILE", "-parent", "ADDRESS_DEVICE",
+       "-name", "tile2", "-logic_address", "0x500"});
+  EXPECT_EQ(run(&device_modeler::get_attribute_address,
+                {"get_attribute_address", "-inst", "tile2.leaf1", "-attr",
+                 "EN"}),
+            0x500 + 32);
+  undefine_address_device();
+}
+
+// Physical addresses relocate subtrees
+TEST(DeviceAddressIndexTest, PhysicalAddresses) {
+  build_address_device();
+  auto dev = Model::get_modler().get_current_device();
+  auto model = dev->get_block("ADDRESS_DEVICE");
+  {
+    device_address_index index{*dev, "ADDRESS_DEVICE"};
+    EXPECT_EQ(index.find_attribute("tile1.leaf1", "MODE")->phy_address, -1);
+  }
+  model->get_instance("tile1")->set_phy_address(0x1000);
+  std::string leaf1{"leaf1"};
+  model->get_instance("tile0")->findInstanceByName(leaf1)->set_phy_address(
+      0x50);
+  device_address_index index{*dev, "ADDRESS_DEVICE"};
+  EXPECT_EQ(index.find_attribute("tile1.leaf1", "MODE")->phy_address,
+            0x1000 + 32 + 4);
+  uint32_t bit = 0;
+  EXPECT_EQ(index.find_phy(0x55, &bit),
+            index.find_attribute("tile0.leaf1", "MODE"));
+  EXPECT_EQ(bit, 1);
+  EXPECT_EQ(index.find_phy(0x115), nullptr);
+  undefine_address_device();
+}
+
+// Overlapping attributes are found in logarithmic time, the one starting last
+// owns the overlap
+TEST(DeviceAddressIndexTest, OverlappingAttributes) {
+  auto &m = Model::get_modler();
+  run(&device_modeler::device_name, {"device_name", "OVERLAP"});
+  run(&device_modeler::define_block, {"define_block", "-name", "WIDE"});
+  std::vector<const char *> wide = {"define_attr", "-block", "WIDE", "-name",
+                                    "W",           "-addr",  "0",    "-width",
+                                    "32"};
+  m.define_attr(static_cast<int>(wide.size()), wide.data());
+  run(&device_modeler::define_block, {"define_block", "-name", "NARROW"});
+  std::vector<const char *> narrow = {"define_attr", "-block", "NARROW",
+                                      "-name",       "N",      "-addr",
+                                      "0",           "-width", "2"};
+  m.define_attr(static_cast<int>(narrow.size()), narrow.data());
+  run(&device_modeler::define_block, {"define_block", "-name", "OVERLAP"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "WIDE", "-parent", "OVERLAP", "-name",
+       "wide", "-logic_address", "0"});
+  std::vector<std::string> names, addresses;
+  for (int i = 0; i < 10; i++) {
+    names.push_back("narrow" + std::to_string(i));
+    addresses.push_back(std::to_string(3 * i + 1));
+  }
+  for (int i = 0; i < 10; i++) {
+    run(&device_modeler::create_instance,
+        {"create_instance", "-block", "NARROW", "-parent", "OVERLAP", "-name",
+         names[i].c_str(), "-logic_address", addresses[i].c_str()});
+  }
+
+  device_address_index index{*m.get_current_device(), "OVERLAP"};
+  uint32_t bit = 0;
+  EXPECT_EQ(index.find_logic(17, &bit), index.find_attribute("narrow5", "N"));
+  EXPECT_EQ(bit, 1);
+  EXPECT_EQ(index.find_logic(18, &bit), index.find_attribute("wide", "W"));
+  EXPECT_EQ(bit, 18);
+  EXPECT_EQ(index.find_logic(31, &bit), index.find_attribute("wide", "W"));
+  EXPECT_EQ(index.find_logic(32), nullptr);
+
+  const char *argv[] = {"undefine_device", "OVERLAP"};
+  m.undefine_device(2, argv);
+  m.reset_current_device();
+}
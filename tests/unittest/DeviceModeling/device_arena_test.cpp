@@ -0,0 +1,88 @@
+#include "DeviceModeling/device_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Interned names share storage and compare by identity
+TEST(DeviceArenaTest, InternedNamesShareStorage) {
+  device_name a{std::string{"arena_test_name"}};
+  device_name b{"arena_test_name"};
+  device_name c{"arena_test_other"};
+  EXPECT_EQ(&a.str(), &b.str());
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a != c);
+  EXPECT_TRUE(a == "arena_test_name");
+  EXPECT_TRUE(a == std::string{"arena_test_name"});
+  EXPECT_EQ(a + "_suffix", "arena_test_name_suffix");
+  EXPECT_EQ(device_name_hash{}(a), device_name_hash{}(b));
+}
+
+// Name keyed maps accept plain strings for lookup and insertion
+TEST(DeviceArenaTest, DeviceMapLookup) {
+  device_map<int> map;
+  map["p0"] = 1;
+  map[std::string{"p1"}] = 2;
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(map.at("p0"), 1);
+  EXPECT_NE(map.find(std::string{"p1"}), map.end());
+  EXPECT_EQ(map.find("p2"), map.end());
+  for (const auto &pr : map) {
+    const std::string &name = pr.first;
+    EXPECT_FALSE(name.empty());
+  }
+}
+
+// Looking up a missing name does not add it to the pool
+TEST(DeviceArenaTest, DeviceMapLookupDoesNotIntern) {
+  device_map<int> map;
+  map["arena_lookup_present"] = 1;
+  const std::size_t pooled = device_string_pool::size();
+  EXPECT_EQ(map.find("arena_lookup_absent_0"), map.end());
+  EXPECT_EQ(map.count(std::string{"arena_lookup_absent_1"}), 0);
+  EXPECT_EQ(map.erase("arena_lookup_absent_2"), 0);
+  EXPECT_THROW(map.at("arena_lookup_absent_3"), std::out_of_range);
+  EXPECT_EQ(map.count("arena_lookup_present"), 1);
+  EXPECT_EQ(map["arena_lookup_present"], 1);
+  EXPECT_EQ(device_string_pool::size(), pooled);
+}
+
+// Iteration order only depends on the names, not on where they were interned
+TEST(DeviceArenaTest, DeviceMapOrderIsStable) {
+  EXPECT_EQ(device_name_hash{}(device_name{"arena_order_0"}),
+            std::hash<std::string>{}("arena_order_0"));
+
+  device_map<int> map;
+  std::unordered_map<std::string, int> reference;
+  for (int i = 0; i < 64; i++) {
+    std::string name = "arena_order_" + std::to_string(i);
+    map[name] = i;
+    reference[name] = i;
+  }
+  std::vector<int> listed;
+  for (const auto &pr : map) listed.push_back(pr.second);
+  std::vector<int> expected;
+  for (const auto &pr : reference) expected.push_back(pr.second);
+  EXPECT_EQ(listed, expected);
+
+  device_map<int> copy;
+  for (int i = 0; i < 64; i++) copy["arena_order_" + std::to_string(i)] = i;
+  std::vector<int> relisted;
+  for (const auto &pr : copy) relisted.push_back(pr.second);
+  EXPECT_EQ(relisted, listed);
+}
+
+// Freed nodes are recycled before new chunks are reserved
+TEST(DeviceArenaTest, AllocationsAreRecycled) {
+  void *first = device_arena::allocate(40);
+  device_arena::deallocate(first, 40);
+  void *second = device_arena::allocate(33);
+  EXPECT_EQ(first, second);
+  device_arena::deallocate(second, 33);
+
+  auto ptr = make_device_shared<std::string>("arena");
+  EXPECT_EQ(*ptr, "arena");
+}
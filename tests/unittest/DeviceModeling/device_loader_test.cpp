@@ -0,0 +1,109 @@
+#include "DeviceModeling/device_loader.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "DeviceModeling/Model.h"
+
+namespace {
+
+void undefine(const char *name) {
+  const char *argv[] = {"undefine_device", name};
+  Model::get_modler().undefine_device(2, argv);
+  Model::get_modler().reset_current_device();
+}
+
+}  // namespace
+
+// Declarative commands run natively, braces and continuations follow Tcl
+TEST(DeviceLoaderTest, LoadsDeclarativeCommands) {
+  const char *text = R"(# leaf description
+device_name LOADER_DEVICE
+define_block -name LEAF; define_ports -block LEAF -in a b -out y
+define_attr -block LEAF -name MODE -addr 4 -width 2 \
+    -enum {OFF 0,ON 1} -default ON
+define_constraint -block LEAF -name c0 -constraint {MODE != {3}}
+define_block -name "TILE"
+create_instance -block LEAF -parent TILE -name leaf0 -logic_location {1 2 3}
+)";
+  device_loader loader{Model::get_modler()};
+  loader.load(text);
+  EXPECT_EQ(loader.get_stats().native, 7);
+  EXPECT_EQ(loader.get_stats().fallback, 0);
+
+  auto dev = Model::get_modler().get_device_model("LOADER_DEVICE");
+  ASSERT_NE(dev, nullptr);
+  auto leaf = dev->get_block("LEAF");
+  ASSERT_NE(leaf, nullptr);
+  EXPECT_EQ(leaf->ports().size(), 3);
+  EXPECT_EQ(leaf->get_attribute("MODE")->get_address(), 4);
+  EXPECT_EQ(leaf->get_attribute("MODE")->get_type()->get_default_value(), 1);
+  EXPECT_EQ(leaf->get_constraint("c0")->get_expression_string(),
+            "MODE != {3}");
+  ASSERT_NE(dev->get_block("TILE"), nullptr);
+  EXPECT_EQ(dev->get_block("TILE")->get_instance("leaf0")
+                ->get_logic_location_z(), 3);
+  undefine("LOADER_DEVICE");
+}
+
+// Substitutions, control flow and unknown commands go to the fallback in order
+TEST(DeviceLoaderTest, UsesFallbackForTclConstructs) {
+  const char *text = R"(device_name LOADER_FALLBACK
+set blk LEAF
+define_block -name $blk
+foreach i {0 1} {
+  puts $i
+}
+define_block -name [string toupper tile]
+define_block -name PLAIN
+)";
+  std::vector<std::string> commands;
+  device_loader loader{Model::get_modler(),
+                       [&commands](const std::string &command, std::string &) {
+                         commands.push_back(command);
+                         return true;
+                       }};
+  loader.load(text);
+  EXPECT_EQ(loader.get_stats().native, 2);
+  EXPECT_EQ(loader.get_stats().fallback, 4);
+  ASSERT_EQ(commands.size(), 4);
+  EXPECT_EQ(commands[0], "set blk LEAF");
+  EXPECT_EQ(commands[1], "define_block -name $blk");
+  EXPECT_EQ(commands[2], "foreach i {0 1} {\n  puts $i\n}");
+  EXPECT_EQ(commands[3], "define_block -name [string toupper tile]");
+  auto dev = Model::get_modler().get_device_model("LOADER_FALLBACK");
+  ASSERT_NE(dev, nullptr);
+  EXPECT_NE(dev->get_block("PLAIN"), nullptr);
+  undefine("LOADER_FALLBACK");
+}
+
+// Errors carry the source and the line of the failing command
+TEST(DeviceLoaderTest, ReportsErrorLine) {
+  device_loader loader{Model::get_modler()};
+  try {
+    loader.load("device_name LOADER_ERROR\n\nset x 1\n", "dev.tcl");
+    FAIL() << "Expected an exception";
+  } catch (const std::runtime_error &e) {
+    EXPECT_EQ(std::string{e.what()},
+              "dev.tcl:3: Command \"set\" needs the Tcl interpreter");
+  }
+  EXPECT_THROW(loader.load("define_block -name {LEAF\n", "dev.tcl"),
+               std::runtime_error);
+  device_loader failing{Model::get_modler(),
+                        [](const std::string &, std::string &error) {
+                          error = "invalid command name \"foo\"";
+                          return false;
+                        }};
+  try {
+    failing.load("device_name LOADER_ERROR\nfoo\n", "dev.tcl");
+    FAIL() << "Expected an exception";
+  } catch (const std::runtime_error &e) {
+    EXPECT_EQ(std::string{e.what()}, "dev.tcl:2: invalid command name \"foo\"");
+  }
+  EXPECT_THROW(device_loader{Model::get_modler()}.load_file(
+                   "device_loader_missing.tcl"),
+               std::runtime_error);
+  undefine("LOADER_ERROR");
+}
@@ -0,0 +1,238 @@
+#include "DeviceModeling/device_snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "DeviceModeling/Model.h"
+
+namespace {
+
+void run(bool (device_modeler::*cmd)(int, const char **),
+         std::vector<const char *> argv) {
+  (Model::get_modler().*cmd)(static_cast<int>(argv.size()), argv.data());
+}
+
+std::shared_ptr<device> build_snapshot_device() {
+  auto &m = Model::get_modler();
+  run(&device_modeler::device_name, {"device_name", "SNAPSHOT_DEVICE"});
+  run(&device_modeler::device_version, {"device_version", "1.2"});
+  run(&device_modeler::schema_version, {"schema_version", "0.9"});
+  run(&device_modeler::define_block, {"define_block", "-name", "LEAF"});
+  run(&device_modeler::define_ports,
+      {"define_ports", "-block", "LEAF", "-in", "a", "b", "-out", "y"});
+  std::vector<const char *> attr = {
+      "define_attr", "-block", "LEAF",  "-name",    "MODE",
+      "-addr",       "4",      "-width", "2",       "-enum",
+      "OFF 0,ON 1,BYPASS 2",   "-default", "BYPASS"};
+  m.define_attr(static_cast<int>(attr.size()), attr.data());
+  run(&device_modeler::define_param_type,
+      {"define_param_type", "-block", "LEAF", "-name", "ratio_t",
+       "-base_type", "double", "-lower_bound", "0.0", "-upper_bound", "4.0",
+       "-default", "1.5"});
+  run(&device_modeler::define_param,
+      {"define_param", "-block", "LEAF", "-name", "RATIO", "-type",
+       "ratio_t"});
+  run(&device_modeler::define_param,
+      {"define_param", "-block", "LEAF", "-name", "DELAY", "-type", "int",
+       "-width", "6", "-addr", "8"});
+  run(&device_modeler::define_constraint,
+      {"define_constraint", "-block", "LEAF", "-name", "c0", "-constraint",
+       "MODE != 3"});
+  run(&device_modeler::define_block, {"define_block", "-name", "TILE"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "LEAF", "-parent", "TILE", "-name",
+       "leaf0", "-logic_location", "1 2 3"});
+  run(&device_modeler::define_net,
+      {"define_net", "-parent", "TILE", "-name", "n0"});
+  run(&device_modeler::define_net,
+      {"define_net", "-parent", "TILE", "-name", "n1", "-drive", "n0"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "TILE", "-name", "tile0", "-io_bank",
+       "HP_1", "-logic_address", "12"});
+  run(&device_modeler::create_instance,
+      {"create_instance", "-block", "TILE", "-name", "tile1"});
+  run(&device_modeler::set_phy_address,
+      {"set_phy_address", "-inst", "tile1", "-address", "7"});
+  run(&device_modeler::define_properties,
+      {"define_properties", "-block", "LEAF", "-cell_type", "lut"});
+  run(&device_modeler::map_model_user_names,
+      {"map_model_user_names", "-user_name", "USER_TILE", "-model_name",
+       "tile0"});
+  run(&device_modeler::map_rtl_user_names,
+      {"map_rtl_user_names", "-user_name", "clk0", "-rtl_name", "pll_clk"});
+  run(&device_modeler::define_chain, {"define_chain", "-name", "ICB"});
+  run(&device_modeler::add_block_to_chain_type,
+      {"add_block_to_chain_type", "-chain", "ICB", "-block", "TILE"});
+  run(&device_modeler::create_instance_chain,
+      {"create_instance_chain", "-chain", "ICB", "-block", "TILE"});
+  run(&device_modeler::append_instance_to_chain,
+      {"append_instance_to_chain", "-chain", "ICB", "-instance", "tile0"});
+  return m.get_current_device();
+}
+
+}  // namespace
+
+// A snapshot restores blocks, types, instances, mappings and chains
+TEST(DeviceSnapshotTest, RoundTrip) {
+  auto original = build_snapshot_device();
+  ASSERT_NE(original, nullptr);
+  const std::string file = "device_snapshot_round_trip.bin";
+  EXPECT_EQ(device_snapshot::save(*original, file), 0);
+
+  {
+    device_snapshot snapshot{file};
+    EXPECT_EQ(snapshot.device_name(), "SNAPSHOT_DEVICE");
+    EXPECT_EQ(snapshot.block_count(), original->blocks().size() + 1);
+    EXPECT_EQ(snapshot.instance_count(), 3);
+  }
+
+  auto dev = device_snapshot::load(file);
+  std::remove(file.c_str());
+  EXPECT_EQ(dev->device_name(), "SNAPSHOT_DEVICE");
+  EXPECT_EQ(dev->device_version(), "1.2");
+  EXPECT_EQ(dev->schema_version(), "0.9");
+  EXPECT_EQ(dev->blocks().size(), original->blocks().size());
+  EXPECT_NE(dev->get_block("MUX4X1"), nullptr);
+
+  auto leaf = dev->get_block("LEAF");
+  ASSERT_NE(leaf, nullptr);
+  EXPECT_EQ(leaf->ports().size(), 3);
+  EXPECT_TRUE(leaf->get_port("a")->is_input());
+  EXPECT_FALSE(leaf->get_port("y")->is_input());
+  EXPECT_NE(leaf->get_signal("y"), nullptr);
+  auto mode = leaf->get_attribute("MODE");
+  ASSERT_NE(mode, nullptr);
+  EXPECT_EQ(mode->get_address(), 4);
+  EXPECT_EQ(mode->get_size(), 2);
+  EXPECT_EQ(mode->get_type()->get_default_value(), 2);
+  EXPECT_EQ(mode->get_type()->get_enum_value("ON"), 1);
+  EXPECT_EQ(leaf->get_enum_type("MODE_ENUM"), mode->get_type());
+  auto ratio = leaf->get_double_parameter("RATIO");
+  ASSERT_NE(ratio, nullptr);
+  EXPECT_EQ(ratio->get_type(), leaf->get_double_parameter_type("ratio_t"));
+  EXPECT_DOUBLE_EQ(ratio->get_type()->get_upper_bound(), 4.0);
+  EXPECT_EQ(leaf->get_int_parameter("DELAY")->get_address(), 8);
+  EXPECT_EQ(leaf->get_int_parameter("DELAY")->get_size(), 6);
+  EXPECT_EQ(leaf->get_int_parameter("DELAY")->get_type(),
+            dev->get_int_parameter_type("int"));
+  EXPECT_EQ(leaf->get_constraint("c0")->get_expression_string(),
+            "MODE != 3");
+  EXPECT_EQ(leaf->getProperty("cell_type"), "lut");
+  EXPECT_TRUE(leaf->was_instanciated());
+
+  auto tile = dev->get_block("TILE");
+  ASSERT_NE(tile, nullptr);
+  ASSERT_EQ(tile->instance_vector().size(), 1);
+  auto leaf0 = tile->get_instance("leaf0");
+  ASSERT_NE(leaf0, nullptr);
+  EXPECT_EQ(leaf0->get_block(), leaf);
+  EXPECT_EQ(leaf0->get_logic_location_z(), 3);
+  EXPECT_EQ(tile->get_net("n1")->get_source(), tile->get_net("n0"));
+
+  ASSERT_EQ(dev->instance_vector().size(), 2);
+  auto tile0 = dev->get_instance("tile0");
+  ASSERT_NE(tile0, nullptr);
+  EXPECT_EQ(tile0->get_io_bank(), "HP_1");
+  EXPECT_EQ(tile0->get_logic_address(), 12);
+  std::string leaf_name{"leaf0"};
+  EXPECT_NE(tile0->findInstanceByName(leaf_name), nullptr);
+  EXPECT_EQ(dev->get_instance("tile1")->get_phy_address(), 7);
+  EXPECT_EQ(dev->getCustomerName("tile0"), "USER_TILE");
+  EXPECT_EQ(dev->getRtlNameFromUser("clk0"), "pll_clk");
+  ASSERT_TRUE(dev->blockChainExists("ICB"));
+  EXPECT_EQ(dev->getBlockChain("ICB").front(), tile);
+  EXPECT_EQ(tile->get_chain("ICB").size(), 0);
+  EXPECT_EQ(dev->get_chain("ICB"), std::vector<std::string>{"tile0"});
+
+  const char *argv[] = {"undefine_device", "SNAPSHOT_DEVICE"};
+  Model::get_modler().undefine_device(2, argv);
+  Model::get_modler().reset_current_device();
+}
+
+// Parameters are restored with their stored value, even when the type
+// rejects the zero value
+TEST(DeviceSnapshotTest, RoundTripBoundedParameters) {
+  device dev{"SNAPSHOT_BOUNDS"};
+  auto int_type = std::make_shared<ParameterType<int>>();
+  int_type->set_lower_bound(1);
+  int_type->set_upper_bound(8);
+  dev.add_int_parameter_type("count_t", int_type);
+  dev.add_int_parameter(
+      "COUNT", make_device_shared<Parameter<int>>("COUNT", 5, int_type));
+  auto double_type = std::make_shared<ParameterType<double>>();
+  double_type->set_lower_bound(1.0);
+  dev.add_double_parameter_type("scale_t", double_type);
+  dev.add_double_parameter(
+      "SCALE",
+      make_device_shared<Parameter<double>>("SCALE", 2.5, double_type));
+
+  const std::string file = "device_snapshot_bounds.bin";
+  device_snapshot::save(dev, file);
+  std::shared_ptr<device> restored;
+  EXPECT_NO_THROW(restored = device_snapshot::load(file));
+  std::remove(file.c_str());
+  ASSERT_NE(restored, nullptr);
+  ASSERT_NE(restored->get_int_parameter("COUNT"), nullptr);
+  EXPECT_EQ(restored->get_int_parameter("COUNT")->get_value(), 5);
+  EXPECT_EQ(restored->get_int_parameter("COUNT")->get_type()->get_lower_bound(),
+            1);
+  ASSERT_NE(restored->get_double_parameter("SCALE"), nullptr);
+  EXPECT_DOUBLE_EQ(restored->get_double_parameter("SCALE")->get_value(), 2.5);
+}
+
+// Links to nets outside the block and its instances are counted and reported
+TEST(DeviceSnapshotTest, ReportsDroppedNetLinks) {
+  device dev{"SNAPSHOT_LINKS"};
+  auto net = make_device_shared<device_net>("n0");
+  net->set_source(make_device_shared<device_net>("outside_source"));
+  net->add_sink(make_device_shared<device_net>("outside_sink"));
+  dev.add_net(net);
+
+  std::vector<std::string> warnings;
+  SpeedLog::setSink([&warnings](LogLevel level, const std::string &line) {
+    if (level == LOG_WARN) warnings.push_back(line);
+  });
+  const std::string file = "device_snapshot_links.bin";
+  const size_t dropped = device_snapshot::save(dev, file);
+  SpeedLog::flush();
+  SpeedLog::setSink(nullptr);
+  std::remove(file.c_str());
+  EXPECT_EQ(dropped, 2);
+  ASSERT_EQ(warnings.size(), 1);
+  EXPECT_NE(warnings[0].find("2 net links"), std::string::npos);
+}
+
+// Files that are not snapshots of the current format are rejected
+TEST(DeviceSnapshotTest, RejectsInvalidFiles) {
+  EXPECT_THROW(device_snapshot{"device_snapshot_missing.bin"},
+               std::runtime_error);
+
+  const std::string file = "device_snapshot_invalid.bin";
+  {
+    std::ofstream out{file, std::ios::binary};
+    out << std::string(512, 'x');
+  }
+  EXPECT_THROW(device_snapshot{file}, std::runtime_error);
+
+  device dev{"SNAPSHOT_VERSION"};
+  device_snapshot::save(dev, file);
+  {
+    std::fstream io{file, std::ios::binary | std::ios::in | std::ios::out};
+    io.seekp(8);
+    const uint32_t version = device_snapshot::format_version + 1;
+    io.write(reinterpret_cast<const char *>(&version), sizeof(version));
+  }
+  EXPECT_THROW(device_snapshot{file}, std::runtime_error);
+
+  device_snapshot::save(dev, file);
+  {
+    std::ofstream out{file, std::ios::binary | std::ios::app};
+    out << "trailing";
+  }
+  EXPECT_THROW(device_snapshot{file}, std::runtime_error);
+  std::remove(file.c_str());
+}
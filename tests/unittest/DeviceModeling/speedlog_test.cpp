@@ -0,0 +1,82 @@
+#include "DeviceModeling/speedlog.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct captured_log {
+  captured_log() {
+    SpeedLog::setSink([this](LogLevel level, const std::string &line) {
+      levels.push_back(level);
+      lines.push_back(line);
+    });
+  }
+  ~captured_log() {
+    SpeedLog::setSink(nullptr);
+    SpeedLog::setLogLevel(LOG_INFO);
+  }
+  std::vector<LogLevel> levels;
+  std::vector<std::string> lines;
+};
+
+struct logs_on_exit {
+  ~logs_on_exit() { SpeedLog::info("{} at exit", name); }
+  const char *name;
+};
+
+}  // namespace
+
+// Placeholders take the arguments in order, extra arguments are appended
+TEST(SpeedLogTest, FormatsArguments) {
+  captured_log log;
+  SpeedLog::info("{} of {} bits", 3, 8);
+  spdlog::warn("Attribute", "MODE", 2);
+  SPEEDLOG_ERROR("{}", std::string{"failed"});
+  SpeedLog::flush();
+  ASSERT_EQ(log.lines.size(), 3);
+  EXPECT_EQ(log.lines[0], "3 of 8 bits\n");
+  EXPECT_EQ(log.lines[1], "Attribute MODE 2\n");
+  EXPECT_EQ(log.lines[2], "failed\n");
+  EXPECT_EQ(log.levels[1], LOG_WARN);
+}
+
+// Disabled levels neither format nor evaluate the macro arguments
+TEST(SpeedLogTest, SkipsDisabledLevels) {
+  captured_log log;
+  SpeedLog::setLogLevel(LOG_ERROR);
+  int evaluated = 0;
+  auto expensive = [&evaluated] {
+    ++evaluated;
+    return std::string{"value"};
+  };
+  SPEEDLOG_INFO("{}", expensive());
+  SPEEDLOG_WARN("{}", expensive());
+  SpeedLog::warn("dropped");
+  SPEEDLOG_ERROR("{}", expensive());
+  SpeedLog::flush();
+  EXPECT_EQ(evaluated, 1);
+  EXPECT_EQ(log.lines, std::vector<std::string>{"value\n"});
+  EXPECT_FALSE(SpeedLog::should_log(LOG_WARN));
+  EXPECT_FALSE(SpeedLog::should_log(LOG_OFF));
+}
+
+// Statics destroyed at exit can log, whether they go before or after the
+// writer shuts down
+TEST(SpeedLogDeathTest, LogsFromStaticDestructors) {
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  EXPECT_EXIT(
+      {
+        static logs_on_exit after{"after"};
+        SpeedLog::setSink([](LogLevel, const std::string &line) {
+          std::cerr << line << std::flush;
+        });
+        static logs_on_exit before{"before"};
+        std::exit(0);
+      },
+      ::testing::ExitedWithCode(0), "before at exit\nafter at exit");
+}
@@ -0,0 +1,126 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MainWindow/MessagesModel.h"
+
+#include <QtTest/QAbstractItemModelTester>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+// Line 1 has a nested warning, it is shown when filtering by "warning"
+static ITaskReportManager::Messages messages() {
+  TaskMessage nested{2, MessageSeverity::WARNING_MESSAGE, "Warning: nested",
+                     {}};
+  TaskMessage info{1, MessageSeverity::INFO_MESSAGE, "Info: start", {}};
+  info.m_childMessages.insert(nested.m_lineNr, nested);
+  ITaskReportManager::Messages result;
+  result.insert(info.m_lineNr, info);
+  result.insert(5, {5, MessageSeverity::ERROR_MESSAGE, "Error: failed", {}});
+  result.insert(8, {8, MessageSeverity::WARNING_MESSAGE, "Warning: top", {}});
+  return result;
+}
+
+// The tester walks the whole tree and fetches every item on its own
+static constexpr auto Fatal =
+    QAbstractItemModelTester::FailureReportingMode::Fatal;
+
+TEST(MessagesModel, addTask) {
+  MessagesModel model{QVector<MessageItemParser *>{}};
+  QAbstractItemModelTester tester{&model, Fatal};
+  model.addTask("Synthesis", "synthesis.rpt", true, messages());
+  model.addTask("Placement", "placement.rpt", false, {});
+  ASSERT_EQ(model.rowCount(), 2);
+
+  const QModelIndex synth = model.index(0, 0);
+  EXPECT_EQ(synth.data().toString(), "Synthesis (synthesis.rpt)");
+  EXPECT_TRUE(synth.data(MessagesModel::HtmlRole).isValid());
+  EXPECT_TRUE(model.hasChildren(synth));
+  EXPECT_EQ(model.rowCount(synth), 3);
+
+  const QModelIndex place = model.index(1, 0);
+  EXPECT_EQ(place.data().toString(), "Placement (log file not found)");
+  EXPECT_FALSE(place.data(MessagesModel::HtmlRole).isValid());
+  EXPECT_FALSE(model.hasChildren(place));
+  EXPECT_FALSE(model.canFetchMore(place));
+}
+
+TEST(MessagesModel, fetchMore) {
+  MessagesModel model{QVector<MessageItemParser *>{}};
+  model.addTask("Synthesis", "synthesis.rpt", true, messages());
+  const QModelIndex task = model.index(0, 0);
+  // The messages are only read when the task is expanded
+  EXPECT_TRUE(model.hasChildren(task));
+  EXPECT_EQ(model.rowCount(task), 0);
+  EXPECT_TRUE(model.canFetchMore(task));
+
+  QAbstractItemModelTester tester{&model, Fatal};
+  EXPECT_FALSE(model.canFetchMore(task));
+  ASSERT_EQ(model.rowCount(task), 3);
+
+  const QModelIndex info = model.index(0, 0, task);
+  EXPECT_EQ(info.data().toString(), "Info: start");
+  EXPECT_EQ(info.data(MessagesModel::LineNumberRole).toInt(), 1);
+  EXPECT_EQ(info.data(MessagesModel::FilePathRole).toString(),
+            "synthesis.rpt");
+  EXPECT_EQ(model.parent(info), task);
+  EXPECT_EQ(model.index(2, 0, task).data().toString(), "Warning: top");
+
+  EXPECT_FALSE(model.canFetchMore(info));
+  ASSERT_EQ(model.rowCount(info), 1);
+  const QModelIndex nested = model.index(0, 0, info);
+  EXPECT_EQ(nested.data().toString(), "Warning: nested");
+  EXPECT_EQ(model.parent(nested), info);
+  EXPECT_FALSE(model.hasChildren(nested));
+}
+
+TEST(MessagesModel, setFilter) {
+  MessagesModel model{QVector<MessageItemParser *>{}};
+  QAbstractItemModelTester tester{&model, Fatal};
+  model.addTask("Synthesis", "synthesis.rpt", true, messages());
+
+  model.setFilter("warning");
+  EXPECT_EQ(model.filter(), "warning");
+  QModelIndex task = model.index(0, 0);
+  ASSERT_EQ(model.rowCount(task), 2);
+  const QModelIndex info = model.index(0, 0, task);
+  EXPECT_EQ(info.data().toString(), "Info: start");
+  EXPECT_EQ(model.index(1, 0, task).data().toString(), "Warning: top");
+  EXPECT_EQ(model.parent(model.index(1, 0, task)), task);
+  ASSERT_EQ(model.rowCount(info), 1);
+  EXPECT_EQ(model.parent(model.index(0, 0, info)), info);
+
+  model.setFilter("error");
+  task = model.index(0, 0);
+  ASSERT_EQ(model.rowCount(task), 1);
+  EXPECT_EQ(model.index(0, 0, task).data().toString(), "Error: failed");
+
+  // A task added while filtering is filtered as well
+  model.addTask("Routing", "routing.rpt", true, messages());
+  ASSERT_EQ(model.rowCount(), 2);
+  EXPECT_EQ(model.rowCount(model.index(1, 0)), 1);
+
+  model.setFilter({});
+  task = model.index(0, 0);
+  EXPECT_EQ(model.rowCount(task), 3);
+  EXPECT_EQ(model.index(1, 0, task).data().toString(), "Error: failed");
+}
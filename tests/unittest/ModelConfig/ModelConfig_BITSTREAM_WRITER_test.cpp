@@ -0,0 +1,160 @@
+/*
+Copyright 2023 The Foedag team
+
+GPL License
+
+Copyright (c) 2023 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Configuration/ModelConfig/ModelConfig_BITSTREAM_WRITER.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+#include "gtest/gtest.h"
+
+using namespace FOEDAG;
+
+namespace {
+
+struct FIELD {
+  uint32_t value;
+  uint32_t size;
+};
+
+std::vector<FIELD> random_fields(uint32_t total_bits, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<FIELD> fields;
+  uint32_t bits = 0;
+  while (bits < total_bits) {
+    uint32_t size = std::min<uint32_t>(1 + gen() % 32, total_bits - bits);
+    uint32_t value = gen();
+    if (size < 32) {
+      value &= (1u << size) - 1;
+    }
+    fields.push_back({value, size});
+    bits += size;
+  }
+  return fields;
+}
+
+// Bit at a time reference, the way the image used to be built
+std::string reference(const std::vector<FIELD>& fields, uint32_t total_bits,
+                      const std::string& format) {
+  std::vector<uint8_t> data(((total_bits + 31) / 32) * 4, 0);
+  uint32_t addr = 0;
+  for (auto& field : fields) {
+    for (uint32_t i = 0; i < field.size; i++, addr++) {
+      if (field.value & (1u << i)) {
+        data[addr >> 3] |= (1 << (addr & 7));
+      }
+    }
+  }
+  std::string result;
+  if (format == "BIT") {
+    for (uint32_t i = 0; i < total_bits; i++) {
+      result += (data[i >> 3] & (1 << (i & 7))) ? "1\n" : "0\n";
+    }
+  } else if (format == "WORD") {
+    uint32_t word_count = (total_bits + 31) / 32;
+    for (uint32_t i = 0; i < word_count; i++) {
+      uint32_t word = 0;
+      memcpy(&word, &data[i * 4], sizeof(word));
+      result += CFG_print("%08X", word);
+      if ((i + 1) == word_count && (total_bits % 32) != 0) {
+        result += CFG_print(" // (Valid LSBits: %d, Dummy MSBits: %d)\n",
+                            total_bits % 32, 32 - (total_bits % 32));
+      } else {
+        result += "\n";
+      }
+    }
+  } else {
+    result.assign((const char*)(data.data()), (total_bits + 7) / 8);
+  }
+  return result;
+}
+
+std::string write_image(const std::vector<FIELD>& fields, uint32_t total_bits,
+                        const std::string& format, const std::string& file) {
+  {
+    ModelConfig_BITSTREAM_WRITER writer(file, format, total_bits);
+    for (auto& field : fields) {
+      writer.append_bits(field.value, field.size);
+    }
+    writer.close();
+  }
+  std::ifstream in(file, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  in.close();
+  std::filesystem::remove(file);
+  return content;
+}
+
+}  // namespace
+
+TEST(ModelConfig_BITSTREAM_WRITER, matches_bit_packing) {
+  for (uint32_t total_bits : {1u, 31u, 32u, 63u, 64u, 65u, 1000u, 4133u}) {
+    auto fields = random_fields(total_bits, total_bits);
+    for (std::string format : {"BIT", "WORD", "BIN"}) {
+      EXPECT_EQ(write_image(fields, total_bits, format, "bitstream_writer.out"),
+                reference(fields, total_bits, format))
+          << format << " with " << total_bits << " bits";
+    }
+  }
+}
+
+TEST(ModelConfig_BITSTREAM_WRITER, text_and_size_checks) {
+  {
+    ModelConfig_BITSTREAM_WRITER writer("bitstream_writer.txt", "TCL", 8);
+    EXPECT_FALSE(writer.is_bitstream());
+    writer.write("// Format: TCL\n");
+    writer.close();
+  }
+  std::ifstream in("bitstream_writer.txt");
+  std::string line;
+  std::getline(in, line);
+  in.close();
+  EXPECT_EQ(line, "// Format: TCL");
+  std::filesystem::remove("bitstream_writer.txt");
+  EXPECT_THROW(
+      ModelConfig_BITSTREAM_WRITER("bitstream_writer.txt", "HEX", 8),
+      std::exception);
+  std::filesystem::remove("bitstream_writer.txt");
+}
+
+// Throughput of the word level writer against the bit at a time reference,
+// a benchmark, run it with --gtest_also_run_disabled_tests
+TEST(ModelConfig_BITSTREAM_WRITER, DISABLED_throughput) {
+  const uint32_t total_bits = 64 * 1024 * 1024;
+  auto fields = random_fields(total_bits, 1);
+  for (std::string format : {"BIN", "WORD"}) {
+    auto start = std::chrono::steady_clock::now();
+    std::string image =
+        write_image(fields, total_bits, format, "bitstream_writer.bin");
+    auto middle = std::chrono::steady_clock::now();
+    std::string expected = reference(fields, total_bits, format);
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_EQ(image.size(), expected.size());
+    double writer_s = std::chrono::duration<double>(middle - start).count();
+    double reference_s = std::chrono::duration<double>(end - middle).count();
+    printf("%s: %u Mbit in %.3f s (%.0f Mbit/s), reference %.3f s\n",
+           format.c_str(), total_bits >> 20, writer_s,
+           (total_bits >> 20) / writer_s, reference_s);
+  }
+}
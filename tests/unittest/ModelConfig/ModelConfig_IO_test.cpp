@@ -107,6 +107,23 @@ TEST_F(ModelConfig_IO, allocate_resources) {
   }
 }
 
+TEST_F(ModelConfig_IO, solve_resources) {
+  // First found resource of instance 0 would leave instance 1 nothing
+  std::vector<int32_t> decisions;
+  EXPECT_EQ(FOEDAG::ModelConfig_IO::solve_resource({3, 1}, 3, decisions), 2);
+  EXPECT_EQ(decisions, std::vector<int32_t>({1, 0}));
+  // Only two out of three can be placed, the first in search order wins
+  EXPECT_EQ(FOEDAG::ModelConfig_IO::solve_resource({1, 1, 3}, 3, decisions),
+            2);
+  EXPECT_EQ(decisions, std::vector<int32_t>({0, -1, 1}));
+  // Resource that is not available cannot be used
+  EXPECT_EQ(FOEDAG::ModelConfig_IO::solve_resource({6, 4, 2}, 6, decisions),
+            2);
+  EXPECT_EQ(decisions, std::vector<int32_t>({1, 2, -1}));
+  EXPECT_EQ(FOEDAG::ModelConfig_IO::solve_resource({}, 3, decisions), 0);
+  EXPECT_EQ(decisions.size(), 0);
+}
+
 TEST_F(ModelConfig_IO, set_property) {
   compiler_tcl_common_run("clear_property");
   compiler_tcl_common_run(
@@ -19,6 +19,12 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <fstream>
+#include <regex>
+
+#include "Configuration/ModelConfig/ModelConfig.h"
+#include "DeviceModeling/Model.h"
+#include "DeviceModeling/device_address_index.h"
 #include "compiler_tcl_infra_common.h"
 
 class ModelConfig : public ::testing::Test {
@@ -127,6 +133,18 @@ TEST_F(ModelConfig, model_config) {
   compiler_tcl_common_run(
       "model_config write -format BIN model_config_bin.bin");
   compiler_tcl_common_run("model_config dump_ric TOP model_config_top_ric.txt");
+  // Second feature, every feature gets its own image from write_all
+  compiler_tcl_common_run("model_config set_model -feature CORE TOP");
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB2_C -name ATTR3 -value 0x1A5");
+  compiler_tcl_common_run(
+      "model_config write -format BIT model_config_core_bit.txt");
+  compiler_tcl_common_run(
+      "model_config write -format BIN model_config_core_bin.bin");
+  compiler_tcl_common_run(
+      "model_config write_all -format BIT model_config_all_bit.txt");
+  compiler_tcl_common_run(
+      "model_config write_all -format BIN model_config_all_bin.bin");
 }
 
 TEST_F(ModelConfig, compare_result) {
@@ -143,5 +161,159 @@ TEST_F(ModelConfig, compare_result) {
                         golden_dir);
   compare_unittest_file(false, "model_config_top_ric.txt", "ModelConfig",
                         golden_dir);
+  // Each feature image of write_all matches the plain write of the feature
+  EXPECT_TRUE(CFG_compare_two_text_files("model_config_all_bit.IO.txt",
+                                         "model_config_bit.txt"));
+  EXPECT_TRUE(CFG_compare_two_binary_files("model_config_all_bin.IO.bin",
+                                           "model_config_bin.bin"));
+  EXPECT_TRUE(CFG_compare_two_text_files("model_config_all_bit.CORE.txt",
+                                         "model_config_core_bit.txt"));
+  EXPECT_TRUE(CFG_compare_two_binary_files("model_config_all_bin.CORE.bin",
+                                           "model_config_core_bin.bin"));
+  EXPECT_FALSE(std::filesystem::exists("model_config_all_bit.txt"));
   // CFG_INTERNAL_ERROR("stop");
 }
+
+TEST_F(ModelConfig, model_config_incremental) {
+  std::string current_dir = COMPILER_TCL_COMMON_GET_CURRENT_DIR();
+  std::string golden_dir = COMPILER_TCL_COMMON_GET_CURRENT_GOLDEN_DIR();
+  std::string design = CFG_print("%s/model_config_design.json",
+                                 current_dir.c_str());
+  std::string eco = CFG_print("%s/model_config_design_eco.json",
+                              current_dir.c_str());
+  std::string api = CFG_print("model_config set_api %s/model_config.json",
+                              current_dir.c_str());
+  // Base image, then only the changed design input is applied again
+  compiler_tcl_common_run("model_config set_model -feature ECO TOP");
+  compiler_tcl_common_run(api);
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB1_B -name ATTR2 -value 17");
+  compiler_tcl_common_run(CFG_print(
+      "model_config set_design -source design %s", design.c_str()));
+  compiler_tcl_common_run(
+      "model_config set_attr -source script -instance SUB2_A -name ATTR3 "
+      "-value 0x155");
+  compiler_tcl_common_run(
+      "model_config write -format BIN model_config_eco_base.bin");
+  compiler_tcl_common_run(CFG_print(
+      "model_config set_design -incremental -source design %s", eco.c_str()));
+  compiler_tcl_common_run("model_config clear_source script");
+  compiler_tcl_common_run(
+      "model_config set_attr -source script -instance SUB2_B -name ATTR3 "
+      "-value 0x23");
+  compiler_tcl_common_run(
+      "model_config write -delta -format TCL model_config_eco_delta_tcl.txt");
+  compiler_tcl_common_run(
+      "model_config write -format BIN model_config_eco_bin.bin");
+  // Same inputs regenerated from scratch
+  compiler_tcl_common_run("model_config set_model -feature ECO_REF TOP");
+  compiler_tcl_common_run(api);
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB1_B -name ATTR2 -value 17");
+  compiler_tcl_common_run(CFG_print("model_config set_design %s", eco.c_str()));
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB2_B -name ATTR3 -value 0x23");
+  compiler_tcl_common_run(
+      "model_config write -format BIN model_config_eco_ref_bin.bin");
+  compiler_tcl_common_run(
+      "model_config diff -feature ECO -format BIN model_config_eco_base.bin "
+      "model_config_eco_bin.bin model_config_eco_diff.txt");
+  compare_unittest_file(false, "model_config_eco_delta_tcl.txt", "ModelConfig",
+                        golden_dir);
+  compare_unittest_file(false, "model_config_eco_diff.txt", "ModelConfig",
+                        golden_dir);
+  EXPECT_TRUE(CFG_compare_two_binary_files("model_config_eco_bin.bin",
+                                           "model_config_eco_ref_bin.bin"));
+  EXPECT_FALSE(CFG_compare_two_binary_files("model_config_eco_bin.bin",
+                                            "model_config_eco_base.bin"));
+  // The library call writes the same report as the Tcl command
+  EXPECT_EQ(FOEDAG::model_config_diff("ECO", "TOP", "BIN",
+                                      "model_config_eco_base.bin",
+                                      "model_config_eco_bin.bin",
+                                      "model_config_eco_diff_api.txt"),
+            6);
+  EXPECT_TRUE(CFG_compare_two_binary_files("model_config_eco_diff_api.txt",
+                                           "model_config_eco_diff.txt"));
+}
+
+TEST_F(ModelConfig, model_config_implicit_source) {
+  // Commands without a source still apply in command order around the
+  // commands of a named source
+  compiler_tcl_common_run("model_config set_model -feature IMPLICIT TOP");
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB1_B -name ATTR2 -value 1");
+  compiler_tcl_common_run(
+      "model_config set_attr -source script -instance SUB1_B -name ATTR2 "
+      "-value 2");
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB1_B -name ATTR2 -value 3");
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB2_B -name ATTR3 -value 5");
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB2_B -name ATTR3 -value 6");
+  compiler_tcl_common_run(
+      "model_config write -format BIN model_config_implicit_bin.bin");
+  compiler_tcl_common_run("model_config set_model -feature IMPLICIT_REF TOP");
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB1_B -name ATTR2 -value 3");
+  compiler_tcl_common_run(
+      "model_config set_attr -instance SUB2_B -name ATTR3 -value 6");
+  compiler_tcl_common_run(
+      "model_config write -format BIN model_config_implicit_ref_bin.bin");
+  EXPECT_TRUE(CFG_compare_two_binary_files(
+      "model_config_implicit_bin.bin", "model_config_implicit_ref_bin.bin"));
+}
+
+TEST_F(ModelConfig, address_index_layout) {
+  // The address index must place every attribute where the configuration
+  // model writes it, skipping no_configuration blocks and keeping instances
+  // without a logic address
+  compiler_tcl_common_run("device_name LAYOUT");
+  compiler_tcl_common_run("define_block -name L1");
+  compiler_tcl_common_run("define_attr -block L1 -name A -addr 0 -width 4");
+  compiler_tcl_common_run("define_attr -block L1 -name B -addr 4 -width 4");
+  compiler_tcl_common_run("define_block -name NOCFG");
+  compiler_tcl_common_run("define_attr -block NOCFG -name X -addr 0 -width 4");
+  compiler_tcl_common_run(
+      "define_properties -block NOCFG -no_configuration 1");
+  compiler_tcl_common_run("define_block -name WRAPB");
+  compiler_tcl_common_run("create_instance -block L1 -name inner -parent WRAPB");
+  compiler_tcl_common_run("define_block -name LAYOUT");
+  compiler_tcl_common_run(
+      "create_instance -block L1 -name first -logic_address 0 -parent LAYOUT");
+  compiler_tcl_common_run(
+      "create_instance -block NOCFG -name analog -logic_address 8 -parent "
+      "LAYOUT");
+  compiler_tcl_common_run(
+      "create_instance -block WRAPB -name wrap -logic_address 9 -parent "
+      "LAYOUT");
+  compiler_tcl_common_run("model_config set_model -feature LAYOUT LAYOUT");
+  compiler_tcl_common_run(
+      "model_config write -format DETAIL model_config_layout.txt");
+  device_address_index index{*Model::get_modler().get_device_model("LAYOUT"),
+                             "LAYOUT"};
+  const std::regex block_re("^Block (\\S+) \\[");
+  const std::regex attr_re(
+      "^ +(\\S+) - Addr: 0x([0-9A-F]+), Size: +([0-9]+),");
+  std::ifstream file("model_config_layout.txt");
+  std::string line;
+  std::string block;
+  size_t count = 0;
+  while (std::getline(file, line)) {
+    std::smatch match;
+    if (std::regex_search(line, match, block_re)) {
+      block = match[1];
+    } else if (std::regex_search(line, match, attr_re)) {
+      const device_address_entry* entry =
+          index.find_attribute(block, match[1]);
+      ASSERT_NE(entry, nullptr) << block << "." << match[1];
+      EXPECT_EQ(entry->logic_address,
+                (uint32_t)std::stoul(match[2], nullptr, 16));
+      EXPECT_EQ(entry->size, (uint32_t)std::stoul(match[3]));
+      count++;
+    }
+  }
+  EXPECT_EQ(count, 4);
+  EXPECT_EQ(index.entries().size(), count);
+  compiler_tcl_common_run("device_name TOP");
+}
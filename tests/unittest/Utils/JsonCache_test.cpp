@@ -0,0 +1,110 @@
+/*
+Copyright 2024 The Foedag team
+
+GPL License
+
+Copyright (c) 2024 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Utils/JsonCache.h"
+
+#include <thread>
+#include <vector>
+
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+using namespace FOEDAG;
+
+TEST(JsonCache, CreateAndReuseSidecar) {
+  fs::path file{"json_cache_test.json"};
+  fs::remove(JsonCache::SidecarPath(file));
+  FileUtils::WriteToFile(file, R"({"b": 1, "a": [1, 2, 3]})");
+
+  nlohmann::ordered_json json;
+  ASSERT_TRUE(JsonCache::Load(file, json));
+  EXPECT_TRUE(fs::exists(JsonCache::SidecarPath(file)));
+  EXPECT_EQ(json.begin().key(), "b");
+
+  nlohmann::ordered_json cached;
+  ASSERT_TRUE(JsonCache::Load(file, cached));
+  EXPECT_EQ(json, cached);
+  EXPECT_EQ(cached.begin().key(), "b");
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(JsonCache, SourceChanged) {
+  fs::path file{"json_cache_changed.json"};
+  FileUtils::WriteToFile(file, R"({"value": 1})");
+  nlohmann::json json;
+  ASSERT_TRUE(JsonCache::Load(file, json));
+  EXPECT_EQ(json["value"], 1);
+
+  FileUtils::WriteToFile(file, R"({"value": 2})");
+  ASSERT_TRUE(JsonCache::Load(file, json));
+  EXPECT_EQ(json["value"], 2);
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(JsonCache, CorruptedSidecar) {
+  fs::path file{"json_cache_corrupted.json"};
+  FileUtils::WriteToFile(file, R"({"value": 3})");
+  FileUtils::WriteToFile(JsonCache::SidecarPath(file), "garbage", false);
+  nlohmann::json json;
+  ASSERT_TRUE(JsonCache::Load(file, json));
+  EXPECT_EQ(json["value"], 3);
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(JsonCache, ConcurrentRefresh) {
+  fs::path file{"json_cache_concurrent.json"};
+  fs::remove(JsonCache::SidecarPath(file));
+  FileUtils::WriteToFile(file, R"({"value": [1, 2, 3, 4, 5, 6, 7, 8]})");
+  EXPECT_NE(JsonCache::TempPath(file), JsonCache::TempPath(file));
+
+  std::vector<std::thread> threads;
+  std::vector<nlohmann::json> results(8);
+  for (auto& result : results)
+    threads.emplace_back([&file, &result]() { JsonCache::Load(file, result); });
+  for (auto& thread : threads) thread.join();
+  for (const auto& result : results) EXPECT_EQ(result["value"].size(), 8);
+
+  // the sidecar is valid and no temporary file is left behind
+  nlohmann::json cached;
+  ASSERT_TRUE(JsonCache::Load(file, cached));
+  EXPECT_EQ(cached, results.front());
+  for (const auto& entry : fs::directory_iterator{fs::current_path()}) {
+    const std::string name = entry.path().filename().string();
+    EXPECT_FALSE(name.rfind("json_cache_concurrent.json.cbor.", 0) == 0)
+        << name;
+  }
+  fs::remove(file);
+  fs::remove(JsonCache::SidecarPath(file));
+}
+
+TEST(JsonCache, Errors) {
+  nlohmann::json json;
+  EXPECT_FALSE(JsonCache::Load("json_cache_missing.json", json));
+
+  fs::path file{"json_cache_invalid.json"};
+  FileUtils::WriteToFile(file, "{");
+  EXPECT_THROW(JsonCache::Load(file, json), nlohmann::json::parse_error);
+  fs::remove(file);
+}